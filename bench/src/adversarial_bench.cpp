@@ -0,0 +1,107 @@
+#include "blang/error/error_reporter.hpp"
+#include "blang/scanner.hpp"
+#include "blang/source_buffer.hpp"
+
+#include <array>
+#include <benchmark/benchmark.h>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// Pathological inputs: every one must lex in time linear in its size. Each
+// benchmark fails when its throughput drops under ADVERSARIAL_FLOOR_MB_S,
+// which any quadratic path on inputs this large falls far short of.
+
+namespace {
+
+constexpr std::size_t ADVERSARIAL_BYTES = std::size_t{ 4 } << 20U;
+constexpr double ADVERSARIAL_FLOOR_MB_S = 10.0;
+
+enum class Shape : std::uint8_t {
+  huge_comment,
+  starry_comment,
+  unterminated_comment,
+  unterminated_string,
+  line_comment_at_eof,
+  operator_run,
+  half_operator_run,
+  char_quote_run,
+  slash_run,
+  escaped_string,
+  unterminated_escaped_string,
+};
+
+constexpr std::array<std::string_view, 11> SHAPE_NAMES{ "huge_comment",
+  "starry_comment",
+  "unterminated_comment",
+  "unterminated_string",
+  "line_comment_at_eof",
+  "operator_run",
+  "half_operator_run",
+  "char_quote_run",
+  "slash_run",
+  "escaped_string",
+  "unterminated_escaped_string" };
+
+std::string repeat(std::string_view unit, std::size_t bytes)
+{
+  std::string text{};
+  text.reserve(bytes + unit.size());
+  while (text.size() < bytes) { text += unit; }
+  return text;
+}
+
+std::string adversarial_source(Shape shape)
+{
+  switch (shape) {
+  case Shape::huge_comment:
+    return "/*" + repeat("comment body with / and * ", ADVERSARIAL_BYTES) + "*/";
+  case Shape::starry_comment:
+    return "/*" + repeat("*", ADVERSARIAL_BYTES) + "*/";
+  case Shape::unterminated_comment:
+    return "/*" + repeat("* / ", ADVERSARIAL_BYTES);
+  case Shape::unterminated_string:
+    return "x = \"" + repeat("never closed\n", ADVERSARIAL_BYTES);
+  case Shape::line_comment_at_eof:
+    return "//" + repeat("no newline ", ADVERSARIAL_BYTES);
+  case Shape::operator_run:
+    return repeat("==!=<=>=++--&&||", ADVERSARIAL_BYTES);
+  case Shape::half_operator_run:
+    return repeat("=!<>+-&|", ADVERSARIAL_BYTES);
+  case Shape::char_quote_run:
+    return repeat("'a'", ADVERSARIAL_BYTES);
+  case Shape::slash_run:
+    return repeat("/ ", ADVERSARIAL_BYTES);
+  case Shape::escaped_string:
+    return "x = \"" + repeat("\\n\\t\\\"\\\\a", ADVERSARIAL_BYTES) + "\";";
+  case Shape::unterminated_escaped_string:
+    return "x = \"" + repeat("\\n\\t\\\"\\\\a", ADVERSARIAL_BYTES);
+  }
+  return {};
+}
+
+void BM_Adversarial(benchmark::State &state)
+{
+  const auto shape{ static_cast<Shape>(state.range(0)) };
+  const std::string source{ adversarial_source(shape) };
+
+  std::chrono::duration<double> elapsed{};
+  for (auto _ : state) {
+    const auto start{ std::chrono::steady_clock::now() };
+    blang::error::ErrorReporter reporter{};
+    blang::Scanner scanner{ blang::SourceBuffer::borrow(source), reporter };
+    benchmark::DoNotOptimize(scanner.scan());
+    elapsed += std::chrono::steady_clock::now() - start;
+  }
+
+  state.SetLabel(std::string{ SHAPE_NAMES.at(static_cast<std::size_t>(shape)) });
+  state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(source.size()));
+  const double mb_per_second{ static_cast<double>(source.size()) * static_cast<double>(state.iterations())
+                              / elapsed.count() / (1024.0 * 1024.0) };// NOLINT
+  if (mb_per_second < ADVERSARIAL_FLOOR_MB_S) { state.SkipWithError("throughput under the adversarial floor"); }
+}
+
+}// namespace
+
+BENCHMARK(BM_Adversarial)->DenseRange(0, static_cast<int>(SHAPE_NAMES.size()) - 1)->Unit(benchmark::kMillisecond);
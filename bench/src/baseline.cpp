@@ -0,0 +1,87 @@
+#include "baseline.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <string_view>
+
+namespace blang::bench {
+
+void RecordingReporter::ReportRuns(const std::vector<Run> &reports)
+{
+  for (const Run &run : reports) {
+    const bool median{ run.run_type == Run::RT_Aggregate && run.aggregate_name == "median" };
+    if (run.error_occurred || (run.run_type != Run::RT_Iteration && !median)) { continue; }
+
+    std::string name{ run.run_name.str() };
+    const double nanoseconds{ run.GetAdjustedRealTime() * 1e9 / benchmark::GetTimeUnitMultiplier(run.time_unit) };
+    if (median) {
+      m_results[name] = nanoseconds;
+    } else {
+      m_results.try_emplace(std::move(name), nanoseconds);
+    }
+  }
+  ConsoleReporter::ReportRuns(reports);
+}
+
+bool save_baseline(const std::filesystem::path &path, const Baseline &results)
+{
+  std::ofstream file{ path };
+  if (!file) { return false; }
+
+  file << "{\"benchmarks\": [\n";
+  std::string_view separator{};
+  for (const auto &[name, nanoseconds] : results) {
+    file << separator << "  {\"name\": \"" << name << "\", \"real_time_ns\": " << std::setprecision(12) << nanoseconds
+         << "}";
+    separator = ",\n";
+  }
+  file << "\n]}\n";
+  return static_cast<bool>(file);
+}
+
+std::optional<Baseline> load_baseline(const std::filesystem::path &path)
+{
+  std::ifstream file{ path };
+  if (!file) { return {}; }
+
+  // only the one-object-per-line layout written by save_baseline() is read
+  constexpr std::string_view NAME_KEY{ "\"name\": \"" };
+  constexpr std::string_view TIME_KEY{ "\"real_time_ns\": " };
+  Baseline baseline{};
+  for (std::string line{}; std::getline(file, line);) {
+    const std::size_t name_at{ line.find(NAME_KEY) };
+    const std::size_t time_at{ line.find(TIME_KEY) };
+    if (name_at == std::string::npos || time_at == std::string::npos) { continue; }
+
+    const std::size_t name_begin{ name_at + NAME_KEY.size() };
+    const std::size_t name_end{ line.find('"', name_begin) };
+    if (name_end == std::string::npos) { return {}; }
+    try {
+      baseline[line.substr(name_begin, name_end - name_begin)] = std::stod(line.substr(time_at + TIME_KEY.size()));
+    } catch (const std::exception &) {
+      return {};
+    }
+  }
+  return baseline;
+}
+
+std::size_t compare_baseline(const Baseline &baseline, const Baseline &current, double tolerance, std::ostream &out)
+{
+  std::size_t regressions{ 0 };
+  out << "\nComparison against baseline (tolerance " << tolerance * 100.0 << "%):\n";// NOLINT
+  for (const auto &[name, nanoseconds] : current) {
+    auto found{ baseline.find(name) };
+    if (found == baseline.end() || found->second <= 0.0) { continue; }
+
+    const double change{ nanoseconds / found->second - 1.0 };
+    const bool regressed{ change > tolerance };
+    regressions += regressed ? 1 : 0;
+    out << (regressed ? "  REGRESSION " : "             ") << std::left << std::setw(48) << name// NOLINT
+        << std::right << std::showpos << std::fixed << std::setprecision(1) << change * 100.0 << "%"// NOLINT
+        << std::noshowpos << std::defaultfloat << '\n';
+  }
+  return regressions;
+}
+
+}// namespace blang::bench
@@ -0,0 +1,44 @@
+#ifndef BLANG_BENCH_BASELINE_HPP
+#define BLANG_BENCH_BASELINE_HPP
+
+#include <benchmark/benchmark.h>
+#include <filesystem>
+#include <map>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace blang::bench {
+
+// Real time per iteration of every benchmark in a run, keyed by full name.
+using Baseline = std::map<std::string, double>;
+
+// Console reporter that also records each benchmark's real time per
+// iteration (the median when repetitions are used) in nanoseconds.
+class RecordingReporter : public benchmark::ConsoleReporter
+{
+public:
+  using ConsoleReporter::ConsoleReporter;
+  void ReportRuns(const std::vector<Run> &reports) override;
+  [[nodiscard]] const Baseline &results() const { return m_results; }
+
+private:
+  Baseline m_results;
+};
+
+// Baselines are stored as JSON, one benchmark object per line:
+// {"benchmarks": [
+//   {"name": "BM_ScanTokens/kind:0/bytes:4194304", "real_time_ns": 31415926.5},
+//   ...
+// ]}
+bool save_baseline(const std::filesystem::path &path, const Baseline &results);
+std::optional<Baseline> load_baseline(const std::filesystem::path &path);
+
+// Prints every benchmark present in both runs with its change in time, and
+// returns the number that got slower by more than `tolerance` (0.1 is 10%).
+std::size_t compare_baseline(const Baseline &baseline, const Baseline &current, double tolerance, std::ostream &out);
+
+}// namespace blang::bench
+
+#endif
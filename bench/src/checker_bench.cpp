@@ -0,0 +1,84 @@
+#include "blang/error/error_reporter.hpp"
+#include "blang/interner.hpp"
+#include "blang/parser.hpp"
+#include "blang/scanner.hpp"
+#include "blang/sema/type_checker.hpp"
+#include "blang/sema/types.hpp"
+#include "blang/source_buffer.hpp"
+#include "blang/token_stream.hpp"
+#include "blang/util/thread_pool.hpp"
+#include "corpus.hpp"
+
+#include <algorithm>
+#include <benchmark/benchmark.h>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Name resolution and type checking alone, over a generated program that
+// checks cleanly and was scanned and parsed once up front. The benchmark fails
+// when it checks fewer than CHECK_FLOOR_LINES_S lines a second, which a
+// checker that copies a map per scope or compares types structurally falls
+// short of. BM_TypeCheckParallel checks the same program with its function
+// bodies fanned out to a pool of `threads` workers; its lines/s against the
+// one-thread run is the speedup, bounded by the cores the machine has.
+
+namespace {
+
+constexpr double CHECK_FLOOR_LINES_S = 1e6;
+
+void run_check(benchmark::State &state, blang::util::ThreadPool *pool)
+{
+  const std::string source{ blang::bench::generate_typed_program(static_cast<std::size_t>(state.range(0))) };
+  const std::int64_t lines{ std::count(source.begin(), source.end(), '\n') };
+  blang::Interner interner{};
+  blang::error::ErrorReporter parse_reporter{ 0 };
+  blang::Scanner scanner{ blang::SourceBuffer::borrow(source), parse_reporter, &interner };
+  const blang::TokenStream tokens{ scanner.scan() };
+  const blang::Ast ast{ blang::Parser{ tokens, parse_reporter }.parse_program() };
+  if (parse_reporter.get_status() != blang::error::Status::OK) {
+    state.SkipWithError("typed corpus did not parse cleanly");
+    return;
+  }
+
+  std::size_t types{ 0 };
+  std::chrono::duration<double> elapsed{};
+  for (auto _ : state) {
+    const auto start{ std::chrono::steady_clock::now() };
+    blang::error::ErrorReporter reporter{ 0 };
+    blang::sema::TypeTable table{};
+    blang::sema::TypeChecker checker{ tokens, ast, table, interner, reporter };
+    const bool clean{ pool == nullptr ? checker.check() : checker.check(*pool) };
+    elapsed += std::chrono::steady_clock::now() - start;
+    if (!clean) {
+      state.SkipWithError(("typed corpus did not check cleanly: " + reporter.get_errors().front()).c_str());
+      return;
+    }
+    types = table.size();
+  }
+
+  const double lines_per_second{ static_cast<double>(lines * state.iterations()) / elapsed.count() };
+  state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(source.size()));
+  state.counters["lines/s"] = lines_per_second;
+  state.counters["types"] = static_cast<double>(types);
+  if (lines_per_second < CHECK_FLOOR_LINES_S) { state.SkipWithError("throughput under the check floor"); }
+}
+
+void BM_TypeCheck(benchmark::State &state) { run_check(state, nullptr); }
+
+void BM_TypeCheckParallel(benchmark::State &state)
+{
+  blang::util::ThreadPool pool{ static_cast<std::size_t>(state.range(1)) };
+  run_check(state, &pool);
+  state.counters["steals"] = static_cast<double>(pool.steals()) / static_cast<double>(state.iterations());
+}
+
+}// namespace
+
+BENCHMARK(BM_TypeCheck)->ArgName("bytes")->Arg(std::int64_t{ 4 } << 20U)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_TypeCheckParallel)
+  ->ArgNames({ "bytes", "threads" })
+  ->ArgsProduct({ { std::int64_t{ 4 } << 20U }, { 1, 2, 4, 8 } })// NOLINT
+  ->UseRealTime()
+  ->Unit(benchmark::kMillisecond);
@@ -0,0 +1,576 @@
+#include "corpus.hpp"
+
+#include <array>
+#include <map>
+#include <mutex>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace blang::bench {
+
+namespace {
+
+  constexpr std::array<std::string_view, 16> NAMES{ "count",
+    "total",
+    "index",
+    "value",
+    "size",
+    "result",
+    "left",
+    "right",
+    "buffer",
+    "limit",
+    "offset",
+    "item",
+    "score",
+    "width",
+    "height",
+    "name" };
+
+  constexpr std::array<std::string_view, 12> WORDS{
+    "the", "value", "of", "each", "entry", "is", "added", "to", "running", "total", "before", "printing"
+  };
+
+  enum class Item : std::uint8_t { declaration, array, function, comment, string };
+
+  // Relative weight of each item per corpus kind, indexed by Item.
+  constexpr std::array<std::array<unsigned, 5>, CORPUS_KIND_COUNT> ITEM_WEIGHTS{ {
+    { 4, 2, 3, 2, 1 },// balanced
+    { 12, 6, 1, 1, 1 },// declarations
+    { 1, 1, 12, 1, 1 },// functions
+    { 2, 1, 2, 10, 1 },// comments
+    { 2, 1, 2, 1, 10 },// strings
+  } };
+
+  class Generator
+  {
+  public:
+    explicit Generator(const CorpusOptions &options)
+      : m_rng(options.seed), m_items(ITEM_WEIGHTS.at(static_cast<std::size_t>(options.kind)).begin(),
+                               ITEM_WEIGHTS.at(static_cast<std::size_t>(options.kind)).end())
+    {}
+
+    std::string run(std::size_t bytes)
+    {
+      m_out.reserve(bytes + 1024);// NOLINT
+      while (m_out.size() < bytes) {
+        switch (static_cast<Item>(m_items(m_rng))) {
+        case Item::declaration:
+          declaration();
+          break;
+        case Item::array:
+          array();
+          break;
+        case Item::function:
+          function();
+          break;
+        case Item::comment:
+          comment();
+          break;
+        case Item::string:
+          string_item();
+          break;
+        }
+        m_out += '\n';
+      }
+      return std::move(m_out);
+    }
+
+    // A single expression, or a condition joined by && and ||.
+    std::string standalone_expression()
+    {
+      m_out.clear();
+      if (chance(50)) {// NOLINT
+        expression(1);
+      } else {
+        condition();
+      }
+      return std::move(m_out);
+    }
+
+  private:
+    std::size_t pick(std::size_t count) { return std::uniform_int_distribution<std::size_t>{ 0, count - 1 }(m_rng); }
+    bool chance(unsigned percent) { return pick(100) < percent; }// NOLINT
+
+    void indent(int depth) { m_out.append(static_cast<std::size_t>(depth) * 4, ' '); }
+
+    void name()
+    {
+      m_out += NAMES.at(pick(NAMES.size()));
+      if (chance(60)) { m_out += std::to_string(pick(100)); }// NOLINT
+    }
+
+    void number() { m_out += std::to_string(pick(chance(80) ? 100 : 1000000)); }// NOLINT
+
+    void text(std::size_t words)
+    {
+      for (std::size_t i = 0; i < words; ++i) {
+        if (i > 0) { m_out += ' '; }
+        m_out += WORDS.at(pick(WORDS.size()));
+      }
+    }
+
+    void string_lit(std::size_t words)
+    {
+      m_out += '"';
+      text(words);
+      if (chance(30)) { m_out += "\\n"; }// NOLINT
+      m_out += '"';
+    }
+
+    void expression(int depth)
+    {
+      switch (pick(depth > 1 ? 3 : 6)) {// NOLINT
+      case 0:
+        number();
+        break;
+      case 1:
+        name();
+        break;
+      case 2:
+        name();
+        m_out += '[';
+        number();
+        m_out += ']';
+        break;
+      case 3:
+        m_out += "( ";
+        expression(depth + 1);
+        m_out += " )";
+        break;
+      case 4:
+        name();
+        m_out += "( ";
+        expression(depth + 1);
+        m_out += ", ";
+        expression(depth + 1);
+        m_out += " )";
+        break;
+      default:
+        expression(depth + 1);
+        static constexpr std::array<std::string_view, 8> OPERATORS{
+          " + ", " - ", " * ", " / ", " % ", " ^ ", " + ", " * "
+        };
+        m_out += OPERATORS.at(pick(OPERATORS.size()));
+        expression(depth + 1);
+        break;
+      }
+    }
+
+    void condition()
+    {
+      static constexpr std::array<std::string_view, 6> COMPARISONS{ " < ", " <= ", " > ", " >= ", " == ", " != " };
+      name();
+      m_out += COMPARISONS.at(pick(COMPARISONS.size()));
+      expression(1);
+      if (chance(30)) {// NOLINT
+        m_out += chance(50) ? " && " : " || ";// NOLINT
+        name();
+        m_out += COMPARISONS.at(pick(COMPARISONS.size()));
+        number();
+      }
+    }
+
+    void declaration()
+    {
+      name();
+      switch (pick(5)) {// NOLINT
+      case 0:
+        m_out += ": integer = ";
+        expression(1);
+        break;
+      case 1:
+        m_out += ": boolean = ";
+        m_out += chance(50) ? "true" : "false";// NOLINT
+        break;
+      case 2:
+        m_out += ": char = '";
+        m_out += static_cast<char>('a' + pick(26));// NOLINT
+        m_out += '\'';
+        break;
+      case 3:
+        m_out += ": string = ";
+        string_lit(1 + pick(4));// NOLINT
+        break;
+      default:
+        m_out += ": integer";
+        break;
+      }
+      m_out += ";\n";
+    }
+
+    void array()
+    {
+      const std::size_t count{ 2 + pick(12) };// NOLINT
+      name();
+      m_out += ": array [" + std::to_string(count) + "] integer = { ";
+      for (std::size_t i = 0; i < count; ++i) {
+        if (i > 0) { m_out += ", "; }
+        number();
+      }
+      m_out += " };\n";
+    }
+
+    void statement(int depth)
+    {
+      indent(depth);
+      switch (pick(depth > 2 ? 4 : 8)) {// NOLINT
+      case 0:
+        name();
+        m_out += " = ";
+        expression(1);
+        m_out += ";\n";
+        break;
+      case 1:
+        name();
+        m_out += chance(50) ? "++;\n" : "--;\n";// NOLINT
+        break;
+      case 2:
+        m_out += "print ";
+        string_lit(1 + pick(3));// NOLINT
+        m_out += ", ";
+        name();
+        m_out += ";\n";
+        break;
+      case 3:
+        m_out += "return ";
+        expression(1);
+        m_out += ";\n";
+        break;
+      case 4:
+        m_out += "if ( ";
+        condition();
+        m_out += " ) ";
+        block(depth);
+        if (chance(40)) {// NOLINT
+          m_out.back() = ' ';
+          m_out += "else ";
+          block(depth);
+        }
+        break;
+      case 5:
+        m_out += "for ( ";
+        name();
+        m_out += " = 0; ";
+        condition();
+        m_out += "; ";
+        name();
+        m_out += "++ ) ";
+        block(depth);
+        break;
+      case 6:
+        m_out += "while ( ";
+        condition();
+        m_out += " ) ";
+        block(depth);
+        break;
+      default:
+        name();
+        m_out += ": integer = ";
+        expression(1);
+        m_out += ";\n";
+        break;
+      }
+    }
+
+    void block(int depth)
+    {
+      m_out += "{\n";
+      const std::size_t count{ 1 + pick(4) };// NOLINT
+      for (std::size_t i = 0; i < count; ++i) { statement(depth + 1); }
+      indent(depth);
+      m_out += "}\n";
+    }
+
+    void function()
+    {
+      static constexpr std::array<std::string_view, 4> RETURNS{ "integer", "void", "boolean", "char" };
+      name();
+      m_out += ": function ";
+      m_out += RETURNS.at(pick(RETURNS.size()));
+      m_out += " ( ";
+      const std::size_t params{ pick(4) };
+      for (std::size_t i = 0; i < params; ++i) {
+        if (i > 0) { m_out += ", "; }
+        name();
+        m_out += chance(25) ? ": array [] integer" : ": integer";// NOLINT
+      }
+      m_out += " ) = ";
+      block(0);
+    }
+
+    void comment()
+    {
+      if (chance(50)) {// NOLINT
+        m_out += "/*\n";
+        const std::size_t lines{ 1 + pick(6) };// NOLINT
+        for (std::size_t i = 0; i < lines; ++i) {
+          m_out += " * ";
+          text(4 + pick(8));// NOLINT
+          m_out += '\n';
+        }
+        m_out += " */\n";
+      } else {
+        const std::size_t lines{ 1 + pick(3) };// NOLINT
+        for (std::size_t i = 0; i < lines; ++i) {
+          m_out += "// ";
+          text(3 + pick(8));// NOLINT
+          m_out += '\n';
+        }
+      }
+    }
+
+    void string_item()
+    {
+      if (chance(50)) {// NOLINT
+        name();
+        m_out += ": string = ";
+        string_lit(4 + pick(16));// NOLINT
+        m_out += ";\n";
+      } else {
+        m_out += "print ";
+        string_lit(2 + pick(10));// NOLINT
+        m_out += ", ";
+        string_lit(1 + pick(4));// NOLINT
+        m_out += ";\n";
+      }
+    }
+
+    std::mt19937_64 m_rng;
+    std::discrete_distribution<std::size_t> m_items;
+    std::string m_out;
+  };
+
+  // Generator of well-typed programs. Only integer variables are assigned and
+  // every name used is one in scope, tracked as the program is written. The
+  // constants k0..k3 are read but never assigned, so they fold.
+  class TypedGenerator
+  {
+  public:
+    explicit TypedGenerator(std::uint64_t seed) : m_rng(seed) {}
+
+    std::string run(std::size_t bytes)
+    {
+      m_out.reserve(bytes + 1024);// NOLINT
+      for (std::size_t i = 0; i < GLOBALS; ++i) {
+        m_out += "g" + std::to_string(i) + ": integer = ";
+        number();
+        m_out += ";\n";
+        m_integers.push_back("g" + std::to_string(i));
+      }
+      for (std::size_t i = 0; i < CONSTANTS; ++i) {
+        m_out += "k" + std::to_string(i) + ": integer = ";
+        number();
+        m_out += ";\n";
+      }
+      m_out += "flag: boolean = true;\ntable: array [16] integer = { ";
+      for (std::size_t i = 0; i < 16; ++i) {// NOLINT
+        if (i > 0) { m_out += ", "; }
+        number();
+      }
+      m_out += " };\n\n";
+      while (m_out.size() < bytes) { function(); }
+      return std::move(m_out);
+    }
+
+  private:
+    static constexpr std::size_t GLOBALS = 16;
+    static constexpr std::size_t CONSTANTS = 4;
+
+    std::size_t pick(std::size_t count) { return std::uniform_int_distribution<std::size_t>{ 0, count - 1 }(m_rng); }
+    bool chance(unsigned percent) { return pick(100) < percent; }// NOLINT
+
+    void indent(int depth) { m_out.append(static_cast<std::size_t>(depth) * 4, ' '); }
+    void number() { m_out += std::to_string(pick(100)); }// NOLINT
+    void integer_name() { m_out += m_integers.at(pick(m_integers.size())); }
+
+    void expression(int depth)
+    {
+      switch (pick(depth > 1 ? 3 : 6)) {// NOLINT
+      case 0:
+        number();
+        break;
+      case 1:
+        if (chance(25)) {// NOLINT
+          m_out += "k" + std::to_string(pick(CONSTANTS));
+        } else {
+          integer_name();
+        }
+        break;
+      case 2:
+        m_out += chance(50) ? "table[" : "values[";// NOLINT
+        number();
+        m_out += " % 16]";
+        break;
+      case 3:
+        m_out += "(";
+        expression(depth + 1);
+        m_out += ")";
+        break;
+      case 4:
+        if (m_functions > 0) {
+          m_out += "f" + std::to_string(pick(m_functions)) + "(";
+          expression(depth + 1);
+          m_out += ", ";
+          expression(depth + 1);
+          m_out += ", table)";
+          break;
+        }
+        [[fallthrough]];
+      default:
+        expression(depth + 1);
+        static constexpr std::array<std::string_view, 6> OPERATORS{ " + ", " - ", " * ", " / ", " % ", " + " };
+        m_out += OPERATORS.at(pick(OPERATORS.size()));
+        expression(depth + 1);
+        break;
+      }
+    }
+
+    void condition()
+    {
+      static constexpr std::array<std::string_view, 6> COMPARISONS{ " < ", " <= ", " > ", " >= ", " == ", " != " };
+      integer_name();
+      m_out += COMPARISONS.at(pick(COMPARISONS.size()));
+      expression(1);
+      if (chance(30)) {// NOLINT
+        m_out += chance(50) ? " && " : " || ";// NOLINT
+        m_out += chance(50) ? "flag" : "!flag";// NOLINT
+      }
+    }
+
+    void statement(int depth)
+    {
+      indent(depth);
+      switch (pick(depth > 2 ? 4 : 7)) {// NOLINT
+      case 0:
+        integer_name();
+        m_out += " = ";
+        expression(1);
+        m_out += ";\n";
+        break;
+      case 1:
+        integer_name();
+        m_out += chance(50) ? "++;\n" : "--;\n";// NOLINT
+        break;
+      case 2:
+        m_out += "print \"value: \", ";
+        expression(1);
+        m_out += ";\n";
+        break;
+      case 3: {
+        const std::string local{ "l" + std::to_string(m_integers.size()) };
+        m_out += local + ": integer = ";
+        expression(1);
+        m_out += ";\n";
+        m_integers.push_back(local);
+        break;
+      }
+      case 4:
+        m_out += "if (";
+        condition();
+        m_out += ") ";
+        block(depth);
+        if (chance(40)) {// NOLINT
+          m_out.back() = ' ';
+          m_out += "else ";
+          block(depth);
+        }
+        break;
+      case 5:
+        m_out += "for (";
+        integer_name();
+        m_out += " = 0; ";
+        condition();
+        m_out += "; ";
+        integer_name();
+        m_out += "++) ";
+        block(depth);
+        break;
+      default:
+        m_out += "while (";
+        condition();
+        m_out += ") ";
+        block(depth);
+        break;
+      }
+    }
+
+    void block(int depth)
+    {
+      const std::size_t scope{ m_integers.size() };
+      m_out += "{\n";
+      const std::size_t count{ 1 + pick(4) };// NOLINT
+      for (std::size_t i = 0; i < count; ++i) { statement(depth + 1); }
+      indent(depth);
+      m_out += "}\n";
+      m_integers.resize(scope);
+    }
+
+    void function()
+    {
+      const std::size_t scope{ m_integers.size() };
+      m_out += "f" + std::to_string(m_functions);
+      m_out += ": function integer (a: integer, b: integer, values: array [] integer) = {\n";
+      m_integers.emplace_back("a");
+      m_integers.emplace_back("b");
+      const std::size_t count{ 2 + pick(6) };// NOLINT
+      for (std::size_t i = 0; i < count; ++i) { statement(1); }
+      m_out += "    return ";
+      expression(1);
+      m_out += ";\n}\n";
+      m_integers.resize(scope);
+      m_functions++;
+    }
+
+    std::mt19937_64 m_rng;
+    std::string m_out;
+    // integer variables in scope, innermost last
+    std::vector<std::string> m_integers;
+    std::size_t m_functions{ 0 };
+  };
+
+}// namespace
+
+std::string generate_corpus(const CorpusOptions &options) { return Generator{ options }.run(options.bytes); }
+
+const std::string &cached_corpus(CorpusKind kind, std::size_t bytes)
+{
+  static std::mutex mutex;
+  static std::map<std::pair<CorpusKind, std::size_t>, std::string> corpora;
+
+  std::lock_guard lock{ mutex };
+  auto [it, inserted] = corpora.try_emplace({ kind, bytes });
+  if (inserted) { it->second = generate_corpus(CorpusOptions{ CorpusOptions{}.seed, bytes, kind }); }
+  return it->second;
+}
+
+std::vector<std::string> generate_expressions(std::size_t count, std::uint64_t seed)
+{
+  Generator generator{ CorpusOptions{ seed, 0, CorpusKind::balanced } };
+  std::vector<std::string> expressions{};
+  expressions.reserve(count);
+  for (std::size_t i = 0; i < count; ++i) { expressions.push_back(generator.standalone_expression()); }
+  return expressions;
+}
+
+std::string generate_typed_program(std::size_t bytes, std::uint64_t seed) { return TypedGenerator{ seed }.run(bytes); }
+
+std::string_view corpus_kind_name(CorpusKind kind)
+{
+  switch (kind) {
+  case CorpusKind::balanced:
+    return "balanced";
+  case CorpusKind::declarations:
+    return "declarations";
+  case CorpusKind::functions:
+    return "functions";
+  case CorpusKind::comments:
+    return "comments";
+  case CorpusKind::strings:
+    return "strings";
+  }
+  return "unknown";
+}
+
+}// namespace blang::bench
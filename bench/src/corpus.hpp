@@ -0,0 +1,45 @@
+#ifndef BLANG_BENCH_CORPUS_HPP
+#define BLANG_BENCH_CORPUS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace blang::bench {
+
+// Shape of a generated program: which top-level items dominate it.
+enum class CorpusKind : std::uint8_t { balanced, declarations, functions, comments, strings };
+
+inline constexpr std::size_t CORPUS_KIND_COUNT = 5;
+
+struct CorpusOptions
+{
+  std::uint64_t seed{ 0x5eed };
+  std::size_t bytes{ std::size_t{ 1 } << 20U };
+  CorpusKind kind{ CorpusKind::balanced };
+};
+
+// Generates a B-minor program of about `options.bytes` bytes that the scanner
+// lexes without errors. The same options always give the same program.
+std::string generate_corpus(const CorpusOptions &options);
+
+// Corpus for benchmarks, generated with the default seed once per kind and
+// size and kept for the life of the process.
+const std::string &cached_corpus(CorpusKind kind, std::size_t bytes);
+
+// Standalone expressions with the operators, calls and subscripts of the
+// corpus, for benchmarking the expression parser.
+std::vector<std::string> generate_expressions(std::size_t count, std::uint64_t seed = CorpusOptions{}.seed);
+
+// Generates a program of about `bytes` bytes that also type-checks without
+// errors: global variables and constants, then functions over them, each calling the ones
+// before it. The same arguments always give the same program.
+std::string generate_typed_program(std::size_t bytes, std::uint64_t seed = CorpusOptions{}.seed);
+
+std::string_view corpus_kind_name(CorpusKind kind);
+
+}// namespace blang::bench
+
+#endif
@@ -0,0 +1,52 @@
+#include "blang/error/error_reporter.hpp"
+#include "blang/scanner.hpp"
+#include "blang/source_buffer.hpp"
+
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <string>
+
+// Error-heavy input, as broken student files and fuzz corpora are: every line
+// holds two unexpected characters. Scans it and renders every diagnostic,
+// with all errors kept and under the default cap.
+
+namespace {
+
+constexpr std::size_t ERROR_HEAVY_BYTES = std::size_t{ 1 } << 20U;
+
+std::string error_heavy_source()
+{
+  std::string text{};
+  text.reserve(ERROR_HEAVY_BYTES + 16);// NOLINT
+  while (text.size() < ERROR_HEAVY_BYTES) { text += "x $ y ? z;\n"; }
+  return text;
+}
+
+void BM_ErrorHeavy(benchmark::State &state)
+{
+  static const std::string source{ error_heavy_source() };
+  const auto max_errors{ static_cast<std::size_t>(state.range(0)) };
+
+  std::size_t reported{ 0 };
+  std::size_t rendered{ 0 };
+  for (auto _ : state) {
+    blang::error::ErrorReporter reporter{ max_errors };
+    blang::Scanner scanner{ blang::SourceBuffer::borrow(source), reporter };
+    benchmark::DoNotOptimize(scanner.scan());
+    reported = reporter.diagnostics().size() + reporter.suppressed_count();
+    rendered = reporter.render().size();
+  }
+
+  state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(source.size()));
+  state.counters["errors/s"] = benchmark::Counter(
+    static_cast<double>(reported) * static_cast<double>(state.iterations()), benchmark::Counter::kIsRate);
+  state.counters["rendered_KB"] = static_cast<double>(rendered) / 1024.0;// NOLINT
+}
+
+}// namespace
+
+BENCHMARK(BM_ErrorHeavy)
+  ->ArgName("max_errors")
+  ->Arg(0)
+  ->Arg(static_cast<std::int64_t>(blang::error::DEFAULT_MAX_ERRORS))
+  ->Unit(benchmark::kMillisecond);
@@ -0,0 +1,58 @@
+#include "blang/error/error_reporter.hpp"
+#include "blang/interner.hpp"
+#include "blang/parser.hpp"
+#include "blang/scanner.hpp"
+#include "blang/sema/constant_folder.hpp"
+#include "blang/sema/type_checker.hpp"
+#include "blang/sema/types.hpp"
+#include "blang/source_buffer.hpp"
+#include "blang/token_stream.hpp"
+#include "corpus.hpp"
+
+#include <benchmark/benchmark.h>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Constant folding alone over the checked typed corpus, whose expressions mix
+// literals, the never-assigned constants k0..k3 and the flag with variables.
+// The counters report how much of the tree the fold removed: nodes before and
+// after, and the outermost expressions folded and reads propagated.
+
+namespace {
+
+void BM_ConstantFold(benchmark::State &state)
+{
+  const std::string source{ blang::bench::generate_typed_program(static_cast<std::size_t>(state.range(0))) };
+  blang::Interner interner{};
+  blang::error::ErrorReporter reporter{ 0 };
+  blang::Scanner scanner{ blang::SourceBuffer::borrow(source), reporter, &interner };
+  const blang::TokenStream tokens{ scanner.scan() };
+  const blang::Ast ast{ blang::Parser{ tokens, reporter }.parse_program() };
+  blang::sema::TypeTable table{};
+  blang::sema::TypeChecker checker{ tokens, ast, table, interner, reporter };
+  if (!checker.check()) {
+    state.SkipWithError("typed corpus did not check cleanly");
+    return;
+  }
+
+  blang::sema::FoldStats stats{};
+  for (auto _ : state) {
+    blang::sema::ConstantFolder folder{ tokens, ast, checker };
+    const blang::Ast folded{ folder.fold() };
+    benchmark::DoNotOptimize(folded.size());
+    stats = folder.stats();
+  }
+
+  state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(source.size()));
+  state.counters["nodes_before"] = static_cast<double>(stats.nodes_before);
+  state.counters["nodes_after"] = static_cast<double>(stats.nodes_after);
+  state.counters["eliminated"] = static_cast<double>(stats.eliminated());
+  state.counters["folded"] = static_cast<double>(stats.folded);
+  state.counters["propagated"] = static_cast<double>(stats.propagated);
+  state.counters["pruned"] = static_cast<double>(stats.pruned);
+}
+
+}// namespace
+
+BENCHMARK(BM_ConstantFold)->ArgName("bytes")->Arg(std::int64_t{ 4 } << 20U)->Unit(benchmark::kMillisecond);
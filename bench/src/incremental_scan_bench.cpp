@@ -0,0 +1,58 @@
+#include "blang/error/error_reporter.hpp"
+#include "blang/scanner.hpp"
+#include "blang/source_buffer.hpp"
+
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <string>
+
+// One keystroke in the middle of a file: rescan() of the edited buffer against
+// scanning it from scratch, for growing file sizes. The rescan case types and
+// deletes the character, so it reports two keystrokes per iteration.
+
+namespace {
+
+blang::SourceBuffer keystroke_source(std::size_t bytes)
+{
+  std::string text;
+  while (text.size() < bytes) {
+    text += "f: function integer ( n: integer ) = {\n"
+            "  /* running total */ total: integer = 0;\n"
+            "  while ( n > 0 ) { total = total + n; n--; }\n"
+            "  return total;\n"
+            "}\n";
+  }
+  return blang::SourceBuffer{ std::move(text) };
+}
+
+void BM_KeystrokeFullScan(benchmark::State &state)
+{
+  const blang::SourceBuffer source{ keystroke_source(static_cast<std::size_t>(state.range(0))) };
+  const blang::TextEdit edit{ source.size() / 2, 0, "x" };
+  const blang::SourceBuffer next{ source.edited(edit) };
+  for (auto _ : state) {
+    blang::error::ErrorReporter reporter{};
+    benchmark::DoNotOptimize(blang::Scanner{ next, reporter }.scan());
+  }
+}
+
+void BM_KeystrokeRescan(benchmark::State &state)
+{
+  const blang::SourceBuffer source{ keystroke_source(static_cast<std::size_t>(state.range(0))) };
+  const blang::TextEdit edit{ source.size() / 2, 0, "x" };
+  const blang::TextEdit undo{ source.size() / 2, 1, "" };
+  const blang::SourceBuffer next{ source.edited(edit) };
+  blang::error::ErrorReporter reporter{};
+  blang::TokenStream tokens{ blang::Scanner{ source, reporter }.scan() };
+  for (auto _ : state) {
+    // alternate typing and deleting the character so the stream is reused
+    tokens = blang::Scanner{ next, reporter }.rescan(std::move(tokens), edit);
+    tokens = blang::Scanner{ source, reporter }.rescan(std::move(tokens), undo);
+  }
+  state.SetItemsProcessed(state.iterations() * 2);
+}
+
+}// namespace
+
+BENCHMARK(BM_KeystrokeFullScan)->RangeMultiplier(8)->Range(std::int64_t{ 1 } << 12U, std::int64_t{ 1 } << 24U);
+BENCHMARK(BM_KeystrokeRescan)->RangeMultiplier(8)->Range(std::int64_t{ 1 } << 12U, std::int64_t{ 1 } << 24U);
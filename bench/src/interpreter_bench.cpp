@@ -0,0 +1,90 @@
+#include "blang/error/error_reporter.hpp"
+#include "blang/exec/interpreter.hpp"
+#include "blang/interner.hpp"
+#include "blang/parser.hpp"
+#include "blang/scanner.hpp"
+#include "blang/sema/type_checker.hpp"
+#include "blang/sema/types.hpp"
+#include "blang/source_buffer.hpp"
+#include "blang/token_stream.hpp"
+
+#include <array>
+#include <benchmark/benchmark.h>
+#include <cstddef>
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <string_view>
+
+// The tree-walking interpreter running small programs that stress one thing
+// each: calls, loops over integers, and array subscripts. Scanning, parsing,
+// checking and laying out happen once; each iteration is one run(), which is
+// the baseline faster engines are compared with.
+
+namespace {
+
+struct Program
+{
+  std::string_view name;
+  std::string_view source;
+};
+
+constexpr std::array<Program, 3> PROGRAMS{ {
+  { "calls",
+    "fib: function integer (n: integer) = {\n"
+    "  if (n < 2) return n;\n"
+    "  return fib(n - 1) + fib(n - 2);\n"
+    "}\n"
+    "print fib(24);\n" },
+  { "loops",
+    "total: integer = 0;\n"
+    "i: integer;\n"
+    "j: integer;\n"
+    "for (i = 0; i < 1000; i++) {\n"
+    "  for (j = 0; j < 1000; j++) { total = (total + i * j ^ 2) % 1000003; }\n"
+    "}\n"
+    "print total;\n" },
+  { "arrays",
+    "count: integer = 0;\n"
+    "main: function void () = {\n"
+    "  composite: array [1000000] boolean;\n"
+    "  i: integer;\n"
+    "  j: integer;\n"
+    "  for (i = 2; i * i < 1000000; i++) {\n"
+    "    if (!composite[i]) { for (j = i * i; j < 1000000; j = j + i) composite[j] = true; }\n"
+    "  }\n"
+    "  for (i = 2; i < 1000000; i++) { if (!composite[i]) count++; }\n"
+    "}\n"
+    "main();\n"
+    "print count;\n" },
+} };
+
+void BM_Interpret(benchmark::State &state)
+{
+  const Program &program{ PROGRAMS.at(static_cast<std::size_t>(state.range(0))) };
+  blang::Interner interner{};
+  blang::error::ErrorReporter reporter{ 0 };
+  blang::Scanner scanner{ blang::SourceBuffer::borrow(program.source), reporter, &interner };
+  const blang::TokenStream tokens{ scanner.scan() };
+  const blang::Ast ast{ blang::Parser{ tokens, reporter }.parse_program() };
+  blang::sema::TypeTable types{};
+  blang::sema::TypeChecker checker{ tokens, ast, types, interner, reporter };
+  if (!checker.check()) {
+    state.SkipWithError("benchmark program did not check cleanly");
+    return;
+  }
+
+  std::ostringstream out;
+  blang::exec::Interpreter interpreter{ tokens, ast, checker, reporter, out };
+  for (auto _ : state) {
+    if (!interpreter.run()) {
+      state.SkipWithError("benchmark program failed at run time");
+      return;
+    }
+  }
+  state.SetLabel(std::string{ program.name });
+}
+
+}// namespace
+
+BENCHMARK(BM_Interpret)->ArgName("program")->DenseRange(0, PROGRAMS.size() - 1)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,57 @@
+#include "blang/error/error_reporter.hpp"
+#include "blang/keywords.hpp"
+#include "blang/scanner.hpp"
+
+#include <array>
+#include <benchmark/benchmark.h>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+// Keyword recognition through the compile-time perfect hash, against the
+// per-scanner std::unordered_map it replaced, and the cost of constructing a
+// scanner for a short REPL line.
+
+namespace {
+
+constexpr std::array<std::string_view, 12> WORDS{
+  "integer", "i", "size", "function", "printarray", "for", "a", "return", "total", "x", "while", "temp"
+};
+
+void BM_KeywordPerfectHash(benchmark::State &state)
+{
+  for (auto _ : state) {
+    for (std::string_view word : WORDS) { benchmark::DoNotOptimize(blang::keyword_or_identifier(word)); }
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(WORDS.size()));
+}
+
+void BM_KeywordUnorderedMap(benchmark::State &state)
+{
+  std::unordered_map<std::string, blang::TokenType> keywords{};
+  for (const blang::Keyword &keyword : blang::KEYWORDS) { keywords.emplace(keyword.spelling, keyword.type); }
+
+  for (auto _ : state) {
+    for (std::string_view word : WORDS) {
+      auto search = keywords.find(std::string{ word });
+      benchmark::DoNotOptimize(search == keywords.end() ? blang::TokenType::t_identifier : search->second);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(WORDS.size()));
+}
+
+void BM_ScannerConstruction(benchmark::State &state)
+{
+  for (auto _ : state) {
+    blang::error::ErrorReporter reporter{};
+    blang::Scanner scanner{ blang::SourceBuffer::borrow("x: integer = 1;"), reporter };
+    benchmark::DoNotOptimize(scanner.next_token());
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+}// namespace
+
+BENCHMARK(BM_KeywordPerfectHash);
+BENCHMARK(BM_KeywordUnorderedMap);
+BENCHMARK(BM_ScannerConstruction);
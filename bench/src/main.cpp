@@ -0,0 +1,87 @@
+#include "baseline.hpp"
+
+#include <benchmark/benchmark.h>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#endif
+
+// blang_bench accepts the usual Google Benchmark flags plus:
+//   --baseline_save=FILE       write this run's times as a JSON baseline
+//   --baseline_compare=FILE    compare this run against a saved baseline and
+//                              exit with status 1 on any regression
+//   --baseline_tolerance=X     allowed slowdown before a benchmark counts as
+//                              regressed, as a fraction (default 0.10)
+
+namespace {
+
+struct BaselineFlags
+{
+  std::string save;
+  std::string compare;
+  double tolerance{ 0.10 };// NOLINT
+};
+
+// Removes the baseline flags from argv so benchmark::Initialize only sees its own.
+BaselineFlags take_baseline_flags(int &argc, char **argv)
+{
+  BaselineFlags flags{};
+  std::vector<char *> kept{};
+  for (int index = 0; index < argc; ++index) {
+    std::string_view arg{ argv[index] };// NOLINT
+    auto value_of = [arg](std::string_view flag) { return std::string{ arg.substr(flag.size()) }; };
+    if (arg.starts_with("--baseline_save=")) {
+      flags.save = value_of("--baseline_save=");
+    } else if (arg.starts_with("--baseline_compare=")) {
+      flags.compare = value_of("--baseline_compare=");
+    } else if (arg.starts_with("--baseline_tolerance=")) {
+      flags.tolerance = std::stod(value_of("--baseline_tolerance="));
+    } else {
+      kept.push_back(argv[index]);// NOLINT
+    }
+  }
+  std::copy(kept.begin(), kept.end(), argv);
+  argc = static_cast<int>(kept.size());
+  return flags;
+}
+
+benchmark::ConsoleReporter::OutputOptions console_options()
+{
+#if defined(__unix__) || defined(__APPLE__)
+  if (isatty(STDOUT_FILENO) == 0) { return benchmark::ConsoleReporter::OO_Tabular; }
+#endif
+  return benchmark::ConsoleReporter::OO_Defaults;
+}
+
+}// namespace
+
+int main(int argc, char **argv)
+{
+  const BaselineFlags flags{ take_baseline_flags(argc, argv) };
+  benchmark::Initialize(&argc, argv);
+  if (benchmark::ReportUnrecognizedArguments(argc, argv)) { return 1; }
+
+  blang::bench::RecordingReporter reporter{ console_options() };
+  benchmark::RunSpecifiedBenchmarks(&reporter);
+  benchmark::Shutdown();
+
+  if (!flags.save.empty() && !blang::bench::save_baseline(flags.save, reporter.results())) {
+    std::cerr << "blang_bench: cannot write baseline " << flags.save << '\n';
+    return 1;
+  }
+
+  if (!flags.compare.empty()) {
+    auto baseline{ blang::bench::load_baseline(flags.compare) };
+    if (!baseline.has_value()) {
+      std::cerr << "blang_bench: cannot read baseline " << flags.compare << '\n';
+      return 1;
+    }
+    if (blang::bench::compare_baseline(*baseline, reporter.results(), flags.tolerance, std::cout) > 0) { return 1; }
+  }
+
+  return 0;
+}
@@ -0,0 +1,86 @@
+#include "blang/error/error_reporter.hpp"
+#include "blang/interner.hpp"
+#include "blang/module.hpp"
+#include "blang/parser.hpp"
+#include "blang/scanner.hpp"
+#include "blang/source_buffer.hpp"
+#include "blang/token_stream.hpp"
+#include "corpus.hpp"
+#include "process_stats.hpp"
+
+#include <benchmark/benchmark.h>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+
+// Getting a parsed program into memory two ways: scanning and parsing its
+// source, and loading the module written for it, which maps the file and
+// checks it but does not rebuild anything. Both report the same source bytes
+// so their MB/s compare directly.
+
+namespace {
+
+using blang::bench::CorpusKind;
+
+std::filesystem::path module_path() { return std::filesystem::temp_directory_path() / "blang_module_bench.blm"; }
+
+void BM_CompileSource(benchmark::State &state)
+{
+  const std::string &source{
+    blang::bench::cached_corpus(CorpusKind::balanced, static_cast<std::size_t>(state.range(0)))
+  };
+  blang::Interner interner{};
+  const std::uint64_t allocations_before{ blang::bench::allocation_count() };
+  for (auto _ : state) {
+    blang::error::ErrorReporter reporter{ 0 };
+    blang::Scanner scanner{ blang::SourceBuffer::borrow(source), reporter, &interner };
+    const blang::TokenStream tokens{ scanner.scan() };
+    const blang::Ast ast{ blang::Parser{ tokens, reporter }.parse_program() };
+    benchmark::DoNotOptimize(ast.roots().data());
+  }
+  const std::uint64_t allocations{ blang::bench::allocation_count() - allocations_before };
+
+  state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(source.size()));
+  state.counters["allocs"] = static_cast<double>(allocations) / static_cast<double>(state.iterations());
+}
+
+void BM_LoadModule(benchmark::State &state)
+{
+  const std::string &source{
+    blang::bench::cached_corpus(CorpusKind::balanced, static_cast<std::size_t>(state.range(0)))
+  };
+  blang::Interner interner{};
+  blang::error::ErrorReporter reporter{ 0 };
+  blang::Scanner scanner{ blang::SourceBuffer::borrow(source), reporter, &interner };
+  const blang::TokenStream tokens{ scanner.scan() };
+  const blang::Ast ast{ blang::Parser{ tokens, reporter }.parse_program() };
+  if (!blang::write_module(module_path(), tokens, ast, &interner)) {
+    state.SkipWithError("cannot write the module");
+    return;
+  }
+
+  std::size_t module_bytes{ 0 };
+  const std::uint64_t allocations_before{ blang::bench::allocation_count() };
+  for (auto _ : state) {
+    const std::optional<blang::Module> module{ blang::Module::load(module_path()) };
+    if (!module || module->ast().roots().size() != ast.roots().size()) {
+      state.SkipWithError("module did not load back");
+      return;
+    }
+    module_bytes = module->size();
+    benchmark::DoNotOptimize(module->ast().roots().data());
+  }
+  const std::uint64_t allocations{ blang::bench::allocation_count() - allocations_before };
+  std::filesystem::remove(module_path());
+
+  state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(source.size()));
+  state.counters["allocs"] = static_cast<double>(allocations) / static_cast<double>(state.iterations());
+  state.counters["module_MB"] = static_cast<double>(module_bytes) / (1024.0 * 1024.0);// NOLINT
+}
+
+}// namespace
+
+BENCHMARK(BM_CompileSource)->ArgName("bytes")->Arg(std::int64_t{ 4 } << 20U)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_LoadModule)->ArgName("bytes")->Arg(std::int64_t{ 4 } << 20U)->Unit(benchmark::kMillisecond);
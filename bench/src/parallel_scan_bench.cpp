@@ -0,0 +1,59 @@
+#include "blang/error/error_reporter.hpp"
+#include "blang/scanner.hpp"
+#include "blang/util/thread_pool.hpp"
+
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <string>
+
+// Serial scan() against scan_parallel() for a range of worker counts over the
+// same multi-megabyte source.
+
+namespace {
+
+const std::string &parallel_source()
+{
+  static const std::string source{ [] {
+    std::string text;
+    while (text.size() < (std::size_t{ 16 } << 20U)) {
+      text += "f: function integer ( a: array [10] integer, n: integer ) = {\n"
+              "  /* sum the first n\n     entries */\n"
+              "  total: integer = 0;\n"
+              "  for ( i = 0; i < n; i++ ) { total = total + a[i]; }\n"
+              "  print \"total: \", total, '\\n';\n"
+              "  return total;\n"
+              "}\n";
+    }
+    return text;
+  }() };
+  return source;
+}
+
+void BM_ScanSerial(benchmark::State &state)
+{
+  const std::string &source{ parallel_source() };
+  for (auto _ : state) {
+    blang::error::ErrorReporter reporter{};
+    blang::Scanner scanner{ blang::SourceBuffer::borrow(source), reporter };
+    benchmark::DoNotOptimize(scanner.scan());
+  }
+  state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(source.size()));
+}
+
+void BM_ScanParallel(benchmark::State &state)
+{
+  const std::string &source{ parallel_source() };
+  const auto threads{ static_cast<std::size_t>(state.range(0)) };
+  blang::util::ThreadPool pool{ threads };
+  for (auto _ : state) {
+    blang::error::ErrorReporter reporter{};
+    blang::Scanner scanner{ blang::SourceBuffer::borrow(source), reporter };
+    benchmark::DoNotOptimize(scanner.scan_parallel(pool, threads * 4));
+  }
+  state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(source.size()));
+}
+
+}// namespace
+
+BENCHMARK(BM_ScanSerial)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ScanParallel)->RangeMultiplier(2)->Range(1, 8)->Unit(benchmark::kMillisecond)->UseRealTime();
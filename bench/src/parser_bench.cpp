@@ -0,0 +1,209 @@
+#include "blang/error/error_reporter.hpp"
+#include "blang/parser.hpp"
+#include "blang/scanner.hpp"
+#include "blang/source_buffer.hpp"
+#include "blang/token_stream.hpp"
+#include "corpus.hpp"
+#include "process_stats.hpp"
+
+#include <array>
+#include <benchmark/benchmark.h>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// Expression parsing alone, with the corpus expressions scanned once up
+// front, and whole programs end to end from source to AST, clean and with
+// an error in every few statements. Each benchmark fails when its throughput
+// drops under PARSE_FLOOR_MB_S, which a parser that backtracks or re-reads
+// tokens while recovering falls short of. BM_ParseShared parses generated
+// code that repeats a few expressions, with and without hash-consing them.
+
+namespace {
+
+constexpr std::size_t EXPRESSION_COUNT = 20000;
+constexpr double PARSE_FLOOR_MB_S = 10.0;
+// one statement in BROKEN_EVERY loses its ';' for an unclosed '('
+constexpr std::size_t BROKEN_EVERY = 20;
+
+using blang::bench::CorpusKind;
+
+double mb_per_second(std::size_t bytes, std::int64_t iterations, std::chrono::duration<double> elapsed)
+{
+  return static_cast<double>(bytes) * static_cast<double>(iterations) / elapsed.count() / (1024.0 * 1024.0);// NOLINT
+}
+
+// Output of a code generator: assignments and prints drawn from a handful of
+// expressions over arrays whose indices rarely change.
+std::string repetitive_source(std::size_t bytes)
+{
+  static constexpr std::array<std::string_view, 4> EXPRESSIONS{
+    "a[i] * 2 + 1", "b[j] - a[i] * 2", "(a[i] + b[j]) % 7", "-(b[j] * 3 + 1)"
+  };
+  std::string source{};
+  for (std::size_t line = 0; source.size() < bytes; ++line) {
+    const std::string_view expr{ EXPRESSIONS.at(line % EXPRESSIONS.size()) };
+    if (line % 3 == 0) {// NOLINT
+      source.append("print ").append(expr).append(", ").append(EXPRESSIONS.at((line + 1) % EXPRESSIONS.size()));
+    } else {
+      source.append("r").append(std::to_string(line % 16)).append(" = ").append(expr);// NOLINT
+    }
+    source.append(";\n");
+    if (line % 50 == 49) { source.append("i++;\n"); }// NOLINT
+  }
+  return source;
+}
+
+std::string with_errors(std::string source)
+{
+  std::size_t semicolons{ 0 };
+  for (char &c : source) {
+    if (c == ';' && ++semicolons % BROKEN_EVERY == 0) { c = '('; }
+  }
+  return source;
+}
+
+void BM_ParseExpressions(benchmark::State &state)
+{
+  const std::vector<std::string> sources{ blang::bench::generate_expressions(EXPRESSION_COUNT) };
+  blang::error::ErrorReporter scan_reporter{};
+  std::vector<blang::TokenStream> streams{};
+  streams.reserve(sources.size());
+  std::size_t bytes{ 0 };
+  std::size_t tokens{ 0 };
+  for (const std::string &source : sources) {
+    blang::Scanner scanner{ blang::SourceBuffer::borrow(source), scan_reporter };
+    streams.push_back(scanner.scan());
+    bytes += source.size();
+    tokens += streams.back().size();
+  }
+
+  std::chrono::duration<double> elapsed{};
+  for (auto _ : state) {
+    const auto start{ std::chrono::steady_clock::now() };
+    blang::error::ErrorReporter reporter{};
+    for (const blang::TokenStream &stream : streams) {
+      const blang::Ast ast{ blang::Parser{ stream, reporter }.parse() };
+      benchmark::DoNotOptimize(ast.roots().data());
+    }
+    elapsed += std::chrono::steady_clock::now() - start;
+    if (reporter.get_status() != blang::error::Status::OK) {
+      state.SkipWithError("corpus expression failed to parse");
+      return;
+    }
+  }
+
+  state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(bytes));
+  state.SetItemsProcessed(state.iterations() * static_cast<std::int64_t>(tokens));
+  if (mb_per_second(bytes, state.iterations(), elapsed) < PARSE_FLOOR_MB_S) {
+    state.SkipWithError("throughput under the parse floor");
+  }
+}
+
+void run_program_parse(benchmark::State &state, const std::string &source, bool expect_errors)
+{
+  std::size_t statements{ 0 };
+  std::size_t diagnostics{ 0 };
+  std::size_t ast_bytes{ 0 };
+  std::chrono::duration<double> elapsed{};
+  const std::uint64_t allocations_before{ blang::bench::allocation_count() };
+  for (auto _ : state) {
+    const auto start{ std::chrono::steady_clock::now() };
+    blang::error::ErrorReporter reporter{ 0 };
+    blang::Scanner scanner{ blang::SourceBuffer::borrow(source), reporter };
+    const blang::TokenStream tokens{ scanner.scan() };
+    const blang::Ast ast{ blang::Parser{ tokens, reporter }.parse_program() };
+    elapsed += std::chrono::steady_clock::now() - start;
+    statements = ast.roots().size();
+    ast_bytes = ast.memory_usage();
+    diagnostics = reporter.diagnostics().size();
+  }
+  const std::uint64_t allocations{ blang::bench::allocation_count() - allocations_before };
+  if ((diagnostics > 0) != expect_errors) {
+    state.SkipWithError(expect_errors ? "broken corpus parsed cleanly" : "generated corpus did not parse cleanly");
+    return;
+  }
+
+  state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(source.size()));
+  state.counters["statements"] = static_cast<double>(statements);
+  state.counters["errors"] = static_cast<double>(diagnostics);
+  state.counters["ast_MB"] = static_cast<double>(ast_bytes) / (1024.0 * 1024.0);// NOLINT
+  state.counters["allocs/byte"] =
+    static_cast<double>(allocations) / static_cast<double>(state.iterations()) / static_cast<double>(source.size());
+  state.counters["peak_rss_MB"] = static_cast<double>(blang::bench::peak_rss_bytes()) / (1024.0 * 1024.0);// NOLINT
+  if (mb_per_second(source.size(), state.iterations(), elapsed) < PARSE_FLOOR_MB_S) {
+    state.SkipWithError("throughput under the parse floor");
+  }
+}
+
+void BM_ParseProgram(benchmark::State &state)
+{
+  const auto kind{ static_cast<CorpusKind>(state.range(0)) };
+  state.SetLabel(std::string{ blang::bench::corpus_kind_name(kind) });
+  run_program_parse(state, blang::bench::cached_corpus(kind, static_cast<std::size_t>(state.range(1))), false);
+}
+
+void BM_ParseRecovery(benchmark::State &state)
+{
+  const std::string source{ with_errors(
+    blang::bench::cached_corpus(CorpusKind::balanced, static_cast<std::size_t>(state.range(0)))) };
+  run_program_parse(state, source, true);
+}
+
+void BM_ParseShared(benchmark::State &state)
+{
+  const auto sharing{ static_cast<blang::NodeSharing>(state.range(0)) };
+  const std::string source{ repetitive_source(static_cast<std::size_t>(state.range(1))) };
+  blang::error::ErrorReporter reporter{ 0 };
+  blang::Scanner scanner{ blang::SourceBuffer::borrow(source), reporter };
+  const blang::TokenStream tokens{ scanner.scan() };
+
+  std::size_t nodes{ 0 };
+  std::size_t shared{ 0 };
+  std::size_t ast_bytes{ 0 };
+  for (auto _ : state) {
+    blang::Parser parser{ tokens, reporter, std::pmr::get_default_resource(), sharing };
+    const blang::Ast ast{ parser.parse_program() };
+    nodes = ast.size();
+    shared = parser.shared_nodes();
+    ast_bytes = ast.memory_usage();
+  }
+  if (reporter.get_status() != blang::error::Status::OK) {
+    state.SkipWithError("generated source did not parse cleanly");
+    return;
+  }
+
+  state.SetLabel(sharing == blang::NodeSharing::none ? "plain" : "shared");
+  state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(source.size()));
+  state.counters["nodes"] = static_cast<double>(nodes);
+  state.counters["shared"] = static_cast<double>(shared);
+  // the tree reserves a node per token up front, so the saving is in the nodes
+  // not built rather than in capacity
+  state.counters["saved_MB"] =
+    static_cast<double>(shared * (sizeof(blang::NodeKind) + 3 * sizeof(blang::NodeId))) / (1024.0 * 1024.0);// NOLINT
+  state.counters["ast_MB"] = static_cast<double>(ast_bytes) / (1024.0 * 1024.0);// NOLINT
+}
+
+void corpus_args(benchmark::internal::Benchmark *bench)
+{
+  bench->ArgNames({ "kind", "bytes" });
+  for (std::int64_t kind = 0; kind < static_cast<std::int64_t>(blang::bench::CORPUS_KIND_COUNT); ++kind) {
+    bench->Args({ kind, std::int64_t{ 4 } << 20U });
+  }
+}
+
+}// namespace
+
+BENCHMARK(BM_ParseExpressions)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ParseProgram)->Apply(corpus_args)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ParseShared)
+  ->ArgNames({ "sharing", "bytes" })
+  ->Args({ 0, std::int64_t{ 4 } << 20U })
+  ->Args({ 1, std::int64_t{ 4 } << 20U })
+  ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ParseRecovery)->ArgName("bytes")->Arg(std::int64_t{ 4 } << 20U)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,74 @@
+#include "process_stats.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
+// The benchmark executable replaces the global allocation functions so every
+// operator new made by the library is counted; the count is all the hooks add.
+
+namespace {
+
+std::atomic<std::uint64_t> allocations{ 0 };
+
+void *counted_allocate(std::size_t size)
+{
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  void *memory{ std::malloc(size == 0 ? 1 : size) };// NOLINT
+  if (memory == nullptr) { throw std::bad_alloc{}; }
+  return memory;
+}
+
+void *counted_allocate(std::size_t size, std::align_val_t alignment)
+{
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  const auto align{ static_cast<std::size_t>(alignment) };
+  void *memory{ std::aligned_alloc(align, (size + align - 1) / align * align) };// NOLINT
+  if (memory == nullptr) { throw std::bad_alloc{}; }
+  return memory;
+}
+
+}// namespace
+
+// NOLINTBEGIN(cppcoreguidelines-no-malloc)
+void *operator new(std::size_t size) { return counted_allocate(size); }
+void *operator new[](std::size_t size) { return counted_allocate(size); }
+void *operator new(std::size_t size, std::align_val_t alignment) { return counted_allocate(size, alignment); }
+void *operator new[](std::size_t size, std::align_val_t alignment) { return counted_allocate(size, alignment); }
+void operator delete(void *memory) noexcept { std::free(memory); }
+void operator delete[](void *memory) noexcept { std::free(memory); }
+void operator delete(void *memory, std::size_t /*size*/) noexcept { std::free(memory); }
+void operator delete[](void *memory, std::size_t /*size*/) noexcept { std::free(memory); }
+void operator delete(void *memory, std::align_val_t /*alignment*/) noexcept { std::free(memory); }
+void operator delete[](void *memory, std::align_val_t /*alignment*/) noexcept { std::free(memory); }
+void operator delete(void *memory, std::size_t /*size*/, std::align_val_t /*alignment*/) noexcept { std::free(memory); }
+void operator delete[](void *memory, std::size_t /*size*/, std::align_val_t /*alignment*/) noexcept
+{
+  std::free(memory);
+}
+// NOLINTEND(cppcoreguidelines-no-malloc)
+
+namespace blang::bench {
+
+std::uint64_t allocation_count() { return allocations.load(std::memory_order_relaxed); }
+
+std::uint64_t peak_rss_bytes()
+{
+#if defined(__unix__) || defined(__APPLE__)
+  rusage usage{};
+  if (getrusage(RUSAGE_SELF, &usage) != 0) { return 0; }
+#if defined(__APPLE__)
+  return static_cast<std::uint64_t>(usage.ru_maxrss);
+#else
+  return static_cast<std::uint64_t>(usage.ru_maxrss) * 1024;// NOLINT
+#endif
+#else
+  return 0;
+#endif
+}
+
+}// namespace blang::bench
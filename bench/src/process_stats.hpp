@@ -0,0 +1,16 @@
+#ifndef BLANG_BENCH_PROCESS_STATS_HPP
+#define BLANG_BENCH_PROCESS_STATS_HPP
+
+#include <cstdint>
+
+namespace blang::bench {
+
+// Number of global operator new calls made by the benchmark process so far.
+std::uint64_t allocation_count();
+
+// Peak resident set size of the process in bytes, 0 where unsupported.
+std::uint64_t peak_rss_bytes();
+
+}// namespace blang::bench
+
+#endif
@@ -0,0 +1,131 @@
+#include "blang/error/error_reporter.hpp"
+#include "blang/scanner.hpp"
+#include "blang/simd/scan_kernels.hpp"
+#include "blang/source_buffer.hpp"
+
+#include <benchmark/benchmark.h>
+#include <cstddef>
+#include <string>
+
+// Throughput of the scanner kernels, per instruction set, and of the whole
+// scanner on plain ASCII B-minor source. Every vector kernel should stay well
+// above 1 GB/s.
+
+namespace {
+
+constexpr std::size_t SOURCE_BYTES = std::size_t{ 8 } << 20U;
+
+const std::string &ascii_source()
+{
+  static const std::string source = [] {
+    std::string chunk{
+      "printarray: function void ( a: array [] integer, size: integer ) = {\n"
+      "    i: integer;\n"
+      "    for( i=0;i<size;i++) {\n"
+      "        print a[i], \"\\n\";\n"
+      "    }\n"
+      "}\n"
+      "/* add up every element of the array, then return the total */\n"
+      "total: integer = 1024;\n"
+    };
+    std::string text{};
+    text.reserve(SOURCE_BYTES + chunk.size());
+    while (text.size() < SOURCE_BYTES) { text += chunk; }
+    return text;
+  }();
+  return source;
+}
+
+// a single long run of the class a kernel skips over
+std::string uniform_source(char fill) { return std::string(SOURCE_BYTES, fill); }
+
+const blang::simd::ScanKernels &kernels_arg(const benchmark::State &state)
+{
+  return blang::simd::kernels_for(static_cast<blang::simd::Isa>(state.range(0)));
+}
+
+void set_label(benchmark::State &state, const blang::simd::ScanKernels &kernels, std::size_t bytes)
+{
+  state.SetLabel(std::string{ blang::simd::isa_name(kernels.isa) });
+  state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(bytes));
+}
+
+void BM_SkipWhitespace(benchmark::State &state)
+{
+  const auto &kernels = kernels_arg(state);
+  std::string source{ uniform_source(' ') };
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(kernels.skip_whitespace(source.data(), source.data() + source.size()));
+  }
+  set_label(state, kernels, source.size());
+}
+
+void BM_IdentifierEnd(benchmark::State &state)
+{
+  const auto &kernels = kernels_arg(state);
+  std::string source{ uniform_source('x') };
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(kernels.identifier_end(source.data(), source.data() + source.size()));
+  }
+  set_label(state, kernels, source.size());
+}
+
+void BM_DigitsEnd(benchmark::State &state)
+{
+  const auto &kernels = kernels_arg(state);
+  std::string source{ uniform_source('7') };
+  for (auto _ : state) { benchmark::DoNotOptimize(kernels.digits_end(source.data(), source.data() + source.size())); }
+  set_label(state, kernels, source.size());
+}
+
+void BM_CommentEnd(benchmark::State &state)
+{
+  const auto &kernels = kernels_arg(state);
+  std::string source{ uniform_source('*') };
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(kernels.find_comment_end(source.data(), source.data() + source.size()));
+  }
+  set_label(state, kernels, source.size());
+}
+
+void BM_FindQuote(benchmark::State &state)
+{
+  const auto &kernels = kernels_arg(state);
+  std::string source{ uniform_source('s') };
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(kernels.find_byte(source.data(), source.data() + source.size(), '"'));
+  }
+  set_label(state, kernels, source.size());
+}
+
+void BM_ScanAscii(benchmark::State &state)
+{
+  const std::string &source{ ascii_source() };
+  std::size_t tokens{ 0 };
+  for (auto _ : state) {
+    blang::error::ErrorReporter reporter{};
+    blang::Scanner scanner{ blang::SourceBuffer::borrow(source), reporter };
+    blang::TokenStream stream{ scanner.scan() };
+    tokens = stream.size();
+    benchmark::DoNotOptimize(stream);
+  }
+  state.SetLabel(std::string{ blang::simd::isa_name(blang::simd::kernels().isa) });
+  state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(source.size()));
+  state.counters["tokens"] = static_cast<double>(tokens);
+}
+
+void kernel_isas(benchmark::internal::Benchmark *bench)
+{
+  bench->Arg(static_cast<int>(blang::simd::Isa::scalar));
+  bench->Arg(static_cast<int>(blang::simd::Isa::sse2));
+  bench->Arg(static_cast<int>(blang::simd::Isa::avx2));
+}
+
+}// namespace
+
+BENCHMARK(BM_SkipWhitespace)->Apply(kernel_isas);
+BENCHMARK(BM_IdentifierEnd)->Apply(kernel_isas);
+BENCHMARK(BM_DigitsEnd)->Apply(kernel_isas);
+BENCHMARK(BM_CommentEnd)->Apply(kernel_isas);
+BENCHMARK(BM_FindQuote)->Apply(kernel_isas);
+BENCHMARK(BM_ScanAscii)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,100 @@
+#include "corpus.hpp"
+#include "process_stats.hpp"
+
+#include "blang/error/error_reporter.hpp"
+#include "blang/scanner.hpp"
+#include "blang/source_buffer.hpp"
+#include "blang/token_type.hpp"
+
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// End-to-end scanner throughput over generated B-minor programs of every
+// corpus kind: MB/s, tokens/s, heap allocations per token and the peak RSS of
+// the process, for the materialized scan_tokens() and the scan() stream.
+
+namespace {
+
+using blang::bench::CorpusKind;
+
+template<typename ScanFn> void run_scan(benchmark::State &state, ScanFn scan)
+{
+  const auto kind{ static_cast<CorpusKind>(state.range(0)) };
+  const std::string &source{ blang::bench::cached_corpus(kind, static_cast<std::size_t>(state.range(1))) };
+
+  std::size_t tokens{ 0 };
+  blang::error::Status status{ blang::error::Status::OK };
+  const std::uint64_t allocations_before{ blang::bench::allocation_count() };
+  for (auto _ : state) {
+    blang::error::ErrorReporter reporter{};
+    blang::Scanner scanner{ blang::SourceBuffer::borrow(source), reporter };
+    tokens = scan(scanner);
+    status = scanner.get_status();
+  }
+  const std::uint64_t allocations{ blang::bench::allocation_count() - allocations_before };
+  if (status != blang::error::Status::OK) {
+    state.SkipWithError("generated corpus did not lex cleanly");
+    return;
+  }
+
+  const auto scanned_tokens{ static_cast<double>(tokens) * static_cast<double>(state.iterations()) };
+  state.SetLabel(std::string{ blang::bench::corpus_kind_name(kind) });
+  state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(source.size()));
+  state.counters["tokens/s"] = benchmark::Counter(scanned_tokens, benchmark::Counter::kIsRate);
+  state.counters["allocs/token"] = static_cast<double>(allocations) / scanned_tokens;
+  state.counters["peak_rss_MB"] = static_cast<double>(blang::bench::peak_rss_bytes()) / (1024.0 * 1024.0);// NOLINT
+}
+
+void BM_ScanTokens(benchmark::State &state)
+{
+  run_scan(state, [](blang::Scanner &scanner) {
+    std::vector<blang::Token> tokens{ scanner.scan_tokens() };
+    benchmark::DoNotOptimize(tokens.data());
+    return tokens.size();
+  });
+}
+
+void BM_ScanStream(benchmark::State &state)
+{
+  run_scan(state, [](blang::Scanner &scanner) {
+    blang::TokenStream tokens{ scanner.scan() };
+    benchmark::DoNotOptimize(&tokens);
+    return tokens.size();
+  });
+}
+
+// Scans and then reads the value of every string literal. Literals without
+// escapes are slices of the source, so allocations stay those of the scan.
+void BM_StringLiterals(benchmark::State &state)
+{
+  run_scan(state, [](blang::Scanner &scanner) {
+    blang::TokenStream tokens{ scanner.scan() };
+    std::string scratch{};
+    std::size_t bytes{ 0 };
+    for (std::size_t index = 0; index < tokens.size(); ++index) {
+      if (tokens.type(index) == blang::TokenType::t_string_lit) { bytes += tokens.literal(index, scratch).size(); }
+    }
+    benchmark::DoNotOptimize(bytes);
+    return tokens.size();
+  });
+}
+
+void corpus_args(benchmark::internal::Benchmark *bench)
+{
+  bench->ArgNames({ "kind", "bytes" });
+  for (std::int64_t kind = 0; kind < static_cast<std::int64_t>(blang::bench::CORPUS_KIND_COUNT); ++kind) {
+    bench->Args({ kind, std::int64_t{ 4 } << 20U });
+  }
+  bench->Args({ static_cast<std::int64_t>(CorpusKind::balanced), std::int64_t{ 64 } << 10U });
+}
+
+}// namespace
+
+BENCHMARK(BM_ScanTokens)->Apply(corpus_args)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ScanStream)->Apply(corpus_args)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_StringLiterals)
+  ->ArgNames({ "kind", "bytes" })
+  ->Args({ static_cast<std::int64_t>(CorpusKind::strings), std::int64_t{ 4 } << 20U })
+  ->Unit(benchmark::kMillisecond);
@@ -0,0 +1,90 @@
+#include "corpus.hpp"
+#include "process_stats.hpp"
+
+#include "blang/ast.hpp"
+#include "blang/error/error_reporter.hpp"
+#include "blang/parser.hpp"
+#include "blang/scanner.hpp"
+#include "blang/session.hpp"
+#include "blang/source_buffer.hpp"
+#include "blang/token_stream.hpp"
+
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Scan and parse with everything torn down afterwards, on the global heap and
+// in a Session arena that is reset between compilations: once for a large
+// program and once for many REPL-sized lines, where the per-compilation
+// allocations dominate.
+
+namespace {
+
+using blang::bench::CorpusKind;
+
+constexpr std::size_t REPL_LINES = 20000;
+
+enum class Memory : std::uint8_t { heap, session };
+
+std::size_t compile_on_heap(const std::string &source)
+{
+  blang::error::ErrorReporter reporter{};
+  blang::Scanner scanner{ blang::SourceBuffer::borrow(source), reporter };
+  const blang::TokenStream tokens{ scanner.scan() };
+  const blang::Ast ast{ blang::Parser{ tokens, reporter }.parse_program() };
+  return ast.size();
+}
+
+std::size_t compile_in_session(blang::Session &session, const std::string &source)
+{
+  std::size_t nodes{ 0 };
+  {
+    const blang::TokenStream tokens{ session.scan(blang::SourceBuffer::borrow(source)) };
+    const blang::Ast ast{ session.parse_program(tokens) };
+    nodes = ast.size();
+  }
+  session.reset();
+  return nodes;
+}
+
+template<typename Sources> void run_compile(benchmark::State &state, const Sources &sources)
+{
+  const auto memory{ static_cast<Memory>(state.range(0)) };
+  blang::Session session{};
+  std::size_t bytes{ 0 };
+  for (const std::string &source : sources) { bytes += source.size(); }
+
+  std::size_t nodes{ 0 };
+  const std::uint64_t allocations_before{ blang::bench::allocation_count() };
+  for (auto _ : state) {
+    for (const std::string &source : sources) {
+      nodes += memory == Memory::heap ? compile_on_heap(source) : compile_in_session(session, source);
+    }
+  }
+  const std::uint64_t allocations{ blang::bench::allocation_count() - allocations_before };
+  benchmark::DoNotOptimize(nodes);
+
+  state.SetLabel(memory == Memory::heap ? "heap" : "session");
+  state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(bytes));
+  state.counters["allocs/compile"] =
+    static_cast<double>(allocations) / static_cast<double>(state.iterations()) / static_cast<double>(sources.size());
+}
+
+void BM_CompileProgram(benchmark::State &state)
+{
+  const std::vector<std::string> sources{ blang::bench::cached_corpus(CorpusKind::balanced, std::size_t{ 4 } << 20U) };
+  run_compile(state, sources);
+}
+
+void BM_CompileReplLines(benchmark::State &state)
+{
+  std::vector<std::string> lines{ blang::bench::generate_expressions(REPL_LINES) };
+  for (std::string &line : lines) { line += ";"; }
+  run_compile(state, lines);
+}
+
+}// namespace
+
+BENCHMARK(BM_CompileProgram)->ArgName("session")->DenseRange(0, 1)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_CompileReplLines)->ArgName("session")->DenseRange(0, 1)->Unit(benchmark::kMillisecond);
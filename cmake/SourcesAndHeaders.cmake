@@ -1,5 +1,28 @@
 set(sources
     src/scanner.cpp
+    src/parallel_scan.cpp
+    src/incremental_scan.cpp
+    src/source_buffer.cpp
+    src/line_table.cpp
+    src/token_stream.cpp
+    src/ast.cpp
+    src/parser.cpp
+    src/hash_cons.cpp
+    src/ast_printer.cpp
+    src/sema/types.cpp
+    src/sema/symbol_table.cpp
+    src/sema/type_checker.cpp
+    src/sema/constant_folder.cpp
+    src/exec/interpreter.cpp
+    src/session.cpp
+    src/module.cpp
+    src/numeric_literal.cpp
+    src/string_literal.cpp
+    src/simd/scan_kernels.cpp
+    src/interner.cpp
+    src/util/thread_pool.cpp
+    src/mem/arena.cpp
+    src/error/diagnostic.cpp
     src/error/error_reporter.cpp
 )
 
@@ -10,8 +33,30 @@ set(exe_sources
 
 set(headers
     include/blang/scanner.hpp
+    include/blang/source_buffer.hpp
+    include/blang/line_table.hpp
+    include/blang/token_stream.hpp
+    include/blang/simd/scan_kernels.hpp
     include/blang/ast.hpp
+    include/blang/ast_printer.hpp
+    include/blang/parser.hpp
+    include/blang/hash_cons.hpp
+    include/blang/sema/types.hpp
+    include/blang/sema/symbol_table.hpp
+    include/blang/sema/type_checker.hpp
+    include/blang/sema/constant_folder.hpp
+    include/blang/exec/interpreter.hpp
+    include/blang/arithmetic.hpp
+    include/blang/session.hpp
+    include/blang/module.hpp
     include/blang/token_type.hpp
+    include/blang/keywords.hpp
+    include/blang/numeric_literal.hpp
+    include/blang/string_literal.hpp
+    include/blang/interner.hpp
+    include/blang/util/thread_pool.hpp
+    include/blang/mem/arena.hpp
+    include/blang/error/diagnostic.hpp
     include/blang/error/error_reporter.hpp
 )
 
@@ -26,4 +71,47 @@ set(test_sources
   src/scanner_test/comments_test.cpp
   src/scanner_test/integer_lit_test.cpp
   src/scanner_test/error_reporter_test.cpp
+  src/scanner_test/source_buffer_test.cpp
+  src/scanner_test/token_stream_test.cpp
+  src/scanner_test/lazy_scanner_test.cpp
+  src/scanner_test/scan_kernels_test.cpp
+  src/scanner_test/keywords_lookup_test.cpp
+  src/scanner_test/interner_test.cpp
+  src/scanner_test/parallel_scan_test.cpp
+  src/scanner_test/incremental_scan_test.cpp
+  src/scanner_test/line_table_test.cpp
+  src/scanner_test/unterminated_test.cpp
+  src/scanner_test/numeric_literal_test.cpp
+  src/scanner_test/escape_sequence_test.cpp
+  src/scanner_test/diagnostic_test.cpp
+  src/parser_test/expression_parser_test.cpp
+  src/parser_test/program_parser_test.cpp
+  src/parser_test/hash_cons_test.cpp
+  src/mem_test/arena_test.cpp
+  src/module_test/module_test.cpp
+  src/sema_test/symbol_table_test.cpp
+  src/sema_test/type_checker_test.cpp
+  src/sema_test/parallel_check_test.cpp
+  src/sema_test/constant_folder_test.cpp
+  src/exec_test/interpreter_test.cpp
+)
+
+set(bench_sources
+  src/main.cpp
+  src/baseline.cpp
+  src/corpus.cpp
+  src/process_stats.cpp
+  src/scanner_bench.cpp
+  src/scan_kernels_bench.cpp
+  src/keywords_bench.cpp
+  src/parallel_scan_bench.cpp
+  src/incremental_scan_bench.cpp
+  src/adversarial_bench.cpp
+  src/diagnostics_bench.cpp
+  src/parser_bench.cpp
+  src/session_bench.cpp
+  src/module_bench.cpp
+  src/checker_bench.cpp
+  src/fold_bench.cpp
+  src/interpreter_bench.cpp
 )
@@ -0,0 +1,87 @@
+#ifndef BLANG_ARITHMETIC_HPP
+#define BLANG_ARITHMETIC_HPP
+
+#include "blang/token_type.hpp"
+#include <cstdint>
+#include <limits>
+#include <optional>
+
+namespace blang {
+
+// Integer semantics of B-minor, shared by everything that computes values.
+// Integers are 64-bit two's complement and wrap on overflow. Division and
+// modulo by zero, INT64_MIN divided by -1 and zero to a negative power have
+// no value: whatever runs the program reports them when they happen, and
+// constant folding leaves them for it.
+
+[[nodiscard]] constexpr std::int64_t wrap(std::uint64_t value) { return static_cast<std::int64_t>(value); }
+
+[[nodiscard]] constexpr std::int64_t integer_negate(std::int64_t value)
+{
+  return wrap(std::uint64_t{ 0 } - static_cast<std::uint64_t>(value));
+}
+
+// `base` to the power `exponent`. A negative exponent truncates like a
+// division, to 0 unless the base is 1 or -1.
+[[nodiscard]] constexpr std::optional<std::int64_t> integer_power(std::int64_t base, std::int64_t exponent)
+{
+  if (exponent < 0) {
+    if (base == 0) { return std::nullopt; }
+    if (base == 1) { return 1; }
+    if (base == -1) { return (exponent & 1) != 0 ? -1 : 1; }
+    return 0;
+  }
+  std::uint64_t result{ 1 };
+  auto factor{ static_cast<std::uint64_t>(base) };
+  for (auto remaining{ static_cast<std::uint64_t>(exponent) }; remaining != 0; remaining >>= 1U) {
+    if ((remaining & 1U) != 0) { result *= factor; }
+    factor *= factor;
+  }
+  return wrap(result);
+}
+
+// `lhs op rhs` for one of + - * / % ^.
+[[nodiscard]] constexpr std::optional<std::int64_t> integer_binary(TokenType op, std::int64_t lhs, std::int64_t rhs)
+{
+  const auto left{ static_cast<std::uint64_t>(lhs) };
+  const auto right{ static_cast<std::uint64_t>(rhs) };
+  switch (op) {
+  case TokenType::t_plus:
+    return wrap(left + right);
+  case TokenType::t_minus:
+    return wrap(left - right);
+  case TokenType::t_star:
+    return wrap(left * right);
+  case TokenType::t_slash:
+  case TokenType::t_modulo:
+    if (rhs == 0 || (lhs == std::numeric_limits<std::int64_t>::min() && rhs == -1)) { return std::nullopt; }
+    return op == TokenType::t_slash ? lhs / rhs : lhs % rhs;
+  case TokenType::t_exponent:
+    return integer_power(lhs, rhs);
+  default:
+    return std::nullopt;
+  }
+}
+
+// `lhs op rhs` for one of < <= > >= == !=.
+[[nodiscard]] constexpr bool integer_compare(TokenType op, std::int64_t lhs, std::int64_t rhs)
+{
+  switch (op) {
+  case TokenType::t_less_than:
+    return lhs < rhs;
+  case TokenType::t_less_equal:
+    return lhs <= rhs;
+  case TokenType::t_greater_than:
+    return lhs > rhs;
+  case TokenType::t_greater_equal:
+    return lhs >= rhs;
+  case TokenType::t_equal_equal:
+    return lhs == rhs;
+  default:
+    return lhs != rhs;
+  }
+}
+
+}// namespace blang
+
+#endif
@@ -1,76 +1,155 @@
-#include "blang/scanner.hpp"
+#ifndef BLANG_AST_HPP
+#define BLANG_AST_HPP
 
-namespace blang {
-
-using value_object = std::variant<int, std::string, char>;
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory_resource>
+#include <span>
+#include <vector>
 
-template<typename R> class Binary;
-template<typename R> class Grouping;
-template<typename R> class Literal;
-template<typename R> class Unary;
+namespace blang {
 
-// interface to all Expr's
-template<typename R> struct ExprVisitor
-{
-  virtual R visitBinaryExpr(Binary<R> &expr) const = 0;
-  virtual R visitGroupingExpr(Grouping<R> &expr) const = 0;
-  virtual R visitLiteralExpr(Literal<R> &expr) const = 0;
-  virtual R visitUnaryExpr(Unary<R> &expr) const = 0;
+// Index of a node in an Ast.
+using NodeId = std::uint32_t;
+
+// An omitted optional child: a bare "return;", a for clause, a missing else.
+inline constexpr NodeId NO_NODE = std::numeric_limits<NodeId>::max();
+
+// What a node is and how its token, lhs and rhs are used. A "list" is an
+// index into the extra array holding a count followed by that many NodeIds;
+// "extra [a, b]" is an index into the extra array holding those children.
+enum class NodeKind : std::uint8_t {
+  // expressions
+  binary,// token: operator, lhs: left, rhs: right
+  call,// token: '(', lhs: callee, rhs: list of arguments
+  grouping,// token: '(', lhs: inner expression
+  init_list,// token: '{', rhs: list of elements
+  literal,// token: the literal, whose value the token stream decodes
+  postfix,// token: operator, lhs: operand
+  subscript,// token: '[', lhs: array, rhs: index
+  unary,// token: operator, lhs: operand
+  variable,// token: name
+  integer_constant,// token: what it was folded from, lhs and rhs: low and high 32 bits of the value
+  boolean_constant,// token: what it was folded from, lhs: 0 or 1
+
+  // statements
+  block,// token: '{', rhs: list of statements
+  declaration,// token: name, lhs: type, rhs: extra [initializer, function body]
+  expression_stmt,// token: first token of the expression, lhs: expression
+  for_stmt,// token: 'for', lhs: extra [init, condition, step], rhs: body
+  if_stmt,// token: 'if', lhs: condition, rhs: extra [then, else]
+  print_stmt,// token: 'print', rhs: list of values
+  return_stmt,// token: 'return', lhs: value
+  while_stmt,// token: 'while', lhs: condition, rhs: body
+
+  // types
+  primitive_type,// token: the type keyword
+  array_type,// token: 'array', lhs: size, rhs: element type
+  function_type,// token: 'function', lhs: return type, rhs: list of params
+  param,// token: name, lhs: type
 };
 
-// interface to one expr
-template<typename R> struct Expr
+// Read-only view of a tree's arrays.
+struct AstColumns
 {
-  virtual R accept(const ExprVisitor<R> &visitor) = 0;
+  std::span<const NodeKind> kinds;
+  std::span<const std::uint32_t> tokens;
+  std::span<const NodeId> lhs;
+  std::span<const NodeId> rhs;
+  std::span<const NodeId> extra;
+  std::span<const NodeId> roots;
 };
 
-template<typename R> class Binary : public Expr<R>
+// Syntax tree of one token stream, stored flat: every node is a 1-byte kind,
+// a 32-bit token index and two 32-bit child slots, kept in parallel arrays,
+// with lists and nodes of more than two children spilling into one shared
+// extra array. Nodes refer to each other and to tokens by index, so a tree
+// costs 13 bytes a node plus its lists, is built without an allocation per
+// node and is walked by switching on kind() rather than through virtual
+// calls. Nothing is templated on what a pass computes; passes keep their own
+// per-node results in arrays indexed by NodeId.
+//
+// Children are always added before their parent, so a node's id is greater
+// than any of its descendants'. A parser sharing pure subtrees makes the tree
+// a DAG, where such a node may have several parents. A tree loaded from a
+// module borrows its arrays from the mapped file and copies them on the first
+// change.
+class Ast
 {
 public:
-  Binary(const Expr<R> &left, const Token &_operator, const Expr<R> &right)// NOLINT
-    : m_left{ left }, m_operator{ _operator }, m_right{ right }
+  // The arrays come from `resource`, a session arena or the global heap.
+  explicit Ast(std::pmr::memory_resource *resource = std::pmr::get_default_resource())
+    : m_kinds(resource), m_tokens(resource), m_lhs(resource), m_rhs(resource), m_extra(resource), m_roots(resource)
   {}
-
-  R accept(const ExprVisitor<R> &visitor) override { return visitor.visitBinaryExpr(*this); }
-
-private:
-  Expr<R> m_left;
-  Token m_operator;
-  Expr<R> m_right;
-};
-
-template<typename R> class Grouping : public Expr<R>
-{
-public:
-  explicit Grouping(const Expr<R> &expression) : m_expression{ expression } {}
-
-  R accept(const ExprVisitor<R> &visitor) override { return visitor.visitGroupingExpr(*this); }
+  Ast(const Ast &other);
+  Ast(Ast &&other) noexcept;
+  Ast &operator=(const Ast &other);
+  Ast &operator=(Ast &&other) noexcept;
+  ~Ast() = default;
+
+  // Tree over `columns`, which must outlive it and every copy of it.
+  [[nodiscard]] static Ast borrow(AstColumns columns);
+
+  void reserve(std::size_t nodes);
+  NodeId add(NodeKind kind, std::size_t token, NodeId lhs = NO_NODE, NodeId rhs = NO_NODE);
+  // Appends `children` to the extra array and returns where they start.
+  std::uint32_t add_extra(std::span<const NodeId> children);
+  // Appends a count and `items`, returning the list's index.
+  std::uint32_t add_list(std::span<const NodeId> items);
+  // Adds an integer_constant or boolean_constant node holding `value`.
+  NodeId add_constant(NodeKind kind, std::size_t token, std::int64_t value)
+  {
+    const auto bits{ static_cast<std::uint64_t>(value) };
+    return add(kind, token, static_cast<NodeId>(bits), static_cast<NodeId>(bits >> 32U));// NOLINT
+  }
+  void add_root(NodeId node);
+  // Drops every node and extra entry added after the tree had `nodes` nodes
+  // and `extra` extra entries.
+  void truncate(std::size_t nodes, std::size_t extra);
+
+  [[nodiscard]] std::size_t size() const { return m_view.kinds.size(); }
+  [[nodiscard]] std::size_t extra_size() const { return m_view.extra.size(); }
+  [[nodiscard]] NodeKind kind(NodeId node) const { return m_view.kinds[node]; }
+  [[nodiscard]] std::uint32_t token(NodeId node) const { return m_view.tokens[node]; }
+  [[nodiscard]] NodeId lhs(NodeId node) const { return m_view.lhs[node]; }
+  [[nodiscard]] NodeId rhs(NodeId node) const { return m_view.rhs[node]; }
+  [[nodiscard]] NodeId extra(std::uint32_t index) const { return m_view.extra[index]; }
+  // Value of an integer_constant or boolean_constant node.
+  [[nodiscard]] std::int64_t constant(NodeId node) const
+  {
+    return static_cast<std::int64_t>(std::uint64_t{ m_view.rhs[node] } << 32U | m_view.lhs[node]);// NOLINT
+  }
+  [[nodiscard]] std::span<const NodeId> list(std::uint32_t index) const
+  {
+    return m_view.extra.subspan(index + 1, m_view.extra[index]);
+  }
+  // Top-level statements of a program, or the expression of an expression
+  // parse.
+  [[nodiscard]] std::span<const NodeId> roots() const { return m_view.roots; }
+  [[nodiscard]] const AstColumns &columns() const { return m_view; }
+  [[nodiscard]] bool borrowed() const { return m_borrowed; }
+
+  // Bytes held by the tree's own arrays (capacity, not size).
+  [[nodiscard]] std::size_t memory_usage() const;
 
 private:
-  Expr<R> m_expression;
-};
-
-template<typename R> class Literal : public Expr<R>
-{
-public:
-  explicit Literal(const value_object &value) : m_value{ value } {}// NOLINT
-
-  R accept(const ExprVisitor<R> &visitor) override { return visitor.visitLiteralExpr(*this); }
-
-private:
-  value_object m_value;
-};
-
-template<typename R> class Unary : public Expr<R>
-{
-public:
-  Unary(const Token &_operator, const Expr<R> &right) : m_operator{ _operator }, m_right{ right } {}// NOLINT
-
-  R accept(const ExprVisitor<R> &visitor) override { return visitor.visitUnaryExpr(*this); }
-
-private:
-  Token m_operator;
-  Expr<R> m_right;
+  // Points the view back at the tree's own arrays after they changed.
+  void sync() { m_view = AstColumns{ m_kinds, m_tokens, m_lhs, m_rhs, m_extra, m_roots }; }
+  // Copies borrowed arrays into the tree's own.
+  void own();
+
+  std::pmr::vector<NodeKind> m_kinds;
+  std::pmr::vector<std::uint32_t> m_tokens;
+  std::pmr::vector<NodeId> m_lhs;
+  std::pmr::vector<NodeId> m_rhs;
+  std::pmr::vector<NodeId> m_extra;
+  std::pmr::vector<NodeId> m_roots;
+  // what the accessors read: the arrays above, or borrowed ones
+  AstColumns m_view;
+  bool m_borrowed{ false };
 };
 
 }// namespace blang
+
+#endif
@@ -0,0 +1,35 @@
+#ifndef BLANG_AST_PRINTER_HPP
+#define BLANG_AST_PRINTER_HPP
+
+#include "blang/ast.hpp"
+#include "blang/token_stream.hpp"
+#include <string>
+
+namespace blang {
+
+// Prints an expression fully parenthesized in prefix form, such as
+// "(+ 1 (* 2 x))", so tests can see exactly how it was grouped. Statements
+// print the same way, "(while (< i n) (block (expr (post++ i))))", and a
+// program prints one top-level statement per line.
+class AstPrinter
+{
+public:
+  AstPrinter(const Ast &ast, const TokenStream &tokens) : m_ast(&ast), m_tokens(&tokens) {}
+
+  [[nodiscard]] std::string print(NodeId node) const;
+  // Every root, each on a line of its own.
+  [[nodiscard]] std::string print_roots() const;
+
+private:
+  [[nodiscard]] std::string print_literal(NodeId node) const;
+  [[nodiscard]] std::string print_list(std::string out, std::uint32_t list) const;
+  // `node` printed, or "_" for an omitted child
+  [[nodiscard]] std::string print_optional(NodeId node) const;
+
+  const Ast *m_ast;
+  const TokenStream *m_tokens;
+};
+
+}// namespace blang
+
+#endif
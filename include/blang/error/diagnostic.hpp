@@ -0,0 +1,78 @@
+#ifndef BLANG_DIAGNOSTIC_HPP
+#define BLANG_DIAGNOSTIC_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace blang::error {
+
+enum class Severity : std::uint8_t { note, warning, error };
+
+// Every diagnostic the front end reports. Each code has a fixed severity and
+// a message template whose "{}" are filled with the diagnostic's arguments
+// in order.
+enum class DiagnosticCode : std::uint16_t {
+  source_too_large,
+  unexpected_character,
+  unterminated_string,
+  unterminated_comment,
+  unterminated_char,
+  empty_char,
+  invalid_escape,
+  integer_out_of_range,
+  expected_expression,
+  expected_token,
+  expected_type,
+  invalid_assignment_target,
+  nesting_too_deep,
+  undeclared_name,
+  redeclared_name,
+  type_mismatch,
+  invalid_operand,
+  not_callable,
+  argument_count,
+  not_an_array,
+  misplaced_return,
+  invalid_declaration_type,
+  enclosing_local,
+  no_value,
+  index_out_of_bounds,
+  array_size,
+  too_many_initializers,
+  undefined_function,
+  missing_return,
+  call_depth,
+};
+
+// Most arguments any message template takes.
+inline constexpr std::size_t MAX_DIAGNOSTIC_ARGS = 3;
+
+// Byte range of a diagnostic in its source.
+struct Span
+{
+  std::uint32_t offset;
+  std::uint32_t length;
+};
+
+// Index of a source registered with an ErrorReporter.
+using FileId = std::uint32_t;
+
+// One reported diagnostic. Its arguments are stored in the reporter's
+// argument arena, and nothing is formatted until the diagnostic is printed.
+struct Diagnostic
+{
+  DiagnosticCode code;
+  Severity severity;
+  FileId file;
+  Span span;
+  std::uint32_t first_arg;
+  std::uint32_t arg_count;
+};
+
+[[nodiscard]] Severity severity_of(DiagnosticCode code);
+[[nodiscard]] std::string_view message_template(DiagnosticCode code);
+
+}// namespace blang::error
+
+#endif
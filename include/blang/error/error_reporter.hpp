@@ -1,25 +1,142 @@
 #ifndef BLANG_ERROR_REPORTER_HPP
 #define BLANG_ERROR_REPORTER_HPP
 
+#include "blang/error/diagnostic.hpp"
+#include "blang/source_buffer.hpp"
+#include <atomic>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
 #include <string>
+#include <string_view>
+#include <thread>
 #include <vector>
 namespace blang::error {
 
 enum class Status { OK, ERROR };
 
+constexpr std::size_t DEFAULT_MAX_ERRORS = 100;
+
+// Diagnostics sink shared by everything compiling a set of sources, from any
+// number of threads. Diagnostics are compact records: a code, a span and
+// arguments copied into an arena. Each thread appends to a buffer of its own
+// without taking a lock; the buffers are merged when diagnostics are read,
+// sorted by (file, offset), so a parallel run reports exactly what a serial
+// one does. Reading must not overlap with reporting.
+//
+// Merging drops a diagnostic with the same code at the same place as another
+// and keeps the first DEFAULT_MAX_ERRORS (or the configured cap) errors in
+// that order, only counting the rest. The cap is also applied to each buffer
+// as reports arrive: an error that at least the cap's worth of others in the
+// same buffer sort before can never be shown, so only its place and code are
+// kept, once however often it is reported, and its arguments are freed. The
+// dropped errors are told apart the same way as the shown ones, so the count
+// does not depend on how reports were split between threads. Messages, source
+// snippets and caret underlines are formatted when read or printed.
 class ErrorReporter
 {
 public:
-  ErrorReporter() = default;
+  ErrorReporter();
+  // A cap of 0 keeps every error.
+  explicit ErrorReporter(std::size_t max_errors);
+  ~ErrorReporter() = default;
+  ErrorReporter(const ErrorReporter &) = delete;
+  ErrorReporter(ErrorReporter &&) = delete;
+  ErrorReporter &operator=(const ErrorReporter &) = delete;
+  ErrorReporter &operator=(ErrorReporter &&) = delete;
+
+  // Registers a source diagnostics can point into; the same buffer always
+  // gets the same id. Ids follow registration order, so sources should be
+  // registered in a fixed order for the output to be deterministic.
+  FileId add_source(const SourceBuffer &source);
+  void report(FileId file, DiagnosticCode code, Span span, std::initializer_list<std::string_view> args = {});
+  void report(FileId file, DiagnosticCode code, Span span, std::span<const std::string_view> args);
+  // Reports a diagnostic of `other`, with its arguments, against `file`.
+  void report_from(const ErrorReporter &other, const Diagnostic &diagnostic, FileId file);
 
   void clear_errors();
   [[nodiscard]] Status get_status() const;
+  // Merged diagnostics, sorted and capped.
+  [[nodiscard]] const std::vector<Diagnostic> &diagnostics() const;
+  [[nodiscard]] std::string_view argument(const Diagnostic &diagnostic, std::size_t index) const;
+  // Errors dropped for being past the cap.
+  [[nodiscard]] std::size_t suppressed_count() const;
+
+  // One "[Line N] Error: message" line per diagnostic.
+  [[nodiscard]] std::vector<std::string> get_errors() const;
+  [[nodiscard]] std::string message(const Diagnostic &diagnostic) const;
+  // Every diagnostic with the source line it points at and a caret
+  // underline of its span.
+  [[nodiscard]] std::string render() const;
+  // Writes render() to stderr in a single write.
   void print_errors() const;
-  void set_error(int line, const std::string &message);
 
 private:
-  std::vector<std::string> m_error_messages;
-  Status m_status{ Status::OK };
+  // What is kept of an error dropped past the cap, to count it once.
+  struct Place
+  {
+    FileId file;
+    std::uint32_t offset;
+    DiagnosticCode code;
+
+    auto operator<=>(const Place &) const = default;
+  };
+
+  // Diagnostics with their arguments, and the errors dropped past the cap.
+  struct Reports
+  {
+    std::vector<Diagnostic> diagnostics;
+    std::string arg_bytes;
+    std::vector<Span> args;
+    std::vector<Place> dropped;
+    // leading entries of `dropped` that are sorted and distinct
+    std::size_t distinct_dropped{ 0 };
+
+    [[nodiscard]] std::string_view argument(const Diagnostic &diagnostic, std::size_t index) const;
+    // Appends `diagnostic` of `from`, copying its arguments.
+    void append(Diagnostic diagnostic, const Reports &from);
+    // Sorts, drops repeats and keeps the first `max_errors` errors, 0 keeping
+    // every one, compacting the arguments to those still referred to.
+    void settle(std::size_t max_errors);
+    void drop(const Diagnostic &diagnostic);
+    // Sorts `dropped` and removes its repeats.
+    void settle_dropped();
+    void clear();
+  };
+
+  // Diagnostics appended by one thread.
+  struct Buffer
+  {
+    std::thread::id owner;
+    Reports reports;
+    // errors in `reports`
+    std::size_t errors{ 0 };
+    // once the buffer has held a full cap of errors, the last of them; an
+    // error sorting after it is dropped on arrival
+    std::optional<Diagnostic> last_kept;
+  };
+
+  Buffer &local_buffer();
+  void merge() const;
+  void append_header(std::string &out, const Diagnostic &diagnostic) const;
+  void append_snippet(std::string &out, const Diagnostic &diagnostic) const;
+
+  const std::uint64_t m_id;
+  std::size_t m_max_errors{ DEFAULT_MAX_ERRORS };
+  std::atomic<bool> m_failed{ false };
+  // reports since the last merge, so reads only merge when there is news
+  mutable std::atomic<std::size_t> m_pending{ 0 };
+  mutable std::mutex m_mutex;
+  std::vector<SourceBuffer> m_sources;
+  std::vector<std::unique_ptr<Buffer>> m_buffers;
+
+  // merged state, only touched under m_mutex
+  mutable Reports m_merged;
 };
 
 }// namespace blang::error
@@ -0,0 +1,173 @@
+#ifndef BLANG_EXEC_INTERPRETER_HPP
+#define BLANG_EXEC_INTERPRETER_HPP
+
+#include "blang/ast.hpp"
+#include "blang/error/error_reporter.hpp"
+#include "blang/sema/type_checker.hpp"
+#include "blang/token_stream.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <initializer_list>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace blang::exec {
+
+// Calls a program may nest before it is stopped, well within what the
+// recursion of the walk itself leaves of a default thread stack.
+inline constexpr std::size_t MAX_CALL_DEPTH = 1000;
+
+// Cells of variables and array elements a program may hold at once.
+inline constexpr std::size_t MAX_CELLS = std::size_t{ 1 } << 26U;
+
+// Runs a checked program by walking its tree. It is the reference the faster
+// engines are measured and tested against, and what the blang executable runs.
+//
+// Every value is one 64-bit cell: integers, booleans and chars are
+// themselves, a string is the index of its decoded literal and an array is
+// the index of its first element, preceded by its length, in the same stack
+// as the variables. Nothing is allocated while the program runs but that
+// stack's growth: the cells of a call are pushed on entry and popped on
+// return, and those of an array when its declaration runs and when the block
+// declaring it ends, or the if, while or for whose body is that declaration;
+// that is as long as B-minor lets an array be referred to.
+//
+// Where each variable lives is worked out once, before the first statement
+// runs, from the declarations the checker resolved. A tree parsed with
+// NodeSharing runs like the plain one, since a shared read resolves to one
+// declaration wherever it occurs. Integers follow blang/arithmetic.hpp. Operations
+// without a value, subscripts out of bounds, calls nested too deep and a
+// function ending without returning its value are reported to the reporter
+// as runtime errors, which stop the program.
+class Interpreter
+{
+public:
+  // `checker` has checked `ast` without errors; `print` writes to `out`.
+  Interpreter(const TokenStream &tokens,
+    const Ast &ast,
+    const sema::TypeChecker &checker,
+    error::ErrorReporter &reporter,
+    std::ostream &out);
+
+  // Runs the top-level statements in order; false after a runtime error. The
+  // first `replayed` ones print nothing, so a REPL can run the program so far
+  // again to rebuild its globals before the statements just entered.
+  bool run(std::size_t replayed = 0);
+  // Calls `main` after run(), when the program defines it without
+  // parameters; false after a runtime error.
+  bool run_main();
+  // What `main` returned, 0 when it did not run or returns nothing.
+  [[nodiscard]] std::int64_t exit_code() const { return m_exit_code; }
+
+private:
+  using Value = std::int64_t;
+
+  // Marks an address as a global's rather than an offset into the frame.
+  static constexpr std::uint32_t GLOBAL = std::uint32_t{ 1 } << 31U;
+
+  // What a statement leaves the one around it to do.
+  enum class Flow : std::uint8_t { next, returned };
+
+  // Thrown to unwind out of the program once its error has been reported.
+  class RuntimeError : public std::exception
+  {
+  public:
+    [[nodiscard]] const char *what() const noexcept override { return "runtime error"; }
+  };
+
+  // Slots of the function definition being laid out, or of the globals.
+  struct Layout
+  {
+    NodeId function;
+    // next free slot, and the most in use at once
+    std::uint32_t next;
+    std::uint32_t size;
+  };
+
+  void layout();
+  void layout_statement(NodeId node, Layout &frame);
+  // Lays out the body of an if, while or for in a scope of its own.
+  void layout_body(NodeId node, Layout &frame);
+  void layout_declaration(NodeId node, Layout &frame);
+  void layout_expression(NodeId node, const Layout &frame);
+  // Gives `node`, a declaration or param, the next slot of `frame`.
+  void allocate(NodeId node, Layout &frame);
+  void layout_literal(NodeId node);
+
+  [[noreturn]] void fail(NodeId node, error::DiagnosticCode code, std::initializer_list<std::string_view> args = {});
+  [[nodiscard]] std::string_view text(NodeId node) const { return m_tokens->text(m_ast->token(node)); }
+
+  // Makes room for `count` more cells above the top of the stack.
+  void reserve(std::size_t count)
+  {
+    if (m_top + count > m_stack.size()) { m_stack.resize(std::max(m_stack.size() * 2, m_top + count)); }
+  }
+
+  Flow statement(NodeId node);
+  Flow block(NodeId node);
+  // Runs the body of an if, while or for, popping the arrays it declares.
+  Flow body(NodeId node);
+  void declaration(NodeId node);
+  void print(NodeId node);
+  bool condition(NodeId node) { return expression(node) != 0; }
+
+  // Pushes an array of the array type `type` on the stack, with the elements
+  // of `init_list` when it is not NO_NODE, and returns it.
+  Value array(NodeId type, NodeId init_list);
+
+  Value expression(NodeId node);
+  Value binary(NodeId node);
+  Value call(NodeId node);
+  // Runs `definition` on the frame at `frame`, whose arguments are in place,
+  // for the call at `site`.
+  Value call_function(NodeId definition, NodeId site, std::size_t frame);
+  // Cell that the variable or subscript `node` denotes.
+  std::size_t place(NodeId node);
+  // Cell of a declaration, param or variable.
+  [[nodiscard]] std::size_t cell(NodeId node) const
+  {
+    const std::uint32_t address{ m_addresses[node] };
+    return (address & GLOBAL) != 0 ? address & ~GLOBAL : m_frame + address;
+  }
+
+  const TokenStream *m_tokens;
+  const Ast *m_ast;
+  const sema::TypeChecker *m_checker;
+  error::ErrorReporter *m_reporter;
+  std::optional<error::FileId> m_file;
+  std::ostream *m_out;
+  bool m_laid_out{ false };
+
+  // per node: the address of a declaration, param or variable; the value of
+  // a literal; the definition of a function declaration, or the function a
+  // local belongs to; and the frame size of a function definition
+  std::vector<std::uint32_t> m_addresses;
+  std::vector<Value> m_literals;
+  std::vector<NodeId> m_owners;
+  std::vector<std::uint32_t> m_frame_sizes;
+  // decoded string literals, the empty string first
+  std::vector<std::string> m_strings;
+  // function declarations in scope while laying out, innermost last, and
+  // where the innermost scope starts among them
+  std::vector<NodeId> m_functions;
+  std::size_t m_scope{ 0 };
+  std::uint32_t m_globals{ 0 };
+
+  std::vector<Value> m_stack;
+  std::size_t m_top{ 0 };
+  std::size_t m_frame{ 0 };
+  std::size_t m_depth{ 0 };
+  // value of the last return
+  Value m_result{ 0 };
+  bool m_quiet{ false };
+  std::int64_t m_exit_code{ 0 };
+};
+
+}// namespace blang::exec
+
+#endif
@@ -0,0 +1,97 @@
+#ifndef BLANG_HASH_CONS_HPP
+#define BLANG_HASH_CONS_HPP
+
+#include "blang/ast.hpp"
+#include "blang/token_stream.hpp"
+#include "blang/token_type.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace blang {
+
+// Hash-consing table for the pure expression nodes of one tree: literals,
+// variable reads, groupings, unary and non-assigning binary operators and
+// subscripts. Adding a node equal to one already in the table returns the
+// existing node instead, so every repetition of a subexpression shares a
+// single subtree and a pass that keeps results per NodeId computes them once.
+//
+// Two variable reads are only equal when nothing could have written the
+// variable between them. The parser reports every write, which makes the next
+// read of the name a new node, and with it every expression over it, and
+// places a barrier() wherever control flow may reach a read from elsewhere,
+// such as a call, a loop or a function body, and at the end of every block,
+// after which a name may refer to an outer declaration again. No earlier
+// variable read is reused past a barrier, so the occurrences of a shared read
+// all resolve to the same declaration. A shared node keeps the tokens of its
+// first occurrence.
+class HashConsTable
+{
+public:
+  explicit HashConsTable(const TokenStream &tokens) : m_tokens(&tokens) {}
+
+  // The node equal to (kind, token, lhs, rhs), added to `ast` unless the
+  // table already has one.
+  NodeId add(Ast &ast, NodeKind kind, std::size_t token, NodeId lhs = NO_NODE, NodeId rhs = NO_NODE);
+  // Records a write to the variable `name`.
+  void write(std::string_view name);
+  void barrier() { m_epoch++; }
+  // Forgets every node dropped by Ast::truncate(nodes, ...).
+  void truncate(std::size_t nodes);
+
+  // Nodes that add() returned without adding, each a node the tree saved.
+  [[nodiscard]] std::size_t shared() const { return m_hits.size(); }
+
+private:
+  static constexpr std::size_t MIN_CAPACITY = 64;
+  // a slot emptied by write() or truncate(), which lookups probe past
+  static constexpr NodeId TOMBSTONE = NO_NODE - 1;
+
+  struct Key
+  {
+    NodeKind kind;
+    TokenType type;
+    // children, or NO_NODE and the barrier epoch of a variable read
+    std::uint32_t lhs;
+    std::uint32_t rhs;
+    // lexeme of a literal or variable
+    std::string_view text;
+
+    friend bool operator==(const Key &, const Key &) = default;
+  };
+
+  struct Slot
+  {
+    Key key;
+    NodeId node{ NO_NODE };
+  };
+
+  struct Added
+  {
+    Key key;
+    NodeId node;
+  };
+
+  [[nodiscard]] Key key(NodeKind kind, std::size_t token, NodeId lhs, NodeId rhs) const;
+  [[nodiscard]] static std::size_t hash(const Key &key);
+  // Slot holding `key`, or the tombstone or empty slot it would go in.
+  [[nodiscard]] std::size_t probe(const Key &key) const;
+  void erase(const Key &key, NodeId node);
+  void grow();
+
+  const TokenStream *m_tokens;
+  // open-addressed with linear probing, NO_NODE marks an empty slot
+  std::vector<Slot> m_slots;
+  // live and tombstoned slots
+  std::size_t m_used{ 0 };
+  // nodes in the order they were added, for truncate()
+  std::vector<Added> m_added;
+  // size of the tree at every shared add(), for truncate()
+  std::vector<std::size_t> m_hits;
+  std::uint32_t m_epoch{ 0 };
+};
+
+}// namespace blang
+
+#endif
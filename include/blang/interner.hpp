@@ -0,0 +1,81 @@
+#ifndef BLANG_INTERNER_HPP
+#define BLANG_INTERNER_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <shared_mutex>
+#include <string_view>
+#include <vector>
+
+namespace blang {
+
+// Stable handle for an interned string; two atoms from the same Interner are
+// equal exactly when their strings are.
+enum class Atom : std::uint32_t {};
+
+constexpr Atom NO_ATOM{ UINT32_MAX };
+
+// Table of unique strings. Every distinct string is hashed and copied once
+// into an append-only arena and identified by an Atom from then on. The table
+// is split into independently locked shards so several scanners can intern
+// into it from different threads; lookups of strings already present only
+// take a shared lock.
+class Interner
+{
+public:
+  Interner() = default;
+  Interner(const Interner &) = delete;
+  Interner &operator=(const Interner &) = delete;
+  Interner(Interner &&) = delete;
+  Interner &operator=(Interner &&) = delete;
+  ~Interner() = default;
+
+  Atom intern(std::string_view text);
+  [[nodiscard]] std::optional<Atom> find(std::string_view text) const;
+  // The view stays valid for the lifetime of the interner.
+  [[nodiscard]] std::string_view view(Atom atom) const;
+
+  [[nodiscard]] std::size_t size() const;
+  [[nodiscard]] std::size_t arena_bytes() const;
+
+private:
+  static constexpr unsigned SHARD_BITS = 4;
+  static constexpr std::size_t SHARD_COUNT = std::size_t{ 1 } << SHARD_BITS;
+  static constexpr std::size_t ARENA_CHUNK_SIZE = std::size_t{ 64 } << 10U;
+
+  struct Entry
+  {
+    std::string_view text;
+    std::size_t hash;
+  };
+
+  struct Shard
+  {
+    [[nodiscard]] std::optional<std::uint32_t> probe(std::string_view text, std::size_t hash) const;
+    std::uint32_t insert(std::string_view text, std::size_t hash);
+    std::string_view store(std::string_view text);
+    void grow();
+
+    mutable std::shared_mutex mutex;
+    // open-addressed slots holding entry index + 1, 0 marks an empty slot
+    std::vector<std::uint32_t> slots;
+    std::vector<Entry> entries;
+    std::vector<std::unique_ptr<char[]>> chunks;// NOLINT
+    std::size_t chunk_used{ ARENA_CHUNK_SIZE };
+    std::size_t arena_bytes{ 0 };
+  };
+
+  static Atom make_atom(std::size_t shard, std::uint32_t index)
+  {
+    return static_cast<Atom>(index << SHARD_BITS | static_cast<std::uint32_t>(shard));
+  }
+
+  std::array<Shard, SHARD_COUNT> m_shards;
+};
+
+}// namespace blang
+
+#endif
@@ -0,0 +1,113 @@
+#ifndef BLANG_KEYWORDS_HPP
+#define BLANG_KEYWORDS_HPP
+
+#include "blang/token_type.hpp"
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace blang {
+
+struct Keyword
+{
+  std::string_view spelling;
+  TokenType type;
+};
+
+// Every reserved word of the language. To add a keyword, add its TokenType and
+// an entry here; the perfect hash below is regenerated at compile time.
+constexpr std::array KEYWORDS{
+  Keyword{ "array", TokenType::t_array },
+  Keyword{ "boolean", TokenType::t_boolean },
+  Keyword{ "char", TokenType::t_char },
+  Keyword{ "else", TokenType::t_else },
+  Keyword{ "false", TokenType::t_false },
+  Keyword{ "for", TokenType::t_for },
+  Keyword{ "function", TokenType::t_function },
+  Keyword{ "if", TokenType::t_if },
+  Keyword{ "integer", TokenType::t_integer },
+  Keyword{ "print", TokenType::t_print },
+  Keyword{ "return", TokenType::t_return },
+  Keyword{ "string", TokenType::t_string },
+  Keyword{ "true", TokenType::t_true },
+  Keyword{ "void", TokenType::t_void },
+  Keyword{ "while", TokenType::t_while },
+};
+
+namespace detail {
+
+  constexpr unsigned KEYWORD_TABLE_BITS = 6;
+  constexpr std::size_t KEYWORD_TABLE_SIZE = std::size_t{ 1 } << KEYWORD_TABLE_BITS;
+  constexpr std::uint32_t KEYWORD_SEED_LIMIT = 1U << 16U;
+
+  constexpr std::size_t MIN_KEYWORD_LENGTH = std::min_element(KEYWORDS.begin(),
+    KEYWORDS.end(),
+    [](const Keyword &lhs, const Keyword &rhs) { return lhs.spelling.size() < rhs.spelling.size(); })
+                                               ->spelling.size();
+  constexpr std::size_t MAX_KEYWORD_LENGTH = std::max_element(KEYWORDS.begin(),
+    KEYWORDS.end(),
+    [](const Keyword &lhs, const Keyword &rhs) { return lhs.spelling.size() < rhs.spelling.size(); })
+                                               ->spelling.size();
+  static_assert(MIN_KEYWORD_LENGTH >= 2, "the keyword hash reads the first two bytes");
+
+  // Multiplicative hash over the length, the first two and the last byte.
+  // Only called for texts of at least MIN_KEYWORD_LENGTH bytes.
+  constexpr std::size_t keyword_hash(std::string_view text, std::uint32_t seed)
+  {
+    std::uint32_t key = static_cast<std::uint32_t>(text.size()) | static_cast<std::uint32_t>(text[0]) << 8U
+                        | static_cast<std::uint32_t>(text[1]) << 16U
+                        | static_cast<std::uint32_t>(text[text.size() - 1]) << 24U;
+    return static_cast<std::size_t>((key * seed) >> (32U - KEYWORD_TABLE_BITS));
+  }
+
+  constexpr bool seed_is_perfect(std::uint32_t seed)
+  {
+    std::array<bool, KEYWORD_TABLE_SIZE> used{};
+    for (const Keyword &keyword : KEYWORDS) {
+      std::size_t slot = keyword_hash(keyword.spelling, seed);
+      if (used.at(slot)) { return false; }
+      used.at(slot) = true;
+    }
+    return true;
+  }
+
+  // first odd multiplier that maps every keyword to its own slot
+  constexpr std::uint32_t KEYWORD_SEED = [] {
+    for (std::uint32_t seed = 0x9E3779B1U; seed < 0x9E3779B1U + KEYWORD_SEED_LIMIT; seed += 2) {
+      if (seed_is_perfect(seed)) { return seed; }
+    }
+    return 0U;
+  }();
+  static_assert(KEYWORD_SEED != 0U, "no perfect keyword hash found, widen KEYWORD_TABLE_BITS");
+
+  constexpr std::array<Keyword, KEYWORD_TABLE_SIZE> KEYWORD_TABLE = [] {
+    std::array<Keyword, KEYWORD_TABLE_SIZE> table{};
+    table.fill(Keyword{ {}, TokenType::t_identifier });
+    for (const Keyword &keyword : KEYWORDS) { table.at(keyword_hash(keyword.spelling, KEYWORD_SEED)) = keyword; }
+    return table;
+  }();
+
+}// namespace detail
+
+// Returns the keyword's TokenType, or t_identifier when `text` is not a
+// keyword. One hash and at most one comparison; no setup at runtime.
+constexpr TokenType keyword_or_identifier(std::string_view text)
+{
+  if (text.size() < detail::MIN_KEYWORD_LENGTH || text.size() > detail::MAX_KEYWORD_LENGTH) {
+    return TokenType::t_identifier;
+  }
+
+  const Keyword &slot = detail::KEYWORD_TABLE[detail::keyword_hash(text, detail::KEYWORD_SEED)];// NOLINT
+  return slot.spelling == text ? slot.type : TokenType::t_identifier;
+}
+
+static_assert(std::all_of(KEYWORDS.begin(), KEYWORDS.end(), [](const Keyword &keyword) {
+  return keyword_or_identifier(keyword.spelling) == keyword.type;
+}));
+static_assert(keyword_or_identifier("arrayrt3d") == TokenType::t_identifier);
+
+}// namespace blang
+
+#endif
@@ -0,0 +1,54 @@
+#ifndef BLANG_LINE_TABLE_HPP
+#define BLANG_LINE_TABLE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace blang {
+
+// 1-based line and column of a byte offset.
+struct SourceLocation
+{
+  int line;
+  int column;
+};
+
+// Sorted offsets of every '\n' in a source, from which the line and column of
+// any byte offset are found by binary search. Offsets past the end resolve to
+// the last line. A table either owns its offsets or borrows them, from a
+// loaded module, which must then outlive it.
+class LineTable
+{
+public:
+  LineTable() = default;
+  explicit LineTable(std::string_view source);
+  LineTable(const LineTable &other);
+  LineTable(LineTable &&other) noexcept;
+  LineTable &operator=(const LineTable &other);
+  LineTable &operator=(LineTable &&other) noexcept;
+  ~LineTable() = default;
+
+  [[nodiscard]] static LineTable borrow(std::span<const std::uint32_t> newlines);
+
+  [[nodiscard]] int line(std::size_t offset) const;
+  [[nodiscard]] int column(std::size_t offset) const;
+  [[nodiscard]] SourceLocation locate(std::size_t offset) const;
+  // Offset of the first byte of a 1-based line.
+  [[nodiscard]] std::size_t line_start(int line) const;
+  [[nodiscard]] int line_count() const { return static_cast<int>(m_newlines.size()) + 1; }
+  // Offset of every '\n', in order.
+  [[nodiscard]] std::span<const std::uint32_t> newlines() const { return m_newlines; }
+  [[nodiscard]] std::size_t memory_usage() const { return m_storage.capacity() * sizeof(std::uint32_t); }
+
+private:
+  std::vector<std::uint32_t> m_storage;
+  // what lookups read: m_storage, or the borrowed offsets
+  std::span<const std::uint32_t> m_newlines;
+};
+
+}// namespace blang
+
+#endif
@@ -0,0 +1,172 @@
+#ifndef BLANG_MEM_ARENA_HPP
+#define BLANG_MEM_ARENA_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <new>
+#include <span>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace blang::mem {
+
+inline constexpr std::size_t DEFAULT_PAGE_SIZE = std::size_t{ 1 } << 20U;
+
+// Bump allocator for everything that lives exactly as long as one
+// compilation. Memory is carved out of large pages taken from `upstream` and
+// nothing is freed one object at a time: release() hands every page but the
+// first back at once, so tearing down a compilation costs one free per page
+// rather than one per object, and the next compilation starts on a warm page.
+//
+// The arena is a std::pmr::memory_resource, so containers opt in by being
+// std::pmr containers constructed with it. Deallocating is a no-op, except
+// that the most recent allocation is given back, so a temporary freed right
+// away costs nothing. A growing vector leaves its old buffers behind, which
+// geometric growth bounds by the size of the final one, so containers whose
+// size is known should reserve it. An allocation of more than half a page
+// gets a page of its own. Not thread-safe: give each thread its own arena.
+class Arena final : public std::pmr::memory_resource
+{
+public:
+  explicit Arena(std::size_t page_size = DEFAULT_PAGE_SIZE,
+    std::pmr::memory_resource *upstream = std::pmr::new_delete_resource());
+  Arena(const Arena &) = delete;
+  Arena(Arena &&) = delete;
+  Arena &operator=(const Arena &) = delete;
+  Arena &operator=(Arena &&) = delete;
+  ~Arena() override;
+
+  // Constructs a T in the arena. Its destructor never runs, so T must not
+  // need one; TypedArena runs destructors.
+  template<typename T, typename... Args> T *create(Args &&...args)
+  {
+    static_assert(std::is_trivially_destructible_v<T>, "use a TypedArena for types with destructors");
+    return ::new (bump(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+  }
+
+  // Value-initialized array of `count` trivially destructible T.
+  template<typename T> std::span<T> make_array(std::size_t count)
+  {
+    static_assert(std::is_trivially_destructible_v<T>, "arena arrays are never destroyed");
+    T *first{ static_cast<T *>(bump(sizeof(T) * count, alignof(T))) };
+    for (std::size_t i = 0; i < count; ++i) { ::new (first + i) T{}; }// NOLINT
+    return { first, count };
+  }
+
+  // Copy of `text` that stays valid until release().
+  std::string_view copy(std::string_view text);
+
+  // Drops everything allocated so far. Every page is returned upstream except
+  // the first, which is kept for the next compilation.
+  void release();
+
+  // Bytes handed out since the last release(), padding included.
+  [[nodiscard]] std::size_t bytes_used() const { return m_used; }
+  // Bytes currently held from upstream.
+  [[nodiscard]] std::size_t bytes_reserved() const { return m_reserved; }
+  [[nodiscard]] std::size_t page_count() const { return m_page_count; }
+
+private:
+  struct Page
+  {
+    Page *next;
+    std::size_t size;
+  };
+
+  void *bump(std::size_t bytes, std::size_t alignment)
+  {
+    const auto cursor{ reinterpret_cast<std::uintptr_t>(m_cursor) };// NOLINT
+    const std::uintptr_t aligned{ (cursor + alignment - 1) & ~(std::uintptr_t{ alignment } - 1) };
+    if (m_cursor == nullptr || aligned + bytes > reinterpret_cast<std::uintptr_t>(m_end)) {// NOLINT
+      return allocate_slow(bytes, alignment);
+    }
+    m_used += aligned + bytes - cursor;
+    m_last = reinterpret_cast<char *>(aligned);// NOLINT
+    m_cursor = m_last + bytes;// NOLINT
+    return m_last;
+  }
+
+  void *allocate_slow(std::size_t bytes, std::size_t alignment);
+  Page *new_page(std::size_t size);
+
+  void *do_allocate(std::size_t bytes, std::size_t alignment) override { return bump(bytes, alignment); }
+  void do_deallocate(void *pointer, std::size_t bytes, std::size_t alignment) override;
+  [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override
+  {
+    return this == &other;
+  }
+
+  std::size_t m_page_size;
+  std::pmr::memory_resource *m_upstream;
+  // pages newest first; the page being bumped is always the head
+  Page *m_pages{ nullptr };
+  char *m_cursor{ nullptr };
+  char *m_end{ nullptr };
+  // start of the most recent allocation, which can still be given back
+  char *m_last{ nullptr };
+  std::size_t m_used{ 0 };
+  std::size_t m_reserved{ 0 };
+  std::size_t m_page_count{ 0 };
+};
+
+// Objects of one type allocated densely from an Arena, in blocks of
+// `block_size`. Unlike Arena::create() it may hold types with destructors:
+// clear() and the destructor run them, newest first. The memory itself goes
+// back when the arena is released.
+template<typename T> class TypedArena
+{
+public:
+  explicit TypedArena(Arena &arena, std::size_t block_size = 256)// NOLINT
+    : m_arena(&arena), m_block_size(block_size)
+  {}
+  TypedArena(const TypedArena &) = delete;
+  TypedArena(TypedArena &&) = delete;
+  TypedArena &operator=(const TypedArena &) = delete;
+  TypedArena &operator=(TypedArena &&) = delete;
+  ~TypedArena() { clear(); }
+
+  template<typename... Args> T &create(Args &&...args)
+  {
+    if (m_blocks.empty() || m_blocks.back().used == m_block_size) {
+      void *memory{ m_arena->allocate(sizeof(T) * m_block_size, alignof(T)) };
+      m_blocks.push_back(Block{ static_cast<T *>(memory), 0 });
+    }
+    Block &block{ m_blocks.back() };
+    T *object{ ::new (block.first + block.used) T(std::forward<Args>(args)...) };// NOLINT
+    block.used++;
+    m_size++;
+    return *object;
+  }
+
+  [[nodiscard]] std::size_t size() const { return m_size; }
+
+  void clear()
+  {
+    if constexpr (!std::is_trivially_destructible_v<T>) {
+      for (auto block = m_blocks.rbegin(); block != m_blocks.rend(); ++block) {
+        for (std::size_t i = block->used; i-- > 0;) { block->first[i].~T(); }// NOLINT
+      }
+    }
+    m_blocks.clear();
+    m_size = 0;
+  }
+
+private:
+  struct Block
+  {
+    T *first;
+    std::size_t used;
+  };
+
+  Arena *m_arena;
+  std::size_t m_block_size;
+  std::vector<Block> m_blocks;
+  std::size_t m_size{ 0 };
+};
+
+}// namespace blang::mem
+
+#endif
@@ -0,0 +1,98 @@
+#ifndef BLANG_MODULE_HPP
+#define BLANG_MODULE_HPP
+
+#include "blang/ast.hpp"
+#include "blang/interner.hpp"
+#include "blang/source_buffer.hpp"
+#include "blang/token_stream.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+
+namespace blang {
+
+// Version of the module layout; bumped whenever it changes.
+inline constexpr std::uint32_t MODULE_FORMAT_VERSION = 2;
+
+// Why a module was rejected.
+enum class ModuleError : std::uint8_t {
+  none,
+  unreadable,// the file could not be opened or mapped
+  truncated,// shorter than its header or than the size the header records
+  bad_magic,// not a module, or written with another byte order
+  format_version,// written in another MODULE_FORMAT_VERSION
+  compiler_version,// written by another version of the compiler
+  checksum,// the bytes do not match the checksum they were written with
+  malformed,// a section lies outside the file or disagrees with another
+};
+
+[[nodiscard]] std::string_view module_error_message(ModuleError error);
+
+// Serializes a scanned and parsed source, tokens, tree, line table and the
+// text of every atom, into the module format. `interner` resolves the
+// stream's atoms and may be null when it was scanned without one.
+//
+// A module is a header followed by sections: the source bytes and one
+// section per column of the line table, token stream and tree, each 8-byte
+// aligned and located by its offset from the start of the file, so the bytes
+// mean the same wherever they are mapped. Atoms are renumbered densely into
+// the module's own string table. The header records the format and compiler
+// versions and a checksum of everything after it.
+[[nodiscard]] std::string serialize_module(const TokenStream &tokens,
+  const Ast &ast,
+  const Interner *interner = nullptr);
+// Writes serialize_module() to `path`, returning whether it was written.
+bool write_module(const std::filesystem::path &path,
+  const TokenStream &tokens,
+  const Ast &ast,
+  const Interner *interner = nullptr);
+
+// A module file mapped read-only into memory. Loading checks the header, the
+// checksum and the section bounds, and then uses the mapped bytes in place:
+// the source, token stream, line table and tree borrow their arrays straight
+// from the mapping, so nothing is deserialized and pages are only read when
+// touched. All of them, and copies of them, are invalid once the module is
+// destroyed.
+//
+// The stream's atoms index the module's string table, not an Interner;
+// string() resolves them.
+class Module
+{
+public:
+  Module(const Module &) = delete;
+  Module &operator=(const Module &) = delete;
+  Module(Module &&other) noexcept;
+  Module &operator=(Module &&other) noexcept;
+  ~Module();
+
+  // The module at `path`, or nothing with the reason in `error`.
+  [[nodiscard]] static std::optional<Module> load(const std::filesystem::path &path, ModuleError *error = nullptr);
+
+  [[nodiscard]] const SourceBuffer &source() const { return m_tokens.source(); }
+  [[nodiscard]] const TokenStream &tokens() const { return m_tokens; }
+  [[nodiscard]] const Ast &ast() const { return m_ast; }
+  [[nodiscard]] std::size_t string_count() const { return m_string_offsets.empty() ? 0 : m_string_offsets.size() - 1; }
+  // Text of a module-local atom, empty for NO_ATOM.
+  [[nodiscard]] std::string_view string(Atom atom) const;
+  // Size of the mapped file.
+  [[nodiscard]] std::size_t size() const { return m_size; }
+
+private:
+  Module() = default;
+  void unmap();
+
+  void *m_mapping{ nullptr };
+  std::size_t m_size{ 0 };
+  TokenStream m_tokens;
+  Ast m_ast;
+  std::span<const std::uint32_t> m_string_offsets;
+  std::string_view m_string_bytes;
+};
+
+}// namespace blang
+
+#endif
@@ -0,0 +1,29 @@
+#ifndef BLANG_NUMERIC_LITERAL_HPP
+#define BLANG_NUMERIC_LITERAL_HPP
+
+#include "blang/simd/scan_kernels.hpp"
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+namespace blang {
+
+// Integer literals are decimal, or hexadecimal and binary behind a 0x / 0b
+// prefix (either case), and hold a signed 64-bit value. A prefix that is not
+// followed by a digit of its base is not part of the literal, so "0x" still
+// lexes as 0 followed by the identifier x.
+
+// End of the integer literal starting at `first`, which must be a digit.
+const char *integer_literal_end(const char *first, const char *last, const simd::ScanKernels &kernels);
+
+// Value of a complete integer literal lexeme, nothing when it does not fit
+// in 64 bits.
+std::optional<std::int64_t> parse_integer_literal(std::string_view lexeme);
+
+// Whether the literal fits in 64 bits. Literals too short to overflow, which
+// is nearly all of them, are accepted without being parsed.
+bool integer_literal_in_range(std::string_view lexeme);
+
+}// namespace blang
+
+#endif
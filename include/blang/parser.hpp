@@ -0,0 +1,209 @@
+#ifndef BLANG_PARSER_HPP
+#define BLANG_PARSER_HPP
+
+#include "blang/ast.hpp"
+#include "blang/error/error_reporter.hpp"
+#include "blang/hash_cons.hpp"
+#include "blang/token_stream.hpp"
+#include "blang/token_type.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <initializer_list>
+#include <memory_resource>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+namespace blang {
+
+// Binding power of the operators, loosest first.
+enum class Precedence : std::uint8_t {
+  none,
+  assignment,// =
+  logical_or,// ||
+  logical_and,// &&
+  equality,// == !=
+  comparison,// < <= > >=
+  term,// + -
+  factor,// * / %
+  exponent,// ^
+  unary,// ! -
+  postfix,// ++ -- call subscript
+};
+
+// How a token continues an expression that precedes it.
+struct InfixRule
+{
+  Precedence precedence{ Precedence::none };
+  bool right_associative{ false };
+};
+
+inline constexpr std::size_t TOKEN_TYPE_COUNT = static_cast<std::size_t>(TokenType::t_eof) + 1;
+// Deepest nesting of expressions, statements and types together.
+inline constexpr int MAX_NESTING_DEPTH = 256;
+
+// Infix and postfix operators indexed by token type; any other token ends the
+// expression.
+inline constexpr std::array<InfixRule, TOKEN_TYPE_COUNT> INFIX_RULES = [] {
+  std::array<InfixRule, TOKEN_TYPE_COUNT> rules{};
+  auto set = [&rules](std::initializer_list<TokenType> types, Precedence precedence, bool right = false) {
+    for (TokenType type : types) { rules.at(static_cast<std::size_t>(type)) = InfixRule{ precedence, right }; }
+  };
+  set({ TokenType::t_equal }, Precedence::assignment, true);
+  set({ TokenType::t_or_or }, Precedence::logical_or);
+  set({ TokenType::t_and_and }, Precedence::logical_and);
+  set({ TokenType::t_equal_equal, TokenType::t_bang_equal }, Precedence::equality);
+  set({ TokenType::t_less_than, TokenType::t_less_equal, TokenType::t_greater_than, TokenType::t_greater_equal },
+    Precedence::comparison);
+  set({ TokenType::t_plus, TokenType::t_minus }, Precedence::term);
+  set({ TokenType::t_star, TokenType::t_slash, TokenType::t_modulo }, Precedence::factor);
+  set({ TokenType::t_exponent }, Precedence::exponent, true);
+  set({ TokenType::t_plus_plus, TokenType::t_minus_minus, TokenType::t_left_paren, TokenType::t_left_square },
+    Precedence::postfix);
+  return rules;
+}();
+
+[[nodiscard]] constexpr InfixRule infix_rule(TokenType type) { return INFIX_RULES.at(static_cast<std::size_t>(type)); }
+
+// Whether repeated pure subexpressions share nodes, see HashConsTable.
+enum class NodeSharing : std::uint8_t { none, pure_subtrees };
+
+// Thrown to unwind out of a statement once its error has been reported.
+class ParseError : public std::exception
+{
+public:
+  [[nodiscard]] const char *what() const noexcept override { return "parse error"; }
+};
+
+// Single-pass parser over a scanned token stream into a flat Ast.
+// Statements are parsed by recursive descent and expressions by precedence
+// climbing over INFIX_RULES. Every token is looked at once, with at most two
+// tokens of lookahead, so parsing is linear in the number of tokens.
+//
+// A statement with an error is dropped, nodes and all, and the parser
+// resynchronizes in panic mode, skipping to the end of the statement: past
+// the next ';' or a balanced '{ ... }', or up to the '}' that closes the
+// enclosing block. One mistake then gives one error rather than a cascade,
+// and since skipped tokens are never revisited recovery stays linear too.
+//
+// With NodeSharing::pure_subtrees the tree is a DAG: repeated pure
+// subexpressions are hash-consed into one node with several parents, which is
+// worth it for generated sources that repeat the same expressions many times.
+class Parser
+{
+public:
+  // The tree is allocated from `resource`.
+  Parser(const TokenStream &tokens,
+    error::ErrorReporter &reporter,
+    std::pmr::memory_resource *resource = std::pmr::get_default_resource(),
+    NodeSharing sharing = NodeSharing::none);
+
+  // Parses the whole stream as one expression, the tree's only root; the
+  // tree has no root after an error.
+  Ast parse();
+  // Parses the whole stream as a program, one root per top-level statement.
+  // Statements with errors are left out, so the tree is only complete when
+  // nothing was reported.
+  Ast parse_program();
+
+  // Nodes the last parse reused rather than added; always 0 without sharing.
+  [[nodiscard]] std::size_t shared_nodes() const { return m_sharing ? m_sharing->shared() : 0; }
+
+private:
+  // Keeps recursion bounded however deeply the source nests.
+  class DepthGuard
+  {
+  public:
+    explicit DepthGuard(Parser &parser);
+    DepthGuard(const DepthGuard &) = delete;
+    DepthGuard(DepthGuard &&) = delete;
+    DepthGuard &operator=(const DepthGuard &) = delete;
+    DepthGuard &operator=(DepthGuard &&) = delete;
+    ~DepthGuard() { m_parser.m_depth--; }
+
+  private:
+    Parser &m_parser;
+  };
+
+  [[nodiscard]] TokenType peek() const { return m_tokens->type(m_current); }
+  [[nodiscard]] TokenType peek_next() const
+  {
+    return at_end() ? TokenType::t_eof : m_tokens->type(m_current + 1);
+  }
+  [[nodiscard]] bool check(TokenType type) const { return peek() == type; }
+  [[nodiscard]] bool at_end() const { return check(TokenType::t_eof); }
+
+  std::size_t advance()
+  {
+    if (!at_end()) { m_current++; }
+    return m_current - 1;
+  }
+
+  bool match(TokenType type)
+  {
+    if (!check(type)) { return false; }
+    advance();
+    return true;
+  }
+
+  // Consumes a token of `type`, or reports what was expected `where` and
+  // unwinds.
+  std::size_t expect(TokenType type, std::string_view where);
+  [[noreturn]] void fail(error::DiagnosticCode code, std::initializer_list<std::string_view> args = {});
+  void report(std::size_t index, error::DiagnosticCode code, std::initializer_list<std::string_view> args = {});
+
+  // Adds a pure expression node, shared with an equal one when sharing.
+  NodeId add_pure(NodeKind kind, std::size_t token, NodeId lhs = NO_NODE, NodeId rhs = NO_NODE)
+  {
+    return m_sharing ? m_sharing->add(m_ast, kind, token, lhs, rhs) : m_ast.add(kind, token, lhs, rhs);
+  }
+  // Tells the sharing table that the variable under `target`, an assignment
+  // or increment operand, is written.
+  void note_write(NodeId target);
+  // Same for the name a declaration or parameter binds.
+  void note_declaration(std::size_t name)
+  {
+    if (m_sharing) { m_sharing->write(m_tokens->text(name)); }
+  }
+  void barrier()
+  {
+    if (m_sharing) { m_sharing->barrier(); }
+  }
+  void truncate(std::size_t nodes, std::size_t extra);
+
+  // Moves the children pushed on the scratch stack since `mark` into a list.
+  std::uint32_t finish_list(std::size_t mark);
+
+  NodeId statement();
+  // Statement that drops itself on an error, after skipping to where the
+  // next one starts; NO_NODE then.
+  NodeId recovering_statement();
+  void synchronize();
+  NodeId block(std::string_view where);
+  NodeId parenthesized(std::string_view where);
+  NodeId for_statement();
+  NodeId declaration();
+  NodeId type_spec();
+  NodeId init_list();
+
+  NodeId expression() { return parse_precedence(Precedence::assignment); }
+  NodeId parse_precedence(Precedence min);
+  NodeId prefix();
+  NodeId finish_call(NodeId callee, std::size_t paren);
+
+  const TokenStream *m_tokens;
+  error::ErrorReporter *m_reporter;
+  std::optional<error::FileId> m_file;
+  Ast m_ast;
+  std::optional<HashConsTable> m_sharing;
+  // children of the lists being parsed, innermost last
+  std::vector<NodeId> m_scratch;
+  std::size_t m_current{ 0 };
+  int m_depth{ 0 };
+};
+
+}// namespace blang
+
+#endif
@@ -2,82 +2,190 @@
 #define BLANG_SCANNER_HPP
 
 #include "blang/error/error_reporter.hpp"
+#include "blang/interner.hpp"
+#include "blang/keywords.hpp"
+#include "blang/simd/scan_kernels.hpp"
+#include "blang/source_buffer.hpp"
+#include "blang/token_stream.hpp"
 #include "blang/token_type.hpp"
+#include "blang/util/thread_pool.hpp"
+#include <array>
 #include <cstddef>
-#include <optional>
+#include <cstdint>
+#include <future>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <memory_resource>
 #include <string>
-#include <unordered_map>
-#include <variant>
+#include <string_view>
 #include <vector>
 
 namespace blang {
 
-using value_object = std::variant<int, std::string, char>;
+constexpr std::size_t LOOKAHEAD_CAPACITY = 4;
+constexpr std::size_t PARALLEL_MIN_CHUNK_BYTES = std::size_t{ 64 } << 10U;
+// Largest source the scanner accepts: token offsets and diagnostic spans are
+// 32-bit, and eof ends one byte past the source.
+constexpr std::size_t MAX_SOURCE_BYTES = std::numeric_limits<std::uint32_t>::max() - 1;
 
-constexpr int TOKEN_ALIGNMENT = 64;
-constexpr int NOT_IDENTIFIED_EXIT = 64;
-
-// Token type struct to encapsulate all the attributes
-struct alignas(TOKEN_ALIGNMENT) Token
+// One token handed out by the pull interface, together with its atom when it
+// was interned.
+struct ScannedToken
 {
-  TokenType type;
-  std::size_t position;
-  int line;
-  value_object value;
+  Lexeme lexeme;
+  Atom atom{ NO_ATOM };
 };
 
-// Scanner class which produces a vector of tokens one by one from a source
-// file or source input.
+// Scanner class which produces tokens one by one from a source file or source
+// input. Tokens are lexed on demand through next_token()/peek(), so a consumer
+// only ever holds LOOKAHEAD_CAPACITY tokens in memory; scan() and
+// scan_tokens() drain the scanner into a whole stream.
 class Scanner
 {
 public:
-  Scanner() = default;
-  Scanner(std::string source, error::ErrorReporter reporter)
-    : m_source(std::move(source)), m_reporter(std::move(reporter))
-  {}
+  // Single-pass view over the tokens not yet consumed, ending after eof.
+  class TokenRange
+  {
+  public:
+    class iterator
+    {
+    public:
+      using iterator_concept = std::input_iterator_tag;
+      using value_type = ScannedToken;
+      using difference_type = std::ptrdiff_t;
+
+      iterator() = default;
+      explicit iterator(Scanner *scanner) : m_scanner(scanner) {}
+
+      const ScannedToken &operator*() const { return m_scanner->peek(); }
+      iterator &operator++()
+      {
+        m_scanner->next_token();
+        if (m_scanner->m_finished) { m_scanner = nullptr; }
+        return *this;
+      }
+      void operator++(int) { ++*this; }
+      friend bool operator==(const iterator &iter, std::default_sentinel_t /*unused*/)
+      {
+        return iter.m_scanner == nullptr;
+      }
+
+    private:
+      Scanner *m_scanner{ nullptr };
+    };
+
+    explicit TokenRange(Scanner *scanner) : m_scanner(scanner) {}
+
+    [[nodiscard]] iterator begin() const { return iterator{ m_scanner->m_finished ? nullptr : m_scanner }; }
+    [[nodiscard]] std::default_sentinel_t end() const { return std::default_sentinel; }
+
+  private:
+    Scanner *m_scanner;
+  };
+
+  // Errors go to `reporter`, which must outlive the scanner and may be
+  // shared with other scanners, on any thread.
+  Scanner(std::string source, error::ErrorReporter &reporter) : Scanner(SourceBuffer{ std::move(source) }, reporter) {}
+  // With an interner, identifiers and string literal values are interned as
+  // they are scanned and their atoms travel with the tokens. A source larger
+  // than MAX_SOURCE_BYTES is reported and scanned as an empty one.
+  Scanner(SourceBuffer source, error::ErrorReporter &reporter, Interner *interner = nullptr);
 
   std::vector<Token> scan_tokens();
+  // The stream's columns are allocated from `resource`.
+  TokenStream scan(std::pmr::memory_resource *resource = std::pmr::get_default_resource());
+  // Lexes the source on `pool` in up to `chunk_count` chunks split at line
+  // boundaries and stitches them together. Tokens and reported errors are
+  // identical to scan(); inputs too small to split are scanned serially.
+  TokenStream scan_parallel(util::ThreadPool &pool,
+    std::size_t chunk_count,
+    std::size_t min_chunk_bytes = PARALLEL_MIN_CHUNK_BYTES);
+  // Lexes this scanner's source, which must be `previous.source()` with
+  // `edit` applied, reusing the tokens of `previous` outside the edited region.
+  // Lexing restarts after the last token the edit cannot affect and stops as
+  // soon as a new token lines up with an old one past the edit; the new tokens
+  // are spliced into `previous` in place, so move the old stream in. Only
+  // errors in the re-lexed region are reported.
+  TokenStream rescan(TokenStream previous, const TextEdit &edit);
   error::Status get_status() const;
+  [[nodiscard]] const error::ErrorReporter &get_reporter() const { return *m_reporter; }
+  // Value of a token from next_token() or peek(), as TokenStream::value().
+  [[nodiscard]] value_object value(const ScannedToken &token) const;
+
+  // Consumes and returns the next token; after eof it keeps returning eof.
+  ScannedToken next_token();
+  // Returns the token `ahead` positions past the next one without consuming
+  // it. The reference stays valid until that token is consumed.
+  const ScannedToken &peek(std::size_t ahead = 0);
+  TokenRange tokens() { return TokenRange{ this }; }
+
+  [[nodiscard]] const SourceBuffer &source() const { return m_source; }
 
 private:
-  void add_token(TokenType type, const value_object &value);
-  char consume();
-  [[nodiscard]] std::optional<char> peek_next() const;
-  void consume_next(char next,
-    TokenType dbl,
-    const value_object &val_dbl,
-    TokenType single,
-    const value_object &val_single);
-  void process_identifier(char curr_char);
-  void process_integer_lit(char curr_char);
+
+  struct ChunkScan
+  {
+    TokenStream tokens;
+    std::size_t stop{ 0 };
+    // held back until the chunk is known to be lexed from the right state
+    std::unique_ptr<error::ErrorReporter> errors;
+    bool failed{ false };
+  };
+
+  // Scanner for a chunk of `parent`'s source, starting in normal state at
+  // `start` and reporting to `reporter`.
+  Scanner(const Scanner &parent, std::size_t start, error::ErrorReporter &reporter);
+
+  TokenStream scan_until(std::size_t limit);
+  [[nodiscard]] std::vector<std::size_t> chunk_bounds(std::size_t chunk_count, std::size_t min_chunk_bytes) const;
+  ChunkScan scan_chunk(std::size_t begin, std::size_t end) const;
+  TokenStream stitch_chunks(const std::vector<std::size_t> &bounds, std::vector<std::future<ChunkScan>> &chunks);
+  void report_error(error::DiagnosticCode code, std::initializer_list<std::string_view> args = {});
+  void forward_errors(const error::ErrorReporter &errors, std::size_t from);
+  void push_scanned(TokenStream &tokens);
+
+  ScannedToken lex_token();
+  void lex_next();
+  void add_token(TokenType type);
+  void intern_token(std::string_view text);
+  bool match_next(char next);
+  void consume_next(char next, TokenType dbl, TokenType single);
+  void skip_whitespace();
+  void process_identifier();
+  void process_integer_lit();
   void process_char_lit();
   void process_string_lit();
   void process_comments();
-  [[nodiscard]] static bool valid_identifier_start_char(char chh);
-  [[nodiscard]] static bool valid_identifier_char(char chh);
 
-  std::string m_source;
+  // NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+  [[nodiscard]] const char *cursor(std::size_t offset) const { return m_source.data() + offset; }
+  [[nodiscard]] const char *source_end() const { return m_source.data() + m_source.size(); }
+  [[nodiscard]] std::size_t offset_of(const char *ptr) const
+  {
+    return static_cast<std::size_t>(ptr - m_source.data());
+  }
+  // NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+
+  SourceBuffer m_source;
+  // tokens are only started below the limit, chunk scanners stop early
+  std::size_t m_limit{ 0 };
+  std::size_t m_start{ 0 };
   std::size_t m_position{ 0 };
-  int m_line{ 1 };
-  std::vector<Token> m_tokens;
-  error::ErrorReporter m_reporter;
-  std::unordered_map<std::string, TokenType> m_keywords = {
-    { "array", TokenType::t_array },
-    { "boolean", TokenType::t_boolean },
-    { "char", TokenType::t_char },
-    { "else", TokenType::t_else },
-    { "false", TokenType::t_false },
-    { "for", TokenType::t_for },
-    { "function", TokenType::t_function },
-    { "if", TokenType::t_if },
-    { "integer", TokenType::t_integer },
-    { "print", TokenType::t_print },
-    { "return", TokenType::t_return },
-    { "string", TokenType::t_string },
-    { "true", TokenType::t_true },
-    { "void", TokenType::t_void },
-    { "while", TokenType::t_while },
-  };
+  Lexeme m_lexeme{};
+  Atom m_atom{ NO_ATOM };
+  // decoded string literal values for the interner, reused across literals
+  std::string m_scratch;
+  bool m_emitted{ false };
+  std::array<ScannedToken, LOOKAHEAD_CAPACITY> m_lookahead{};
+  std::size_t m_lookahead_head{ 0 };
+  std::size_t m_lookahead_count{ 0 };
+  bool m_finished{ false };
+  error::ErrorReporter *m_reporter;
+  error::FileId m_file{ 0 };
+  Interner *m_interner{ nullptr };
+  const simd::ScanKernels *m_kernels{ &simd::kernels() };
 };
 
 }// namespace blang
@@ -0,0 +1,95 @@
+#ifndef BLANG_SEMA_CONSTANT_FOLDER_HPP
+#define BLANG_SEMA_CONSTANT_FOLDER_HPP
+
+#include "blang/ast.hpp"
+#include "blang/sema/type_checker.hpp"
+#include "blang/token_stream.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+namespace blang::sema {
+
+// What one fold did to a tree.
+struct FoldStats
+{
+  std::size_t nodes_before{ 0 };
+  std::size_t nodes_after{ 0 };
+  // outermost operators and groupings replaced by their value, or by their
+  // right operand for a short circuit
+  std::size_t folded{ 0 };
+  // outermost variable reads replaced by the value of their declaration
+  std::size_t propagated{ 0 };
+  // ifs and whiles replaced by the branch their constant condition takes
+  std::size_t pruned{ 0 };
+
+  [[nodiscard]] std::size_t eliminated() const { return nodes_before - nodes_after; }
+};
+
+// Folds the integer and boolean expressions of a checked program whose value
+// is known before it runs into integer_constant and boolean_constant nodes,
+// following the semantics of blang/arithmetic.hpp: arithmetic wraps, and an
+// operation without a value, such as a division by zero, is left for run
+// time. A variable of integer or boolean type that is initialized with a
+// constant and never assigned or incremented anywhere is a constant too, and
+// its reads are replaced by its value. `false && x` and `true || x` fold
+// without looking at x, which never runs; `true && x` and `false || x` become
+// x. An if or while whose condition folds is replaced by the branch taken.
+//
+// The result is a new tree that holds only what is still reachable, so the
+// folded operands are gone rather than orphaned. Values are computed in one
+// pass in node order, which visits operands before their operator and a
+// declaration before its reads; the new tree is then built from the roots.
+// A tree parsed with NodeSharing folds like the plain one: a shared read
+// resolves to one declaration wherever it occurs, and a node shared by
+// several parents is emitted once and stays shared in the new tree.
+class ConstantFolder
+{
+public:
+  // `checker` has checked `ast`; the new tree comes from `resource`.
+  ConstantFolder(const TokenStream &tokens,
+    const Ast &ast,
+    const TypeChecker &checker,
+    std::pmr::memory_resource *resource = std::pmr::get_default_resource());
+
+  Ast fold();
+  [[nodiscard]] const FoldStats &stats() const { return m_stats; }
+
+private:
+  enum class Known : std::uint8_t { no, integer, boolean };
+
+  void find_writes();
+  void evaluate(NodeId node);
+  void evaluate_binary(NodeId node);
+  void set(NodeId node, Known known, std::int64_t value)
+  {
+    m_known[node] = known;
+    m_values[node] = value;
+  }
+
+  NodeId emit(NodeId node);
+  NodeId emit_optional(NodeId node) { return node == NO_NODE ? NO_NODE : emit(node); }
+  NodeId emit_node(NodeId node);
+  std::uint32_t emit_list(std::uint32_t list);
+  std::uint32_t emit_extra(std::uint32_t index, std::size_t count);
+  NodeId empty_block(NodeId node);
+
+  const TokenStream *m_tokens;
+  const Ast *m_ast;
+  const TypeChecker *m_checker;
+  Ast m_out;
+  FoldStats m_stats;
+  std::vector<Known> m_known;
+  std::vector<std::int64_t> m_values;
+  // declarations assigned or incremented somewhere
+  std::vector<bool> m_written;
+  // id of each node in the new tree, NO_NODE until emitted
+  std::vector<NodeId> m_emitted;
+  // children of the lists being emitted, innermost last
+  std::vector<NodeId> m_scratch;
+};
+
+}// namespace blang::sema
+
+#endif
@@ -0,0 +1,92 @@
+#ifndef BLANG_SEMA_SYMBOL_TABLE_HPP
+#define BLANG_SEMA_SYMBOL_TABLE_HPP
+
+#include "blang/ast.hpp"
+#include "blang/interner.hpp"
+#include "blang/sema/types.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace blang::sema {
+
+// A name bound by a declaration or parameter.
+struct Symbol
+{
+  Atom name;
+  const Type *type;
+  // the declaration or param node
+  NodeId declaration;
+  // binding of the same name this one shadows, NO_BINDING if none
+  std::uint32_t shadowed;
+  // a function with a body, rather than only a prototype
+  bool defined;
+};
+
+// Names in scope at one point of a traversal, as a single stack of bindings
+// rather than a map per scope. A scope is a watermark into that stack, so
+// opening one is a push of an integer and closing one pops exactly the
+// bindings it made. An open-addressed index from each interned name to its
+// innermost binding makes lookup one probe; a binding remembers the one it
+// shadows, which is put back when its scope closes.
+//
+// The table starts with one open scope, the global one. A table may also
+// sit on top of another that no longer changes, such as the global scope of a
+// program shared by checkers running in parallel: the first bindings of that
+// outer table are in scope below the table's own.
+class SymbolTable
+{
+public:
+  static constexpr std::uint32_t NO_BINDING = UINT32_MAX;
+
+  SymbolTable();
+  // Table over the first `visible` bindings of `outer`, which must outlive
+  // it and not change while it is used.
+  SymbolTable(const SymbolTable &outer, std::size_t visible);
+
+  void push_scope() { m_scopes.push_back(static_cast<std::uint32_t>(m_bindings.size())); }
+  void pop_scope();
+  // Open scopes, the global one included.
+  [[nodiscard]] std::size_t depth() const { return m_scopes.size(); }
+  // Bindings made so far, in the order they were made.
+  [[nodiscard]] std::size_t bindings() const { return m_bindings.size(); }
+  // Shows only the first `visible` bindings of the outer table from now on.
+  void set_visible(std::size_t visible) { m_visible = visible; }
+
+  // Innermost binding of `name`, or nullptr. Bindings are only valid until
+  // the next declare().
+  [[nodiscard]] const Symbol *find(Atom name) const;
+  // Binding of `name` in the innermost scope, or nullptr.
+  [[nodiscard]] Symbol *find_local(Atom name);
+  // Binds `name` in the innermost scope, shadowing any outer binding.
+  Symbol &declare(Atom name, const Type *type, NodeId declaration, bool defined = false);
+
+private:
+  static constexpr std::size_t MIN_CAPACITY = 64;
+
+  struct Slot
+  {
+    Atom name{ NO_ATOM };
+    // innermost binding, NO_BINDING once its last scope closed
+    std::uint32_t binding{ NO_BINDING };
+  };
+
+  [[nodiscard]] std::size_t probe(Atom name) const;
+  // Innermost of the first `visible` bindings of `name`, or NO_BINDING.
+  [[nodiscard]] std::uint32_t binding(Atom name, std::size_t visible) const;
+  void grow();
+
+  const SymbolTable *m_outer{ nullptr };
+  std::size_t m_visible{ 0 };
+
+  std::vector<Symbol> m_bindings;
+  // size of m_bindings when each open scope was pushed
+  std::vector<std::uint32_t> m_scopes;
+  // slots are never removed, only unbound, so probing needs no tombstones
+  std::vector<Slot> m_slots;
+  std::size_t m_used{ 0 };
+};
+
+}// namespace blang::sema
+
+#endif
@@ -0,0 +1,149 @@
+#ifndef BLANG_SEMA_TYPE_CHECKER_HPP
+#define BLANG_SEMA_TYPE_CHECKER_HPP
+
+#include "blang/ast.hpp"
+#include "blang/error/error_reporter.hpp"
+#include "blang/interner.hpp"
+#include "blang/sema/symbol_table.hpp"
+#include "blang/sema/types.hpp"
+#include "blang/token_stream.hpp"
+#include "blang/util/thread_pool.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace blang::sema {
+
+// Resolves names and checks types of a parsed program in one traversal of
+// its tree. Names are looked up by atom in a SymbolTable as their uses are
+// reached, so a name is in scope from its declaration to the end of the
+// enclosing block; a function is in scope in its own body, and a prototype
+// may be declared any number of times with the same type before it is
+// defined once.
+//
+// Every expression gets an interned Type and every variable the declaration
+// it refers to, kept in arrays indexed by NodeId. An expression that fails to
+// check has the error type, which any expression over it accepts silently,
+// so one mistake is reported once.
+//
+// A tree whose pure subtrees are shared is checked like the plain one: a
+// shared node is visited under each of its parents and gets the same results
+// every time, since the parser ends the sharing of variable reads at the end
+// of every block and around every function body, so a shared read resolves
+// to one declaration wherever it occurs.
+//
+// Function bodies only see the global scope as it was where the function is
+// declared, so once the global declarations have been checked every body can
+// be checked on its own. check(pool) does that: a serial pass over the
+// top-level statements that defers the bodies, then the bodies in batches on
+// the pool, each batch with a symbol table and stacks of its own over the
+// frozen global scope. Diagnostics go to the reporter's per-thread buffers,
+// which it merges in source order, so the result is the same as check()'s.
+class TypeChecker
+{
+public:
+  // `interner` is the one `tokens` was scanned with, if any; identifiers
+  // without an atom are interned into it.
+  TypeChecker(const TokenStream &tokens,
+    const Ast &ast,
+    TypeTable &types,
+    Interner &interner,
+    error::ErrorReporter &reporter);
+
+  // Checks every root; true when nothing was reported.
+  bool check();
+  // Same, checking function bodies on `pool`.
+  bool check(util::ThreadPool &pool);
+
+  // Type of an expression or declared name, nullptr for anything else.
+  [[nodiscard]] const Type *type(NodeId node) const { return m_types[node]; }
+  // Declaration or param a variable refers to, NO_NODE when undeclared. For
+  // a function declared before it is defined, the first declaration.
+  [[nodiscard]] NodeId declaration(NodeId node) const { return m_declarations[node]; }
+
+private:
+  // Batches per pool thread, enough for stealing to even out their sizes.
+  static constexpr std::size_t BATCHES_PER_THREAD = 8;
+
+  // A top-level function whose body check(pool) defers.
+  struct DeferredBody
+  {
+    NodeId declaration;
+    // global bindings in scope in the body
+    std::size_t visible;
+  };
+
+  // Checker of a batch of deferred bodies, over `parent`'s global scope and
+  // writing to its results.
+  explicit TypeChecker(const TypeChecker &parent);
+
+  // Results may be written from several threads at once for a node shared by
+  // bodies in different batches, which has no variable reads under it, as
+  // those are never shared across a function body; each writes the same value.
+  void record_type(NodeId node, const Type *type)
+  {
+    std::atomic_ref{ m_types[node] }.store(type, std::memory_order_relaxed);
+  }
+  void record_declaration(NodeId node, NodeId declaration)
+  {
+    std::atomic_ref{ m_declarations[node] }.store(declaration, std::memory_order_relaxed);
+  }
+  bool check_bodies(std::span<const DeferredBody> bodies);
+  void report(NodeId node, error::DiagnosticCode code, std::initializer_list<std::string_view> args = {});
+  [[nodiscard]] Atom name(NodeId node);
+
+  void statement(NodeId node);
+  void block(NodeId node);
+  // The body of an if, while or for, which has a scope of its own even when
+  // it is a lone declaration rather than a block.
+  void body(NodeId node);
+  void declaration_stmt(NodeId node);
+  void function_body(NodeId node, const Type *type, NodeId body);
+  void condition(NodeId node);
+  // Checks an initializer list against the array type it initializes.
+  void init_list(NodeId node, const Type *type);
+  const Type *type_spec(NodeId node);
+
+  const Type *expression(NodeId node);
+  const Type *binary(NodeId node);
+  const Type *call(NodeId node);
+  // Reports unless `found` is `expected` or either is the error type.
+  void expect(NodeId node, const Type *expected, const Type *found, std::string_view where);
+  // Reports `node`, an operand of the operator at `op`, unless `found` is
+  // `expected` or the error type.
+  void operand(NodeId op, NodeId node, const Type *expected, const Type *found);
+  // Whether a variable, parameter or array element may have `type`.
+  [[nodiscard]] static bool storable(const Type *type);
+  // Whether values of `type` are printed, compared and assigned whole.
+  [[nodiscard]] static bool scalar(const Type *type);
+
+  const TokenStream *m_tokens;
+  const Ast *m_ast;
+  TypeTable *m_table;
+  Interner *m_interner;
+  error::ErrorReporter *m_reporter;
+  std::optional<error::FileId> m_file;
+  SymbolTable m_symbols;
+  std::vector<const Type *> m_type_storage;
+  std::vector<NodeId> m_declaration_storage;
+  // the storage above, or the parent checker's
+  std::span<const Type *> m_types;
+  std::span<NodeId> m_declarations;
+  // top-level function bodies left for later, when deferring
+  std::vector<DeferredBody> m_deferred;
+  bool m_defer{ false };
+  // return types of the functions being checked, innermost last
+  std::vector<const Type *> m_returns;
+  // parameter types of the function type being resolved
+  std::vector<const Type *> m_params;
+  bool m_failed{ false };
+};
+
+}// namespace blang::sema
+
+#endif
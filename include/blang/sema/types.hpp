@@ -0,0 +1,102 @@
+#ifndef BLANG_SEMA_TYPES_HPP
+#define BLANG_SEMA_TYPES_HPP
+
+#include "blang/mem/arena.hpp"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <shared_mutex>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace blang::sema {
+
+enum class TypeKind : std::uint8_t { t_error, t_void, t_boolean, t_char, t_integer, t_string, t_array, t_function };
+
+// A B-minor type. Types are interned by a TypeTable, so two types are the
+// same exactly when their pointers are. The error type stands in for the type
+// of anything that already failed to check, so one mistake is reported once.
+//
+// Array types do not include their size: an `array [] integer` parameter
+// takes any array of integers.
+struct Type
+{
+  TypeKind kind;
+  // element type of an array, return type of a function
+  const Type *inner;
+  // parameter types of a function
+  std::span<const Type *const> params;
+};
+
+// Every type of one compilation, allocated in an arena of its own and
+// interned on construction. Several checkers may make types at once: lookups
+// of types already made only take a shared lock.
+class TypeTable
+{
+public:
+  TypeTable();
+  TypeTable(const TypeTable &) = delete;
+  TypeTable(TypeTable &&) = delete;
+  TypeTable &operator=(const TypeTable &) = delete;
+  TypeTable &operator=(TypeTable &&) = delete;
+  ~TypeTable() = default;
+
+  // `kind` is any kind but t_array and t_function.
+  [[nodiscard]] const Type *primitive(TypeKind kind) const { return &m_primitives.at(static_cast<std::size_t>(kind)); }
+  [[nodiscard]] const Type *error() const { return primitive(TypeKind::t_error); }
+  [[nodiscard]] const Type *integer() const { return primitive(TypeKind::t_integer); }
+  [[nodiscard]] const Type *boolean() const { return primitive(TypeKind::t_boolean); }
+  const Type *array(const Type *element);
+  const Type *function(const Type *returns, std::span<const Type *const> params);
+
+  // Distinct types made so far, primitives included.
+  [[nodiscard]] std::size_t size() const;
+
+private:
+  static constexpr std::size_t PRIMITIVE_COUNT = 6;
+  static constexpr std::size_t PAGE_SIZE = std::size_t{ 4 } << 10U;
+
+  // A function type to look up, without making one.
+  struct Signature
+  {
+    const Type *returns;
+    std::span<const Type *const> params;
+  };
+
+  // Function types hash and compare by signature, so the set is searched
+  // with a Signature and no key is built for a lookup.
+  struct SignatureHash
+  {
+    using is_transparent = void;
+    std::size_t operator()(const Signature &signature) const;
+    std::size_t operator()(const Type *type) const { return (*this)(Signature{ type->inner, type->params }); }
+  };
+
+  struct SignatureEqual
+  {
+    using is_transparent = void;
+    static Signature of(const Signature &signature) { return signature; }
+    static Signature of(const Type *type) { return Signature{ type->inner, type->params }; }
+    template<typename L, typename R> bool operator()(const L &lhs, const R &rhs) const
+    {
+      return equal(of(lhs), of(rhs));
+    }
+    static bool equal(const Signature &lhs, const Signature &rhs);
+  };
+
+  mutable std::shared_mutex m_mutex;
+  mem::Arena m_arena{ PAGE_SIZE };
+  std::array<Type, PRIMITIVE_COUNT> m_primitives;
+  std::unordered_map<const Type *, const Type *> m_arrays;
+  std::unordered_set<const Type *, SignatureHash, SignatureEqual> m_functions;
+};
+
+// Spelling of a type as it is written in B-minor, such as
+// "function integer (array [] integer, char)".
+[[nodiscard]] std::string type_name(const Type *type);
+
+}// namespace blang::sema
+
+#endif
@@ -0,0 +1,55 @@
+#ifndef BLANG_SESSION_HPP
+#define BLANG_SESSION_HPP
+
+#include "blang/ast.hpp"
+#include "blang/error/error_reporter.hpp"
+#include "blang/mem/arena.hpp"
+#include "blang/source_buffer.hpp"
+#include "blang/token_stream.hpp"
+#include <cstddef>
+#include <optional>
+#include <string_view>
+
+namespace blang {
+
+// One compilation, or one line of a REPL: the arena its phases allocate from
+// and the reporter its diagnostics go to. Source text, token columns and
+// syntax trees made through the session live in the arena, so reset() ends
+// the compilation in one go instead of freeing everything piece by piece.
+//
+// Everything the session handed out is invalid after reset(), including
+// token streams and trees still in scope: they may be destroyed, since
+// giving memory back to the arena is a no-op, but must not be used.
+class Session
+{
+public:
+  explicit Session(std::size_t page_size = mem::DEFAULT_PAGE_SIZE, std::size_t max_errors = error::DEFAULT_MAX_ERRORS);
+  Session(const Session &) = delete;
+  Session(Session &&) = delete;
+  Session &operator=(const Session &) = delete;
+  Session &operator=(Session &&) = delete;
+  ~Session() = default;
+
+  [[nodiscard]] mem::Arena &arena() { return m_arena; }
+  [[nodiscard]] error::ErrorReporter &reporter() { return *m_reporter; }
+
+  // Copies `text` into the arena and returns a buffer borrowing the copy.
+  SourceBuffer add_source(std::string_view text);
+  // Scans `source` into a stream whose columns are in the arena.
+  TokenStream scan(const SourceBuffer &source);
+  // Parses `tokens` as a program into a tree in the arena.
+  Ast parse_program(const TokenStream &tokens);
+
+  // Drops everything allocated for this compilation and starts a fresh
+  // reporter, whose sources would otherwise point into released memory.
+  void reset();
+
+private:
+  std::size_t m_max_errors;
+  mem::Arena m_arena;
+  std::optional<error::ErrorReporter> m_reporter;
+};
+
+}// namespace blang
+
+#endif
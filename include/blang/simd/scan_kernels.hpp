@@ -0,0 +1,75 @@
+#ifndef BLANG_SIMD_SCAN_KERNELS_HPP
+#define BLANG_SIMD_SCAN_KERNELS_HPP
+
+#include <array>
+#include <cstddef>
+#include <string_view>
+
+namespace blang::simd {
+
+// Byte classes used by the scanner, looked up from a constant table instead
+// of going through <locale> on every character.
+enum CharClass : unsigned char {
+  c_none = 0,
+  c_alpha = 1U << 0U,
+  c_digit = 1U << 1U,
+  c_underscore = 1U << 2U,
+  c_blank = 1U << 3U,
+  c_hex_digit = 1U << 4U,
+};
+
+constexpr std::array<unsigned char, 256> CHAR_CLASSES = [] {
+  std::array<unsigned char, 256> table{};
+  for (char chh = 'a'; chh <= 'z'; ++chh) { table.at(static_cast<unsigned char>(chh)) = c_alpha; }
+  for (char chh = 'A'; chh <= 'Z'; ++chh) { table.at(static_cast<unsigned char>(chh)) = c_alpha; }
+  for (char chh = '0'; chh <= '9'; ++chh) { table.at(static_cast<unsigned char>(chh)) = c_digit; }
+  for (char chh = '0'; chh <= '9'; ++chh) { table.at(static_cast<unsigned char>(chh)) |= c_hex_digit; }
+  for (char chh = 'a'; chh <= 'f'; ++chh) { table.at(static_cast<unsigned char>(chh)) |= c_hex_digit; }
+  for (char chh = 'A'; chh <= 'F'; ++chh) { table.at(static_cast<unsigned char>(chh)) |= c_hex_digit; }
+  table.at('_') = c_underscore;
+  table.at(' ') = c_blank;
+  table.at('\n') = c_blank;
+  return table;
+}();
+
+constexpr bool has_class(char chh, unsigned classes)
+{
+  return (CHAR_CLASSES[static_cast<unsigned char>(chh)] & classes) != 0U;// NOLINT
+}
+constexpr bool is_identifier_start(char chh) { return has_class(chh, c_alpha | c_underscore); }
+constexpr bool is_identifier_char(char chh) { return has_class(chh, c_alpha | c_underscore | c_digit); }
+constexpr bool is_digit(char chh) { return has_class(chh, c_digit); }
+constexpr bool is_alpha(char chh) { return has_class(chh, c_alpha); }
+constexpr bool is_hex_digit(char chh) { return has_class(chh, c_hex_digit); }
+
+enum class Isa { scalar, sse2, avx2 };
+
+// Kernels over the byte range [first, last). Each returns a pointer into the
+// range, or `last` when the range runs out first.
+struct ScanKernels
+{
+  // End of a run of ' ' and '\n'.
+  const char *(*skip_whitespace)(const char *first, const char *last);
+  // End of a run of [A-Za-z0-9_].
+  const char *(*identifier_end)(const char *first, const char *last);
+  // End of a run of [0-9].
+  const char *(*digits_end)(const char *first, const char *last);
+  // First occurrence of `byte`.
+  const char *(*find_byte)(const char *first, const char *last, char byte);
+  // Number of occurrences of `byte`.
+  std::size_t (*count_byte)(const char *first, const char *last, char byte);
+  // The '*' of the first "*/".
+  const char *(*find_comment_end)(const char *first, const char *last);
+  Isa isa;
+};
+
+// The best kernels for the running CPU, picked on first use.
+const ScanKernels &kernels();
+// Kernels for a specific instruction set, falling back to the best supported
+// one at or below it; used to compare implementations against each other.
+const ScanKernels &kernels_for(Isa isa);
+std::string_view isa_name(Isa isa);
+
+}// namespace blang::simd
+
+#endif
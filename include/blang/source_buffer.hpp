@@ -0,0 +1,70 @@
+#ifndef BLANG_SOURCE_BUFFER_HPP
+#define BLANG_SOURCE_BUFFER_HPP
+
+#include "blang/line_table.hpp"
+#include <cstddef>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace blang {
+
+// Replacement of `removed` bytes at `offset` by `inserted`, as sent by an
+// editor on every keystroke.
+struct TextEdit
+{
+  std::size_t offset;
+  std::size_t removed;
+  std::string inserted;
+};
+
+// Read-only bytes of one source file. The buffer either owns its bytes (read
+// from a file or moved in from a string) or borrows them from the caller, in
+// which case the caller must keep them alive for as long as the buffer and any
+// token referring to it. Copies are cheap and share the same bytes, and the
+// line table, which is only built the first time a position is resolved.
+class SourceBuffer
+{
+public:
+  SourceBuffer() = default;
+  explicit SourceBuffer(std::string source)
+    : m_storage(std::make_shared<const std::string>(std::move(source))), m_view(*m_storage),
+      m_lines(std::make_shared<LazyLines>())
+  {}
+
+  [[nodiscard]] static SourceBuffer borrow(std::string_view source);
+  // Borrows `source` together with a line table built for it beforehand.
+  [[nodiscard]] static SourceBuffer borrow(std::string_view source, LineTable lines);
+  [[nodiscard]] static std::optional<SourceBuffer> from_file(const std::filesystem::path &path);
+
+  [[nodiscard]] std::string_view view() const { return m_view; }
+  [[nodiscard]] const char *data() const { return m_view.data(); }
+  [[nodiscard]] std::size_t size() const { return m_view.size(); }
+  [[nodiscard]] bool owns_bytes() const { return m_storage != nullptr; }
+
+  // Returns the bytes in [offset, offset + length), clamped to the buffer.
+  [[nodiscard]] std::string_view slice(std::size_t offset, std::size_t length) const;
+  [[nodiscard]] const LineTable &lines() const;
+  [[nodiscard]] SourceLocation locate(std::size_t offset) const { return lines().locate(offset); }
+  // Returns an owning copy of the bytes with `edit` applied, the edited range
+  // clamped to the buffer.
+  [[nodiscard]] SourceBuffer edited(const TextEdit &edit) const;
+
+private:
+  struct LazyLines
+  {
+    std::once_flag built;
+    LineTable table;
+  };
+
+  std::shared_ptr<const std::string> m_storage;
+  std::string_view m_view;
+  std::shared_ptr<LazyLines> m_lines;
+};
+
+}// namespace blang
+
+#endif
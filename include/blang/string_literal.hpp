@@ -0,0 +1,49 @@
+#ifndef BLANG_STRING_LITERAL_HPP
+#define BLANG_STRING_LITERAL_HPP
+
+#include "blang/simd/scan_kernels.hpp"
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace blang {
+
+// String and char literals may hold the escapes \n \t \\ \" \' \0 and \xNN
+// (exactly two hex digits). The value of a string literal is its body with
+// escapes decoded and raw newlines dropped; a body with neither is its own
+// value, so it is handed out as a slice of the source and never copied.
+
+// Closing `quote` of the literal whose body starts at `first`, or `last` when
+// it is unterminated. A quote behind a backslash does not close the literal.
+// `escaped` is set when the body holds a backslash.
+const char *quoted_literal_end(const char *first,
+  const char *last,
+  char quote,
+  bool &escaped,
+  const simd::ScanKernels &kernels);
+
+// Bytes taken by the escape sequence at the front of `text`, which must be a
+// backslash, and 0 when it is not a valid escape.
+std::size_t escape_length(std::string_view text);
+
+// Offset of the first invalid escape sequence in a literal body, npos when
+// they are all valid.
+std::size_t find_invalid_escape(std::string_view body);
+
+// Whether the body differs from its value, and has to be decoded.
+bool literal_needs_decoding(std::string_view body);
+
+// Value of a literal body, decoded into a fresh string.
+std::string decode_literal(std::string_view body);
+
+// Value of a literal body without a copy when it needs no decoding; otherwise
+// the body is decoded into `scratch`, reusing its capacity, and the view
+// refers to it.
+std::string_view literal_value(std::string_view body, std::string &scratch);
+
+// Value of a char literal body, a single byte or a single escape.
+char decode_char_literal(std::string_view body);
+
+}// namespace blang
+
+#endif
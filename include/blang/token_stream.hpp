@@ -0,0 +1,237 @@
+#ifndef BLANG_TOKEN_STREAM_HPP
+#define BLANG_TOKEN_STREAM_HPP
+
+#include "blang/interner.hpp"
+#include "blang/source_buffer.hpp"
+#include "blang/token_type.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory_resource>
+#include <span>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+namespace blang {
+
+using value_object = std::variant<std::int64_t, std::string, char>;
+
+constexpr int NOT_IDENTIFIED_EXIT = 64;
+
+// Token type struct to encapsulate all the attributes. This is the
+// materialized form of a token, the scanner itself only records Lexemes.
+struct Token
+{
+  TokenType type;
+  std::size_t position;
+  int line;
+  value_object value;
+};
+
+// A token as the scanner records it: its type and the byte range of its
+// lexeme in the source buffer. The eof lexeme covers one virtual byte past the
+// end of the source. Values and lines are only resolved when asked for.
+struct Lexeme
+{
+  TokenType type;
+  std::uint32_t offset;
+  std::uint32_t length;
+};
+
+// Value of a token, read from its lexeme: integer literals are parsed (0 when
+// out of range), string and char literals have their escapes decoded,
+// single-byte punctuation is a char and anything else is its text.
+value_object derive_value(TokenType type, std::string_view lexeme);
+
+// Read-only view of a token stream's columns. `atoms` is either empty or as
+// long as the others.
+struct TokenColumns
+{
+  std::span<const TokenType> types;
+  std::span<const std::uint32_t> offsets;
+  std::span<const std::uint32_t> lengths;
+  std::span<const Atom> atoms;
+};
+
+// Structure-of-arrays container for the tokens of one source buffer. Every
+// token costs a 1-byte type, a 32-bit offset and a 32-bit length; lines come
+// from the source's line table on demand and literal values are decoded from
+// the source when asked for. Streams scanned with an interner add a 32-bit
+// atom column. The columns come from the memory resource the stream was
+// created with, the global heap unless it was given a session arena, or are
+// borrowed from a loaded module, in which case the first change copies them.
+class TokenStream
+{
+public:
+  class const_iterator
+  {
+  public:
+    using iterator_category = std::random_access_iterator_tag;
+    using iterator_concept = std::random_access_iterator_tag;
+    using value_type = Lexeme;
+    using difference_type = std::ptrdiff_t;
+    using reference = Lexeme;
+    using pointer = void;
+
+    const_iterator() = default;
+    const_iterator(const TokenStream *stream, std::size_t index) : m_stream(stream), m_index(index) {}
+
+    Lexeme operator*() const { return (*m_stream)[m_index]; }
+    Lexeme operator[](difference_type offset) const { return (*m_stream)[advance(offset)]; }
+    [[nodiscard]] std::size_t index() const { return m_index; }
+
+    const_iterator &operator++()
+    {
+      ++m_index;
+      return *this;
+    }
+    const_iterator operator++(int)
+    {
+      const_iterator old{ *this };
+      ++m_index;
+      return old;
+    }
+    const_iterator &operator--()
+    {
+      --m_index;
+      return *this;
+    }
+    const_iterator operator--(int)
+    {
+      const_iterator old{ *this };
+      --m_index;
+      return old;
+    }
+    const_iterator &operator+=(difference_type offset)
+    {
+      m_index = advance(offset);
+      return *this;
+    }
+    const_iterator &operator-=(difference_type offset)
+    {
+      m_index = advance(-offset);
+      return *this;
+    }
+    friend const_iterator operator+(const_iterator iter, difference_type offset) { return iter += offset; }
+    friend const_iterator operator+(difference_type offset, const_iterator iter) { return iter += offset; }
+    friend const_iterator operator-(const_iterator iter, difference_type offset) { return iter -= offset; }
+    friend difference_type operator-(const const_iterator &lhs, const const_iterator &rhs)
+    {
+      return static_cast<difference_type>(lhs.m_index) - static_cast<difference_type>(rhs.m_index);
+    }
+    friend bool operator==(const const_iterator &lhs, const const_iterator &rhs) { return lhs.m_index == rhs.m_index; }
+    friend auto operator<=>(const const_iterator &lhs, const const_iterator &rhs)
+    {
+      return lhs.m_index <=> rhs.m_index;
+    }
+
+  private:
+    [[nodiscard]] std::size_t advance(difference_type offset) const
+    {
+      return static_cast<std::size_t>(static_cast<difference_type>(m_index) + offset);
+    }
+
+    const TokenStream *m_stream{ nullptr };
+    std::size_t m_index{ 0 };
+  };
+
+  TokenStream() = default;
+  explicit TokenStream(SourceBuffer source, std::pmr::memory_resource *resource = std::pmr::get_default_resource())
+    : m_source(std::move(source)), m_types(resource), m_offsets(resource), m_lengths(resource), m_atoms(resource)
+  {}
+  TokenStream(const TokenStream &other);
+  TokenStream(TokenStream &&other) noexcept;
+  TokenStream &operator=(const TokenStream &other);
+  TokenStream &operator=(TokenStream &&other) noexcept;
+  ~TokenStream() = default;
+
+  // Stream over `columns`, which must outlive it and every copy of it.
+  [[nodiscard]] static TokenStream borrow(SourceBuffer source, TokenColumns columns);
+
+  void reserve(std::size_t count);
+  void push_back(const Lexeme &lexeme)
+  {
+    if (m_borrowed) { own(); }
+    m_types.push_back(lexeme.type);
+    m_offsets.push_back(lexeme.offset);
+    m_lengths.push_back(lexeme.length);
+    m_view.types = m_types;
+    m_view.offsets = m_offsets;
+    m_view.lengths = m_lengths;
+  }
+  void set_atom(Atom atom);
+  // Appends tokens [first, other.size()) of a stream over the same source,
+  // atoms included.
+  void append(const TokenStream &other, std::size_t first);
+  // Replaces tokens [first, last) by all of `replacement`, a stream over the
+  // edited source which this stream then refers to. Tokens after the replaced
+  // range are shifted by `offset_delta` in place, so the cost is a move of the
+  // tail rather than a copy of the stream.
+  void splice(std::size_t first, std::size_t last, TokenStream &&replacement, std::int64_t offset_delta);
+  void shrink_to_fit();
+
+  [[nodiscard]] std::size_t size() const { return m_view.types.size(); }
+  [[nodiscard]] bool empty() const { return m_view.types.empty(); }
+  [[nodiscard]] const_iterator begin() const { return { this, 0 }; }
+  [[nodiscard]] const_iterator end() const { return { this, size() }; }
+
+  [[nodiscard]] Lexeme operator[](std::size_t index) const
+  {
+    return Lexeme{ m_view.types[index], m_view.offsets[index], m_view.lengths[index] };
+  }
+  [[nodiscard]] TokenType type(std::size_t index) const { return m_view.types[index]; }
+  [[nodiscard]] std::uint32_t offset(std::size_t index) const { return m_view.offsets[index]; }
+  [[nodiscard]] std::uint32_t length(std::size_t index) const { return m_view.lengths[index]; }
+  // Line of the token's last byte, so a string spanning lines is on the line
+  // it is closed on.
+  [[nodiscard]] int line(std::size_t index) const
+  {
+    return m_source.lines().line(m_view.offsets[index] + std::size_t{ m_view.lengths[index] } - 1);
+  }
+  // Line and column of the token's first byte.
+  [[nodiscard]] SourceLocation location(std::size_t index) const { return m_source.locate(m_view.offsets[index]); }
+
+  [[nodiscard]] const SourceBuffer &source() const { return m_source; }
+  [[nodiscard]] std::string_view text(std::size_t index) const;
+  // Value of the string literal at `index`: a slice of the source when it has
+  // no escapes or newlines, otherwise decoded into `scratch`.
+  [[nodiscard]] std::string_view literal(std::size_t index, std::string &scratch) const;
+  // Interned identifier or string value, NO_ATOM when scanned without an
+  // interner or for any other kind of token.
+  [[nodiscard]] Atom atom(std::size_t index) const
+  {
+    return index < m_view.atoms.size() ? m_view.atoms[index] : NO_ATOM;
+  }
+  [[nodiscard]] const TokenColumns &columns() const { return m_view; }
+  [[nodiscard]] bool borrowed() const { return m_borrowed; }
+  [[nodiscard]] value_object value(std::size_t index) const;
+  [[nodiscard]] Token token(std::size_t index) const;
+  [[nodiscard]] std::vector<Token> materialize() const;
+
+  // Bytes held by the stream's own arrays (capacity, not size), excluding the
+  // source buffer and borrowed columns.
+  [[nodiscard]] std::size_t memory_usage() const;
+  [[nodiscard]] double bytes_per_token() const;
+
+private:
+  // Points the view back at the stream's own columns after they changed.
+  void sync() { m_view = TokenColumns{ m_types, m_offsets, m_lengths, m_atoms }; }
+  // Copies borrowed columns into the stream's own.
+  void own();
+
+  SourceBuffer m_source;
+  std::pmr::vector<TokenType> m_types;
+  std::pmr::vector<std::uint32_t> m_offsets;
+  std::pmr::vector<std::uint32_t> m_lengths;
+  // only allocated once the first atom is set
+  std::pmr::vector<Atom> m_atoms;
+  // what the accessors read: the columns above, or borrowed ones
+  TokenColumns m_view;
+  bool m_borrowed{ false };
+};
+
+}// namespace blang
+
+#endif
@@ -1,10 +1,12 @@
 #ifndef BLANG_TOKEN_TYPE_HPP
 #define BLANG_TOKEN_TYPE_HPP
 
+#include <cstdint>
+
 namespace blang {
 
 // Enum class for a list of available tokens to be scanned
-enum class TokenType {
+enum class TokenType : std::uint8_t {
   t_array,
   t_boolean,
   t_char,
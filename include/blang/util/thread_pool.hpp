@@ -0,0 +1,74 @@
+#ifndef BLANG_UTIL_THREAD_POOL_HPP
+#define BLANG_UTIL_THREAD_POOL_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace blang::util {
+
+// Fixed set of worker threads with a deque of jobs each. A worker takes its
+// newest job first and, once its own deque is empty, steals the oldest job of
+// another, so uneven jobs spread over the pool without a queue every worker
+// contends on. Jobs submitted from a worker go to its own deque; jobs from
+// any other thread are dealt round-robin.
+class ThreadPool
+{
+public:
+  // Zero threads means one per hardware thread.
+  explicit ThreadPool(std::size_t threads = 0);
+  ThreadPool(const ThreadPool &) = delete;
+  ThreadPool &operator=(const ThreadPool &) = delete;
+  ThreadPool(ThreadPool &&) = delete;
+  ThreadPool &operator=(ThreadPool &&) = delete;
+  ~ThreadPool();
+
+  [[nodiscard]] std::size_t size() const { return m_workers.size(); }
+  // Jobs taken from another worker's deque so far.
+  [[nodiscard]] std::size_t steals() const { return m_steals.load(std::memory_order_relaxed); }
+
+  template<typename F> auto submit(F task) -> std::future<std::invoke_result_t<F>>
+  {
+    using result_type = std::invoke_result_t<F>;
+    auto packaged = std::make_shared<std::packaged_task<result_type()>>(std::move(task));
+    std::future<result_type> result{ packaged->get_future() };
+    enqueue([packaged] { (*packaged)(); });
+    return result;
+  }
+
+private:
+  struct Queue
+  {
+    std::mutex mutex;
+    std::deque<std::function<void()>> jobs;
+  };
+
+  void enqueue(std::function<void()> job);
+  // The newest job of worker `index`'s own deque, or else the oldest of
+  // another's.
+  std::optional<std::function<void()>> take(std::size_t index);
+  void work(std::size_t index);
+
+  std::vector<std::unique_ptr<Queue>> m_queues;
+  std::vector<std::thread> m_workers;
+  // jobs submitted and not yet taken, which idle workers sleep until there are
+  std::atomic<std::size_t> m_pending{ 0 };
+  std::atomic<std::size_t> m_next{ 0 };
+  std::atomic<std::size_t> m_steals{ 0 };
+  // bumped after every submission and at shutdown; idle workers wait on it
+  std::atomic<std::uint32_t> m_wakeups{ 0 };
+  std::atomic<bool> m_stopping{ false };
+};
+
+}// namespace blang::util
+
+#endif
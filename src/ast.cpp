@@ -0,0 +1,143 @@
+#include "blang/ast.hpp"
+#include <utility>
+
+namespace blang {
+
+Ast::Ast(const Ast &other)
+  : m_kinds(other.m_kinds), m_tokens(other.m_tokens), m_lhs(other.m_lhs), m_rhs(other.m_rhs), m_extra(other.m_extra),
+    m_roots(other.m_roots), m_view(other.m_view), m_borrowed(other.m_borrowed)
+{
+  if (!m_borrowed) { sync(); }
+}
+
+Ast::Ast(Ast &&other) noexcept
+  : m_kinds(std::move(other.m_kinds)), m_tokens(std::move(other.m_tokens)), m_lhs(std::move(other.m_lhs)),
+    m_rhs(std::move(other.m_rhs)), m_extra(std::move(other.m_extra)), m_roots(std::move(other.m_roots)),
+    m_view(std::exchange(other.m_view, {})), m_borrowed(std::exchange(other.m_borrowed, false))
+{
+  if (!m_borrowed) { sync(); }
+}
+
+Ast &Ast::operator=(const Ast &other)
+{
+  if (this != &other) {
+    m_kinds = other.m_kinds;
+    m_tokens = other.m_tokens;
+    m_lhs = other.m_lhs;
+    m_rhs = other.m_rhs;
+    m_extra = other.m_extra;
+    m_roots = other.m_roots;
+    m_view = other.m_view;
+    m_borrowed = other.m_borrowed;
+    if (!m_borrowed) { sync(); }
+  }
+  return *this;
+}
+
+Ast &Ast::operator=(Ast &&other) noexcept
+{
+  if (this != &other) {
+    m_kinds = std::move(other.m_kinds);
+    m_tokens = std::move(other.m_tokens);
+    m_lhs = std::move(other.m_lhs);
+    m_rhs = std::move(other.m_rhs);
+    m_extra = std::move(other.m_extra);
+    m_roots = std::move(other.m_roots);
+    m_view = std::exchange(other.m_view, {});
+    m_borrowed = std::exchange(other.m_borrowed, false);
+    // arrays moved between different resources are copied, so the view is
+    // always rebuilt from them
+    if (!m_borrowed) { sync(); }
+  }
+  return *this;
+}
+
+Ast Ast::borrow(AstColumns columns)
+{
+  Ast ast{};
+  ast.m_view = columns;
+  ast.m_borrowed = true;
+  return ast;
+}
+
+void Ast::own()
+{
+  m_kinds.assign(m_view.kinds.begin(), m_view.kinds.end());
+  m_tokens.assign(m_view.tokens.begin(), m_view.tokens.end());
+  m_lhs.assign(m_view.lhs.begin(), m_view.lhs.end());
+  m_rhs.assign(m_view.rhs.begin(), m_view.rhs.end());
+  m_extra.assign(m_view.extra.begin(), m_view.extra.end());
+  m_roots.assign(m_view.roots.begin(), m_view.roots.end());
+  m_borrowed = false;
+  sync();
+}
+
+void Ast::reserve(std::size_t nodes)
+{
+  if (m_borrowed) { own(); }
+  m_kinds.reserve(nodes);
+  m_tokens.reserve(nodes);
+  m_lhs.reserve(nodes);
+  m_rhs.reserve(nodes);
+  sync();
+}
+
+NodeId Ast::add(NodeKind kind, std::size_t token, NodeId lhs, NodeId rhs)
+{
+  if (m_borrowed) { own(); }
+  const auto node{ static_cast<NodeId>(m_kinds.size()) };
+  m_kinds.push_back(kind);
+  m_tokens.push_back(static_cast<std::uint32_t>(token));
+  m_lhs.push_back(lhs);
+  m_rhs.push_back(rhs);
+  m_view.kinds = m_kinds;
+  m_view.tokens = m_tokens;
+  m_view.lhs = m_lhs;
+  m_view.rhs = m_rhs;
+  return node;
+}
+
+std::uint32_t Ast::add_extra(std::span<const NodeId> children)
+{
+  if (m_borrowed) { own(); }
+  const auto index{ static_cast<std::uint32_t>(m_extra.size()) };
+  m_extra.insert(m_extra.end(), children.begin(), children.end());
+  m_view.extra = m_extra;
+  return index;
+}
+
+std::uint32_t Ast::add_list(std::span<const NodeId> items)
+{
+  if (m_borrowed) { own(); }
+  const auto index{ static_cast<std::uint32_t>(m_extra.size()) };
+  m_extra.push_back(static_cast<NodeId>(items.size()));
+  m_extra.insert(m_extra.end(), items.begin(), items.end());
+  m_view.extra = m_extra;
+  return index;
+}
+
+void Ast::add_root(NodeId node)
+{
+  if (m_borrowed) { own(); }
+  m_roots.push_back(node);
+  m_view.roots = m_roots;
+}
+
+void Ast::truncate(std::size_t nodes, std::size_t extra)
+{
+  if (m_borrowed) { own(); }
+  m_kinds.resize(nodes);
+  m_tokens.resize(nodes);
+  m_lhs.resize(nodes);
+  m_rhs.resize(nodes);
+  m_extra.resize(extra);
+  sync();
+}
+
+std::size_t Ast::memory_usage() const
+{
+  return m_kinds.capacity() * sizeof(NodeKind) + m_tokens.capacity() * sizeof(std::uint32_t)
+         + (m_lhs.capacity() + m_rhs.capacity() + m_extra.capacity() + m_roots.capacity()) * sizeof(NodeId);
+}
+
+}// namespace blang
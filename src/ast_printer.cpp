@@ -0,0 +1,119 @@
+#include "blang/ast_printer.hpp"
+#include <variant>
+
+namespace blang {
+
+std::string AstPrinter::print_roots() const
+{
+  std::string out{};
+  for (const NodeId root : m_ast->roots()) { out += print(root) + "\n"; }
+  return out;
+}
+
+std::string AstPrinter::print_optional(NodeId node) const { return node == NO_NODE ? "_" : print(node); }
+
+// Appends " child" for every node of `list` to `out`, then the closing ")".
+std::string AstPrinter::print_list(std::string out, std::uint32_t list) const
+{
+  for (const NodeId item : m_ast->list(list)) { out += " " + print(item); }
+  return out + ")";
+}
+
+std::string AstPrinter::print_literal(NodeId node) const
+{
+  const std::uint32_t token{ m_ast->token(node) };
+  switch (m_tokens->type(token)) {
+  case TokenType::t_string_lit: {
+    std::string scratch{};
+    return "\"" + std::string{ m_tokens->literal(token, scratch) } + "\"";
+  }
+  case TokenType::t_char_lit:
+    return "'" + std::string(1, std::get<char>(m_tokens->value(token))) + "'";
+  case TokenType::t_integer_lit:
+    return std::to_string(std::get<std::int64_t>(m_tokens->value(token)));
+  default:
+    // true and false
+    return std::string{ m_tokens->text(token) };
+  }
+}
+
+std::string AstPrinter::print(NodeId node) const
+{
+  const Ast &ast{ *m_ast };
+  const std::string spelling{ m_tokens->text(ast.token(node)) };
+  const NodeId lhs{ ast.lhs(node) };
+  const NodeId rhs{ ast.rhs(node) };
+  switch (ast.kind(node)) {
+  case NodeKind::binary:
+    return "(" + spelling + " " + print(lhs) + " " + print(rhs) + ")";
+  case NodeKind::call:
+    return print_list("(call " + print(lhs), rhs);
+  case NodeKind::grouping:
+    return "(group " + print(lhs) + ")";
+  case NodeKind::init_list: {
+    std::string out{ "{" };
+    for (const NodeId element : ast.list(rhs)) {
+      if (out.size() > 1) { out += " "; }
+      out += print(element);
+    }
+    return out + "}";
+  }
+  case NodeKind::literal:
+    return print_literal(node);
+  case NodeKind::postfix:
+    return "(post" + spelling + " " + print(lhs) + ")";
+  case NodeKind::subscript:
+    return "(index " + print(lhs) + " " + print(rhs) + ")";
+  case NodeKind::unary:
+    return "(" + spelling + " " + print(lhs) + ")";
+  case NodeKind::variable:
+    return spelling;
+  case NodeKind::integer_constant:
+    return std::to_string(ast.constant(node));
+  case NodeKind::boolean_constant:
+    return ast.constant(node) != 0 ? "true" : "false";
+
+  case NodeKind::block:
+    return print_list("(block", rhs);
+  case NodeKind::declaration: {
+    std::string out{ "(decl " + spelling + " " + print(lhs) };
+    if (ast.extra(rhs) != NO_NODE) { out += " " + print(ast.extra(rhs)); }
+    if (ast.extra(rhs + 1) != NO_NODE) { out += " " + print(ast.extra(rhs + 1)); }
+    return out + ")";
+  }
+  case NodeKind::expression_stmt:
+    return "(expr " + print(lhs) + ")";
+  case NodeKind::for_stmt:
+    return "(for " + print_optional(ast.extra(lhs)) + " " + print_optional(ast.extra(lhs + 1)) + " "
+           + print_optional(ast.extra(lhs + 2)) + " " + print(rhs) + ")";
+  case NodeKind::if_stmt: {
+    std::string out{ "(if " + print(lhs) + " " + print(ast.extra(rhs)) };
+    if (ast.extra(rhs + 1) != NO_NODE) { out += " " + print(ast.extra(rhs + 1)); }
+    return out + ")";
+  }
+  case NodeKind::print_stmt:
+    return print_list("(print", rhs);
+  case NodeKind::return_stmt:
+    return lhs == NO_NODE ? "(return)" : "(return " + print(lhs) + ")";
+  case NodeKind::while_stmt:
+    return "(while " + print(lhs) + " " + print(rhs) + ")";
+
+  case NodeKind::primitive_type:
+    return spelling;
+  case NodeKind::array_type:
+    return "(array " + (lhs == NO_NODE ? "" : print(lhs) + " ") + print(rhs) + ")";
+  case NodeKind::function_type: {
+    std::string out{ "(function " + print(lhs) + " (" };
+    for (const NodeId param : ast.list(rhs)) {
+      if (out.back() != '(') { out += " "; }
+      out += print(param);
+    }
+    return out + "))";
+  }
+  case NodeKind::param:
+    return "(" + spelling + " " + print(lhs) + ")";
+  }
+  return "";
+}
+
+}// namespace blang
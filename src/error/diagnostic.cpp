@@ -0,0 +1,78 @@
+#include "blang/error/diagnostic.hpp"
+
+namespace blang::error {
+
+Severity severity_of(DiagnosticCode /*code*/)
+{
+  // every diagnostic is an error so far
+  return Severity::error;
+}
+
+std::string_view message_template(DiagnosticCode code)
+{
+  switch (code) {
+  case DiagnosticCode::source_too_large:
+    return "Source is larger than {} bytes";
+  case DiagnosticCode::unexpected_character:
+    return "Unexpected character: {}";
+  case DiagnosticCode::unterminated_string:
+    return "Unterminated string literal, missing closing '\"'";
+  case DiagnosticCode::unterminated_comment:
+    return "Unterminated block comment, missing closing \"*/\"";
+  case DiagnosticCode::unterminated_char:
+    return "Unterminated character, missing \"'\"";
+  case DiagnosticCode::empty_char:
+    return "Empty character literal";
+  case DiagnosticCode::invalid_escape:
+    return "Invalid escape sequence in {} literal";
+  case DiagnosticCode::integer_out_of_range:
+    return "Integer literal {} does not fit in 64 bits";
+  case DiagnosticCode::expected_expression:
+    return "Expected expression";
+  case DiagnosticCode::expected_token:
+    return "Expected '{}' {}";
+  case DiagnosticCode::expected_type:
+    return "Expected a type {}";
+  case DiagnosticCode::invalid_assignment_target:
+    return "Invalid assignment target";
+  case DiagnosticCode::nesting_too_deep:
+    return "Nested too deeply";
+  case DiagnosticCode::undeclared_name:
+    return "Undeclared name '{}'";
+  case DiagnosticCode::redeclared_name:
+    return "'{}' is already declared in this scope";
+  case DiagnosticCode::type_mismatch:
+    return "Type mismatch {}: expected {}, found {}";
+  case DiagnosticCode::invalid_operand:
+    return "Invalid operand to '{}': {}";
+  case DiagnosticCode::not_callable:
+    return "Cannot call a value of type {}";
+  case DiagnosticCode::argument_count:
+    return "Expected {} arguments, found {}";
+  case DiagnosticCode::not_an_array:
+    return "Cannot subscript a value of type {}";
+  case DiagnosticCode::misplaced_return:
+    return "Return outside of a function";
+  case DiagnosticCode::invalid_declaration_type:
+    return "Cannot declare '{}' of type {}";
+  case DiagnosticCode::enclosing_local:
+    return "'{}' is a local of an enclosing function";
+  case DiagnosticCode::no_value:
+    return "{} {} {} has no value";
+  case DiagnosticCode::index_out_of_bounds:
+    return "Index {} is out of bounds for an array of {} elements";
+  case DiagnosticCode::array_size:
+    return "Array size {} is out of range";
+  case DiagnosticCode::too_many_initializers:
+    return "{} initializers for an array of {} elements";
+  case DiagnosticCode::undefined_function:
+    return "Function '{}' is called but never defined";
+  case DiagnosticCode::missing_return:
+    return "Function '{}' ended without returning a value";
+  case DiagnosticCode::call_depth:
+    return "Calls nested more than {} deep";
+  }
+  return "";
+}
+
+}// namespace blang::error
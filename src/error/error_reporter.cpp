@@ -1,27 +1,363 @@
 #include "blang/error/error_reporter.hpp"
 #include <algorithm>
+#include <array>
 #include <iostream>
+#include <thread>
 
 namespace blang::error {
 
+namespace {
+
+  constexpr std::size_t GUTTER_WIDTH = 5;
+
+  std::string_view severity_label(Severity severity)
+  {
+    switch (severity) {
+    case Severity::note:
+      return "Note";
+    case Severity::warning:
+      return "Warning";
+    case Severity::error:
+      break;
+    }
+    return "Error";
+  }
+
+  std::uint64_t next_reporter_id()
+  {
+    static std::atomic<std::uint64_t> next{ 1 };
+    return next.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  // The buffer the calling thread last reported into, and the id of its
+  // reporter. Ids are never reused, so a stale entry is never matched.
+  struct CachedBuffer
+  {
+    std::uint64_t reporter;
+    void *buffer;
+  };
+  thread_local CachedBuffer t_cached{ 0, nullptr };
+
+  // Order of diagnostics by where they point, then by code.
+  bool place_before(const Diagnostic &lhs, const Diagnostic &rhs)
+  {
+    if (lhs.file != rhs.file) { return lhs.file < rhs.file; }
+    if (lhs.span.offset != rhs.span.offset) { return lhs.span.offset < rhs.span.offset; }
+    return lhs.code < rhs.code;
+  }
+  // Same code at the same place, which is reported once.
+  bool same_place(const Diagnostic &lhs, const Diagnostic &rhs)
+  {
+    return lhs.file == rhs.file && lhs.span.offset == rhs.span.offset && lhs.code == rhs.code;
+  }
+
+  void append_line_number(std::string &out, int line)
+  {
+    const std::string number{ line > 0 ? std::to_string(line) : std::string{} };
+    out.append(GUTTER_WIDTH - std::min(GUTTER_WIDTH, number.size()), ' ');
+    out += number;
+    out += " | ";
+  }
+
+}// namespace
+
+ErrorReporter::ErrorReporter() : m_id(next_reporter_id()) {}
+
+ErrorReporter::ErrorReporter(std::size_t max_errors) : m_id(next_reporter_id()), m_max_errors(max_errors) {}
+
+FileId ErrorReporter::add_source(const SourceBuffer &source)
+{
+  std::lock_guard<std::mutex> lock{ m_mutex };
+  const auto same{ std::find_if(m_sources.begin(), m_sources.end(), [&source](const SourceBuffer &known) {
+    return known.data() == source.data() && known.size() == source.size();
+  }) };
+  if (same != m_sources.end()) { return static_cast<FileId>(same - m_sources.begin()); }
+  m_sources.push_back(source);
+  return static_cast<FileId>(m_sources.size() - 1);
+}
+
+ErrorReporter::Buffer &ErrorReporter::local_buffer()
+{
+  if (t_cached.reporter == m_id) { return *static_cast<Buffer *>(t_cached.buffer); }
+
+  // first report of this thread since it last used another reporter
+  std::lock_guard<std::mutex> lock{ m_mutex };
+  const std::thread::id self{ std::this_thread::get_id() };
+  auto found{ std::find_if(m_buffers.begin(), m_buffers.end(), [self](const std::unique_ptr<Buffer> &buffer) {
+    return buffer->owner == self;
+  }) };
+  if (found == m_buffers.end()) {
+    m_buffers.push_back(std::make_unique<Buffer>());
+    m_buffers.back()->owner = self;
+    found = m_buffers.end() - 1;
+  }
+  t_cached = CachedBuffer{ m_id, found->get() };
+  return **found;
+}
+
+void ErrorReporter::report(FileId file, DiagnosticCode code, Span span, std::initializer_list<std::string_view> args)
+{
+  report(file, code, span, std::span{ args.begin(), args.size() });
+}
+
+void ErrorReporter::report(FileId file, DiagnosticCode code, Span span, std::span<const std::string_view> args)
+{
+  const Severity severity{ severity_of(code) };
+  if (severity == Severity::error) { m_failed.store(true, std::memory_order_relaxed); }
+
+  Buffer &buffer{ local_buffer() };
+  const Diagnostic diagnostic{ code, severity, file, span, 0, static_cast<std::uint32_t>(args.size()) };
+  if (severity == Severity::error && buffer.last_kept && place_before(*buffer.last_kept, diagnostic)) {
+    buffer.reports.drop(diagnostic);
+    m_pending.fetch_add(1, std::memory_order_release);
+    return;
+  }
+
+  Reports &reports{ buffer.reports };
+  const auto first_arg{ static_cast<std::uint32_t>(reports.args.size()) };
+  for (std::string_view arg : args) {
+    reports.args.push_back(
+      Span{ static_cast<std::uint32_t>(reports.arg_bytes.size()), static_cast<std::uint32_t>(arg.size()) });
+    reports.arg_bytes += arg;
+  }
+  reports.diagnostics.push_back(diagnostic);
+  reports.diagnostics.back().first_arg = first_arg;
+  if (severity == Severity::error) { buffer.errors++; }
+
+  // settled at twice the cap, so each settle is paid for by the cap's worth
+  // of reports before it
+  if (m_max_errors != 0 && buffer.errors >= 2 * m_max_errors) {
+    reports.settle(m_max_errors);
+    buffer.errors = m_max_errors;
+    buffer.last_kept = *std::find_if(reports.diagnostics.rbegin(),
+      reports.diagnostics.rend(),
+      [](const Diagnostic &kept) { return kept.severity == Severity::error; });
+  }
+  m_pending.fetch_add(1, std::memory_order_release);
+}
+
+void ErrorReporter::report_from(const ErrorReporter &other, const Diagnostic &diagnostic, FileId file)
+{
+  std::array<std::string_view, MAX_DIAGNOSTIC_ARGS> args{};
+  const std::size_t count{ std::min<std::size_t>(diagnostic.arg_count, args.size()) };
+  for (std::size_t index = 0; index < count; ++index) { args[index] = other.argument(diagnostic, index); }
+  report(file, diagnostic.code, diagnostic.span, std::span{ args }.first(count));
+}
+
+std::string_view ErrorReporter::Reports::argument(const Diagnostic &diagnostic, std::size_t index) const
+{
+  if (index >= diagnostic.arg_count) { return {}; }
+  const Span arg{ args[diagnostic.first_arg + index] };
+  return std::string_view{ arg_bytes }.substr(arg.offset, arg.length);
+}
+
+void ErrorReporter::Reports::append(Diagnostic diagnostic, const Reports &from)
+{
+  const auto first_arg{ static_cast<std::uint32_t>(args.size()) };
+  for (std::uint32_t index = 0; index < diagnostic.arg_count; ++index) {
+    const Span arg{ from.args[diagnostic.first_arg + index] };
+    args.push_back(Span{ static_cast<std::uint32_t>(arg_bytes.size()), arg.length });
+    arg_bytes.append(from.arg_bytes, arg.offset, arg.length);
+  }
+  diagnostic.first_arg = first_arg;
+  diagnostics.push_back(diagnostic);
+}
+
+void ErrorReporter::Reports::settle(std::size_t max_errors)
+{
+  // arguments break ties, so the order never depends on which thread
+  // reported first
+  auto arguments_less = [this](const Diagnostic &lhs, const Diagnostic &rhs) {
+    for (std::size_t index = 0; index < std::min(lhs.arg_count, rhs.arg_count); ++index) {
+      const int order{ argument(lhs, index).compare(argument(rhs, index)) };
+      if (order != 0) { return order < 0; }
+    }
+    return lhs.arg_count < rhs.arg_count;
+  };
+  std::sort(diagnostics.begin(), diagnostics.end(), [&arguments_less](const Diagnostic &lhs, const Diagnostic &rhs) {
+    if (place_before(lhs, rhs)) { return true; }
+    if (place_before(rhs, lhs)) { return false; }
+    return arguments_less(lhs, rhs);
+  });
+
+  Reports kept{};
+  kept.dropped = std::move(dropped);
+  kept.diagnostics.reserve(diagnostics.size());
+  std::size_t errors{ 0 };
+  const Diagnostic *previous{ nullptr };
+  for (const Diagnostic &diagnostic : diagnostics) {
+    const bool repeat{ previous != nullptr && same_place(*previous, diagnostic) };
+    previous = &diagnostic;
+    if (repeat) { continue; }
+    if (diagnostic.severity == Severity::error && max_errors != 0 && errors++ >= max_errors) {
+      kept.drop(diagnostic);
+    } else {
+      kept.append(diagnostic, *this);
+    }
+  }
+  *this = std::move(kept);
+  settle_dropped();
+}
+
+void ErrorReporter::Reports::drop(const Diagnostic &diagnostic)
+{
+  dropped.push_back(Place{ diagnostic.file, diagnostic.span.offset, diagnostic.code });
+  // repeats are removed once they could double the list, so it stays in
+  // proportion to the distinct errors dropped
+  if (dropped.size() >= 2 * std::max<std::size_t>(distinct_dropped, 64)) { settle_dropped(); }// NOLINT
+}
+
+void ErrorReporter::Reports::settle_dropped()
+{
+  std::sort(dropped.begin(), dropped.end());
+  dropped.erase(std::unique(dropped.begin(), dropped.end()), dropped.end());
+  distinct_dropped = dropped.size();
+}
+
+void ErrorReporter::Reports::clear()
+{
+  diagnostics.clear();
+  arg_bytes.clear();
+  args.clear();
+  dropped.clear();
+  distinct_dropped = 0;
+}
+
+void ErrorReporter::merge() const
+{
+  if (m_pending.load(std::memory_order_acquire) == 0) { return; }
+  std::lock_guard<std::mutex> lock{ m_mutex };
+  m_pending.store(0, std::memory_order_relaxed);
+
+  for (const std::unique_ptr<Buffer> &buffer : m_buffers) {
+    for (const Diagnostic &diagnostic : buffer->reports.diagnostics) { m_merged.append(diagnostic, buffer->reports); }
+    m_merged.dropped.insert(m_merged.dropped.end(), buffer->reports.dropped.begin(), buffer->reports.dropped.end());
+    // the threshold stays: the errors before it are merged, not gone
+    buffer->reports.clear();
+    buffer->errors = 0;
+  }
+  m_merged.settle(m_max_errors);
+}
+
 void ErrorReporter::clear_errors()
 {
-  m_error_messages.clear();
-  m_status = Status::OK;
+  std::lock_guard<std::mutex> lock{ m_mutex };
+  for (const std::unique_ptr<Buffer> &buffer : m_buffers) {
+    buffer->reports.clear();
+    buffer->errors = 0;
+    buffer->last_kept.reset();
+  }
+  m_merged.clear();
+  m_pending.store(0, std::memory_order_relaxed);
+  m_failed.store(false, std::memory_order_relaxed);
 }
 
-Status ErrorReporter::get_status() const { return m_status; }
+Status ErrorReporter::get_status() const
+{
+  return m_failed.load(std::memory_order_relaxed) ? Status::ERROR : Status::OK;
+}
 
-void ErrorReporter::print_errors() const
+const std::vector<Diagnostic> &ErrorReporter::diagnostics() const
+{
+  merge();
+  return m_merged.diagnostics;
+}
+
+std::size_t ErrorReporter::suppressed_count() const
+{
+  merge();
+  return m_merged.dropped.size();
+}
+
+std::string_view ErrorReporter::argument(const Diagnostic &diagnostic, std::size_t index) const
+{
+  return m_merged.argument(diagnostic, index);
+}
+
+std::string ErrorReporter::message(const Diagnostic &diagnostic) const
+{
+  const std::string_view format{ message_template(diagnostic.code) };
+  std::string out{};
+  out.reserve(format.size());
+
+  std::size_t position{ 0 };
+  std::size_t next_arg{ 0 };
+  while (position < format.size()) {
+    const std::size_t hole{ format.find("{}", position) };
+    out += format.substr(position, hole - position);
+    if (hole == std::string_view::npos) { break; }
+    out += argument(diagnostic, next_arg++);
+    position = hole + 2;
+  }
+  return out;
+}
+
+void ErrorReporter::append_header(std::string &out, const Diagnostic &diagnostic) const
+{
+  const int line{ diagnostic.file < m_sources.size() ? m_sources[diagnostic.file].lines().line(diagnostic.span.offset)
+                                                     : 0 };
+  out += "[Line ";
+  out += std::to_string(line);
+  out += "] ";
+  out += severity_label(diagnostic.severity);
+  out += ": ";
+  out += message(diagnostic);
+}
+
+void ErrorReporter::append_snippet(std::string &out, const Diagnostic &diagnostic) const
+{
+  if (diagnostic.file >= m_sources.size()) { return; }
+  const SourceBuffer &source{ m_sources[diagnostic.file] };
+  const std::string_view text{ source.view() };
+  const std::size_t offset{ std::min<std::size_t>(diagnostic.span.offset, text.size()) };
+  const int line{ source.lines().line(offset) };
+  const std::size_t start{ source.lines().line_start(line) };
+  const std::size_t end{ std::min(text.find('\n', start), text.size()) };
+
+  append_line_number(out, line);
+  out += text.substr(start, end - start);
+  out += '\n';
+
+  // the underline stops at the end of the line, tabs are kept so it lines up
+  append_line_number(out, 0);
+  for (std::size_t index = start; index < offset; ++index) { out += text[index] == '\t' ? '\t' : ' '; }
+  out += '^';
+  const std::size_t span_end{ std::min<std::size_t>(offset + diagnostic.span.length, end) };
+  if (span_end > offset + 1) { out.append(span_end - offset - 1, '~'); }
+  out += '\n';
+}
+
+std::vector<std::string> ErrorReporter::get_errors() const
 {
-  auto print = [](const auto &err) { std::cerr << err << '\n'; };
-  std::for_each(m_error_messages.begin(), m_error_messages.end(), print);
+  std::vector<std::string> errors{};
+  errors.reserve(diagnostics().size());
+  for (const Diagnostic &diagnostic : diagnostics()) {
+    std::string line{};
+    append_header(line, diagnostic);
+    errors.push_back(std::move(line));
+  }
+  return errors;
 }
 
-void ErrorReporter::set_error(int line, const std::string &message)
+std::string ErrorReporter::render() const
+{
+  std::string out{};
+  for (const Diagnostic &diagnostic : diagnostics()) {
+    append_header(out, diagnostic);
+    out += '\n';
+    append_snippet(out, diagnostic);
+  }
+  if (suppressed_count() > 0) {
+    out += "Too many errors, " + std::to_string(suppressed_count()) + " more not shown\n";
+  }
+  return out;
+}
+
+void ErrorReporter::print_errors() const
 {
-  m_error_messages.emplace_back("[Line " + std::to_string(line) + "] Error: " + message);
-  m_status = Status::ERROR;
+  const std::string rendered{ render() };
+  std::cerr.write(rendered.data(), static_cast<std::streamsize>(rendered.size()));
+  std::cerr.flush();
 }
 
 }// namespace blang::error
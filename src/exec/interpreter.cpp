@@ -0,0 +1,552 @@
+#include "blang/exec/interpreter.hpp"
+#include "blang/arithmetic.hpp"
+#include "blang/numeric_literal.hpp"
+#include <array>
+#include <charconv>
+#include <span>
+#include <variant>
+
+namespace blang::exec {
+
+Interpreter::Interpreter(const TokenStream &tokens,
+  const Ast &ast,
+  const sema::TypeChecker &checker,
+  error::ErrorReporter &reporter,
+  std::ostream &out)
+  : m_tokens(&tokens), m_ast(&ast), m_checker(&checker), m_reporter(&reporter), m_out(&out)
+{}
+
+bool Interpreter::run(std::size_t replayed)
+{
+  try {
+    if (!m_laid_out) { layout(); }
+    m_stack.assign(m_globals, 0);
+    m_top = m_globals;
+    m_frame = 0;
+    m_depth = 0;
+    const std::span<const NodeId> roots{ m_ast->roots() };
+    for (std::size_t index = 0; index < roots.size(); ++index) {
+      m_quiet = index < replayed;
+      // the checker rejects a return outside of a function
+      static_cast<void>(statement(roots[index]));
+    }
+    m_quiet = false;
+    return true;
+  } catch (const RuntimeError &) {
+    m_quiet = false;
+    return false;
+  }
+}
+
+bool Interpreter::run_main()
+{
+  if (!m_laid_out) { return false; }
+  for (const NodeId root : m_ast->roots()) {
+    if (m_ast->kind(root) != NodeKind::declaration || text(root) != "main") { continue; }
+    const NodeId type{ m_ast->lhs(root) };
+    // the first declaration of main is the one its definition completes
+    const NodeId definition{ m_owners[root] };
+    if (m_ast->kind(type) != NodeKind::function_type || definition == NO_NODE
+        || !m_ast->list(m_ast->rhs(type)).empty()) {
+      return true;
+    }
+    try {
+      reserve(m_frame_sizes[definition]);
+      const std::size_t frame{ m_top };
+      m_top += m_frame_sizes[definition];
+      const Value result{ call_function(definition, root, frame) };
+      m_exit_code = m_checker->type(definition)->inner->kind == sema::TypeKind::t_void ? 0 : result;
+      return true;
+    } catch (const RuntimeError &) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void Interpreter::fail(NodeId node, error::DiagnosticCode code, std::initializer_list<std::string_view> args)
+{
+  // registered on the first error, so a clean run never touches the reporter
+  if (!m_file) { m_file = m_reporter->add_source(m_tokens->source()); }
+  const std::uint32_t token{ m_ast->token(node) };
+  m_reporter->report(*m_file, code, error::Span{ m_tokens->offset(token), m_tokens->length(token) }, args);
+  throw RuntimeError{};
+}
+
+void Interpreter::layout()
+{
+  const std::size_t size{ m_ast->size() };
+  m_addresses.assign(size, 0);
+  m_literals.assign(size, 0);
+  m_owners.assign(size, NO_NODE);
+  m_frame_sizes.assign(size, 0);
+  m_strings.assign(1, std::string{});
+  m_functions.clear();
+  m_scope = 0;
+
+  Layout globals{ NO_NODE, 0, 0 };
+  for (const NodeId root : m_ast->roots()) { layout_statement(root, globals); }
+  m_globals = globals.size;
+  m_laid_out = true;
+}
+
+void Interpreter::layout_statement(NodeId node, Layout &frame)
+{
+  const NodeId lhs{ m_ast->lhs(node) };
+  const NodeId rhs{ m_ast->rhs(node) };
+  switch (m_ast->kind(node)) {
+  case NodeKind::block: {
+    // the slots of a block are free again once it ends
+    const std::uint32_t next{ frame.next };
+    const std::size_t scope{ m_scope };
+    m_scope = m_functions.size();
+    for (const NodeId stmt : m_ast->list(rhs)) { layout_statement(stmt, frame); }
+    m_functions.resize(m_scope);
+    m_scope = scope;
+    frame.next = next;
+    break;
+  }
+  case NodeKind::declaration:
+    layout_declaration(node, frame);
+    break;
+  case NodeKind::expression_stmt:
+  case NodeKind::return_stmt:
+    if (lhs != NO_NODE) { layout_expression(lhs, frame); }
+    break;
+  case NodeKind::print_stmt:
+    for (const NodeId value : m_ast->list(rhs)) { layout_expression(value, frame); }
+    break;
+  case NodeKind::if_stmt: {
+    layout_expression(lhs, frame);
+    layout_body(m_ast->extra(rhs), frame);
+    const NodeId else_branch{ m_ast->extra(rhs + 1) };
+    if (else_branch != NO_NODE) { layout_body(else_branch, frame); }
+    break;
+  }
+  case NodeKind::while_stmt:
+    layout_expression(lhs, frame);
+    layout_body(rhs, frame);
+    break;
+  case NodeKind::for_stmt:
+    for (std::uint32_t clause = 0; clause < 3; ++clause) {
+      const NodeId expression{ m_ast->extra(lhs + clause) };
+      if (expression != NO_NODE) { layout_expression(expression, frame); }
+    }
+    layout_body(rhs, frame);
+    break;
+  default:
+    break;
+  }
+}
+
+void Interpreter::layout_body(NodeId node, Layout &frame)
+{
+  // scoped like a block holding just `node`
+  const std::uint32_t next{ frame.next };
+  const std::size_t scope{ m_scope };
+  m_scope = m_functions.size();
+  layout_statement(node, frame);
+  m_functions.resize(m_scope);
+  m_scope = scope;
+  frame.next = next;
+}
+
+void Interpreter::layout_declaration(NodeId node, Layout &frame)
+{
+  NodeId type{ m_ast->lhs(node) };
+  const NodeId initializer{ m_ast->extra(m_ast->rhs(node)) };
+  const NodeId body{ m_ast->extra(m_ast->rhs(node) + 1) };
+
+  if (m_ast->kind(type) == NodeKind::function_type) {
+    // a definition completes the prototypes of the same name in its scope,
+    // and calls find it through the first of them
+    NodeId first{ node };
+    for (std::size_t index = m_scope; index < m_functions.size(); ++index) {
+      if (text(m_functions[index]) == text(node)) {
+        first = m_functions[index];
+        break;
+      }
+    }
+    if (first == node) { m_functions.push_back(node); }
+    if (body == NO_NODE) { return; }
+    m_owners[first] = node;
+
+    // the parameters and the outermost block of the body share a scope
+    Layout function{ node, 0, 0 };
+    const std::size_t scope{ m_scope };
+    m_scope = m_functions.size();
+    for (const NodeId param : m_ast->list(m_ast->rhs(type))) { allocate(param, function); }
+    for (const NodeId stmt : m_ast->list(m_ast->rhs(body))) { layout_statement(stmt, function); }
+    m_functions.resize(m_scope);
+    m_scope = scope;
+    m_frame_sizes[node] = function.size;
+    return;
+  }
+
+  for (; m_ast->kind(type) == NodeKind::array_type; type = m_ast->rhs(type)) {
+    if (m_ast->lhs(type) != NO_NODE) { layout_expression(m_ast->lhs(type), frame); }
+  }
+  if (initializer != NO_NODE) { layout_expression(initializer, frame); }
+  allocate(node, frame);
+}
+
+void Interpreter::allocate(NodeId node, Layout &frame)
+{
+  const std::uint32_t slot{ frame.next++ };
+  frame.size = std::max(frame.size, frame.next);
+  m_addresses[node] = frame.function == NO_NODE ? slot | GLOBAL : slot;
+  m_owners[node] = frame.function;
+}
+
+void Interpreter::layout_expression(NodeId node, const Layout &frame)
+{
+  const NodeId lhs{ m_ast->lhs(node) };
+  const NodeId rhs{ m_ast->rhs(node) };
+  switch (m_ast->kind(node)) {
+  case NodeKind::literal:
+    layout_literal(node);
+    break;
+  case NodeKind::variable: {
+    const NodeId declaration{ m_checker->declaration(node) };
+    // functions are only called, and found when they are
+    if (declaration == NO_NODE || m_ast->kind(m_ast->lhs(declaration)) == NodeKind::function_type) { break; }
+    if ((m_addresses[declaration] & GLOBAL) == 0 && m_owners[declaration] != frame.function) {
+      fail(node, error::DiagnosticCode::enclosing_local, { text(node) });
+    }
+    m_addresses[node] = m_addresses[declaration];
+    break;
+  }
+  case NodeKind::grouping:
+  case NodeKind::unary:
+  case NodeKind::postfix:
+    layout_expression(lhs, frame);
+    break;
+  case NodeKind::binary:
+  case NodeKind::subscript:
+    layout_expression(lhs, frame);
+    layout_expression(rhs, frame);
+    break;
+  case NodeKind::call:
+    layout_expression(lhs, frame);
+    [[fallthrough]];
+  case NodeKind::init_list:
+    for (const NodeId item : m_ast->list(rhs)) { layout_expression(item, frame); }
+    break;
+  default:
+    break;
+  }
+}
+
+void Interpreter::layout_literal(NodeId node)
+{
+  const std::uint32_t token{ m_ast->token(node) };
+  switch (m_tokens->type(token)) {
+  case TokenType::t_integer_lit:
+    m_literals[node] = parse_integer_literal(m_tokens->text(token)).value_or(0);
+    break;
+  case TokenType::t_char_lit:
+    m_literals[node] = static_cast<unsigned char>(std::get<char>(m_tokens->value(token)));
+    break;
+  case TokenType::t_string_lit: {
+    // a literal shared by several parents is decoded once
+    if (m_literals[node] != 0) { break; }
+    std::string scratch{};
+    m_strings.emplace_back(m_tokens->literal(token, scratch));
+    m_literals[node] = static_cast<Value>(m_strings.size() - 1);
+    break;
+  }
+  case TokenType::t_true:
+    m_literals[node] = 1;
+    break;
+  default:
+    break;
+  }
+}
+
+Interpreter::Flow Interpreter::statement(NodeId node)
+{
+  const NodeId lhs{ m_ast->lhs(node) };
+  const NodeId rhs{ m_ast->rhs(node) };
+  switch (m_ast->kind(node)) {
+  case NodeKind::block:
+    return block(node);
+  case NodeKind::declaration:
+    declaration(node);
+    break;
+  case NodeKind::expression_stmt:
+    expression(lhs);
+    break;
+  case NodeKind::print_stmt:
+    print(node);
+    break;
+  case NodeKind::return_stmt:
+    m_result = lhs == NO_NODE ? 0 : expression(lhs);
+    return Flow::returned;
+  case NodeKind::if_stmt: {
+    if (condition(lhs)) { return body(m_ast->extra(rhs)); }
+    const NodeId else_branch{ m_ast->extra(rhs + 1) };
+    return else_branch == NO_NODE ? Flow::next : body(else_branch);
+  }
+  case NodeKind::while_stmt:
+    while (condition(lhs)) {
+      if (body(rhs) == Flow::returned) { return Flow::returned; }
+    }
+    break;
+  case NodeKind::for_stmt: {
+    const NodeId init{ m_ast->extra(lhs) };
+    const NodeId test{ m_ast->extra(lhs + 1) };
+    const NodeId step{ m_ast->extra(lhs + 2) };
+    if (init != NO_NODE) { expression(init); }
+    while (test == NO_NODE || condition(test)) {
+      if (body(rhs) == Flow::returned) { return Flow::returned; }
+      if (step != NO_NODE) { expression(step); }
+    }
+    break;
+  }
+  default:
+    break;
+  }
+  return Flow::next;
+}
+
+Interpreter::Flow Interpreter::block(NodeId node)
+{
+  // the arrays the block declares end with it
+  const std::size_t top{ m_top };
+  Flow flow{ Flow::next };
+  for (const NodeId stmt : m_ast->list(m_ast->rhs(node))) {
+    flow = statement(stmt);
+    if (flow == Flow::returned) { break; }
+  }
+  m_top = top;
+  return flow;
+}
+
+Interpreter::Flow Interpreter::body(NodeId node)
+{
+  const std::size_t top{ m_top };
+  const Flow flow{ statement(node) };
+  m_top = top;
+  return flow;
+}
+
+void Interpreter::declaration(NodeId node)
+{
+  const NodeId type{ m_ast->lhs(node) };
+  const NodeId initializer{ m_ast->extra(m_ast->rhs(node)) };
+  Value value{ 0 };
+  switch (m_ast->kind(type)) {
+  case NodeKind::function_type:
+    return;
+  case NodeKind::array_type:
+    // an array initialized from another refers to the same elements
+    value = initializer != NO_NODE && m_ast->kind(initializer) != NodeKind::init_list ? expression(initializer)
+                                                                                       : array(type, initializer);
+    break;
+  default:
+    if (initializer != NO_NODE) { value = expression(initializer); }
+    break;
+  }
+  m_stack[cell(node)] = value;
+}
+
+void Interpreter::print(NodeId node)
+{
+  for (const NodeId item : m_ast->list(m_ast->rhs(node))) {
+    const Value value{ expression(item) };
+    if (m_quiet) { continue; }
+    switch (m_checker->type(item)->kind) {
+    case sema::TypeKind::t_boolean:
+      *m_out << (value != 0 ? "true" : "false");
+      break;
+    case sema::TypeKind::t_char:
+      m_out->put(static_cast<char>(value));
+      break;
+    case sema::TypeKind::t_string:
+      *m_out << m_strings[static_cast<std::size_t>(value)];
+      break;
+    default: {
+      std::array<char, 24> digits{};// NOLINT
+      const char *end{ std::to_chars(digits.data(), digits.data() + digits.size(), value).ptr };
+      m_out->write(digits.data(), end - digits.data());
+      break;
+    }
+    }
+  }
+}
+
+Interpreter::Value Interpreter::array(NodeId type, NodeId init_list)
+{
+  const NodeId size{ m_ast->lhs(type) };
+  const NodeId element{ m_ast->rhs(type) };
+  const std::span<const NodeId> items{ init_list == NO_NODE ? std::span<const NodeId>{}
+                                                             : m_ast->list(m_ast->rhs(init_list)) };
+  const Value length{ size == NO_NODE ? static_cast<Value>(items.size()) : expression(size) };
+  if (length < 0 || static_cast<std::size_t>(length) >= MAX_CELLS - std::min(m_top, MAX_CELLS)) {
+    fail(size == NO_NODE ? type : size, error::DiagnosticCode::array_size, { std::to_string(length) });
+  }
+  const auto count{ static_cast<std::size_t>(length) };
+  if (items.size() > count) {
+    fail(init_list,
+      error::DiagnosticCode::too_many_initializers,
+      { std::to_string(items.size()), std::to_string(count) });
+  }
+
+  reserve(count + 1);
+  const std::size_t at{ m_top };
+  m_top += count + 1;
+  m_stack[at] = length;
+  const bool nested{ m_ast->kind(element) == NodeKind::array_type };
+  for (std::size_t index = 0; index < count; ++index) {
+    Value value{ 0 };
+    if (index < items.size()) {
+      const NodeId item{ items[index] };
+      value = m_ast->kind(item) == NodeKind::init_list ? array(element, item) : expression(item);
+    } else if (nested) {
+      value = array(element, NO_NODE);
+    }
+    // by index, since the nested arrays may have moved the stack
+    m_stack[at + 1 + index] = value;
+  }
+  return static_cast<Value>(at);
+}
+
+Interpreter::Value Interpreter::expression(NodeId node)
+{
+  const NodeId lhs{ m_ast->lhs(node) };
+  switch (m_ast->kind(node)) {
+  case NodeKind::literal:
+    return m_literals[node];
+  case NodeKind::integer_constant:
+  case NodeKind::boolean_constant:
+    return m_ast->constant(node);
+  case NodeKind::variable:
+    return m_stack[cell(node)];
+  case NodeKind::grouping:
+    return expression(lhs);
+  case NodeKind::unary: {
+    const Value operand{ expression(lhs) };
+    if (m_tokens->type(m_ast->token(node)) == TokenType::t_bang) { return operand == 0 ? 1 : 0; }
+    return integer_negate(operand);
+  }
+  case NodeKind::postfix: {
+    const std::size_t target{ place(lhs) };
+    const Value old{ m_stack[target] };
+    const std::uint64_t step{ m_tokens->type(m_ast->token(node)) == TokenType::t_plus_plus ? 1U : ~std::uint64_t{ 0 } };
+    m_stack[target] = wrap(static_cast<std::uint64_t>(old) + step);
+    return old;
+  }
+  case NodeKind::subscript:
+    return m_stack[place(node)];
+  case NodeKind::binary:
+    return binary(node);
+  case NodeKind::call:
+    return call(node);
+  default:
+    return 0;
+  }
+}
+
+Interpreter::Value Interpreter::binary(NodeId node)
+{
+  const NodeId lhs{ m_ast->lhs(node) };
+  const NodeId rhs{ m_ast->rhs(node) };
+  const TokenType op{ m_tokens->type(m_ast->token(node)) };
+  switch (op) {
+  case TokenType::t_equal: {
+    const std::size_t target{ place(lhs) };
+    const Value value{ expression(rhs) };
+    m_stack[target] = value;
+    return value;
+  }
+  case TokenType::t_and_and:
+    return expression(lhs) != 0 && expression(rhs) != 0 ? 1 : 0;
+  case TokenType::t_or_or:
+    return expression(lhs) != 0 || expression(rhs) != 0 ? 1 : 0;
+  case TokenType::t_equal_equal:
+  case TokenType::t_bang_equal: {
+    const Value left{ expression(lhs) };
+    const Value right{ expression(rhs) };
+    // strings compare by contents, everything else by value
+    const bool equal{ m_checker->type(lhs)->kind == sema::TypeKind::t_string
+                        ? m_strings[static_cast<std::size_t>(left)] == m_strings[static_cast<std::size_t>(right)]
+                        : left == right };
+    return equal == (op == TokenType::t_equal_equal) ? 1 : 0;
+  }
+  case TokenType::t_less_than:
+  case TokenType::t_less_equal:
+  case TokenType::t_greater_than:
+  case TokenType::t_greater_equal: {
+    const Value left{ expression(lhs) };
+    return integer_compare(op, left, expression(rhs)) ? 1 : 0;
+  }
+  default: {
+    const Value left{ expression(lhs) };
+    const Value right{ expression(rhs) };
+    const std::optional<Value> value{ integer_binary(op, left, right) };
+    if (!value) {
+      fail(node, error::DiagnosticCode::no_value, { std::to_string(left), text(node), std::to_string(right) });
+    }
+    return *value;
+  }
+  }
+}
+
+Interpreter::Value Interpreter::call(NodeId node)
+{
+  NodeId callee{ m_ast->lhs(node) };
+  while (m_ast->kind(callee) == NodeKind::grouping) { callee = m_ast->lhs(callee); }
+  const NodeId declaration{ m_ast->kind(callee) == NodeKind::variable ? m_checker->declaration(callee) : NO_NODE };
+  const NodeId definition{ declaration == NO_NODE ? NO_NODE : m_owners[declaration] };
+  if (definition == NO_NODE) { fail(node, error::DiagnosticCode::undefined_function, { text(callee) }); }
+
+  // the callee's frame is taken before the arguments are evaluated into it,
+  // so calls among them go above it
+  const std::uint32_t size{ m_frame_sizes[definition] };
+  reserve(size);
+  const std::size_t frame{ m_top };
+  m_top += size;
+  const std::span<const NodeId> arguments{ m_ast->list(m_ast->rhs(node)) };
+  for (std::size_t index = 0; index < arguments.size(); ++index) {
+    const Value argument{ expression(arguments[index]) };
+    m_stack[frame + index] = argument;
+  }
+  return call_function(definition, node, frame);
+}
+
+Interpreter::Value Interpreter::call_function(NodeId definition, NodeId site, std::size_t frame)
+{
+  if (m_depth == MAX_CALL_DEPTH) { fail(site, error::DiagnosticCode::call_depth, { std::to_string(MAX_CALL_DEPTH) }); }
+  const std::size_t caller{ m_frame };
+  m_frame = frame;
+  m_depth++;
+  Flow flow{ Flow::next };
+  const NodeId body{ m_ast->extra(m_ast->rhs(definition) + 1) };
+  for (const NodeId stmt : m_ast->list(m_ast->rhs(body))) {
+    flow = statement(stmt);
+    if (flow == Flow::returned) { break; }
+  }
+  m_depth--;
+  m_frame = caller;
+  m_top = frame;
+
+  if (flow == Flow::returned) { return m_result; }
+  if (m_checker->type(definition)->inner->kind != sema::TypeKind::t_void) {
+    fail(site, error::DiagnosticCode::missing_return, { text(definition) });
+  }
+  return 0;
+}
+
+std::size_t Interpreter::place(NodeId node)
+{
+  if (m_ast->kind(node) != NodeKind::subscript) { return cell(node); }
+  const Value array{ expression(m_ast->lhs(node)) };
+  const Value index{ expression(m_ast->rhs(node)) };
+  const Value length{ m_stack[static_cast<std::size_t>(array)] };
+  if (index < 0 || index >= length) {
+    fail(node, error::DiagnosticCode::index_out_of_bounds, { std::to_string(index), std::to_string(length) });
+  }
+  return static_cast<std::size_t>(array + 1 + index);
+}
+
+}// namespace blang::exec
@@ -0,0 +1,107 @@
+#include "blang/hash_cons.hpp"
+#include <algorithm>
+#include <functional>
+
+namespace blang {
+
+HashConsTable::Key HashConsTable::key(NodeKind kind, std::size_t token, NodeId lhs, NodeId rhs) const
+{
+  const TokenType type{ m_tokens->type(token) };
+  switch (kind) {
+  case NodeKind::literal:
+    return Key{ kind, type, NO_NODE, NO_NODE, m_tokens->text(token) };
+  case NodeKind::variable:
+    return Key{ kind, type, NO_NODE, m_epoch, m_tokens->text(token) };
+  default:
+    return Key{ kind, type, lhs, rhs, {} };
+  }
+}
+
+std::size_t HashConsTable::hash(const Key &key)
+{
+  // murmur3's 64-bit finalizer over the packed fields, so that children with
+  // neighbouring ids spread over the whole table
+  std::uint64_t hash{ key.text.empty() ? 0 : std::hash<std::string_view>{}(key.text) };
+  hash ^= std::uint64_t{ key.lhs } << 32U | key.rhs;// NOLINT
+  hash += std::uint64_t{ static_cast<std::uint8_t>(key.kind) } << 8U | static_cast<std::uint8_t>(key.type);
+  hash ^= hash >> 33U;// NOLINT
+  hash *= 0xFF51AFD7ED558CCD;// NOLINT
+  hash ^= hash >> 33U;// NOLINT
+  hash *= 0xC4CEB9FE1A85EC53;// NOLINT
+  return hash ^ (hash >> 33U);// NOLINT
+}
+
+std::size_t HashConsTable::probe(const Key &key) const
+{
+  const std::size_t mask{ m_slots.size() - 1 };
+  std::size_t reusable{ m_slots.size() };
+  for (std::size_t index{ hash(key) & mask };; index = (index + 1) & mask) {
+    const Slot &slot{ m_slots[index] };
+    if (slot.node == NO_NODE) { return reusable < m_slots.size() ? reusable : index; }
+    if (slot.node == TOMBSTONE) {
+      // a variable is erased on every write, so reusing its tombstone keeps
+      // the chains under names assigned over and over from growing
+      reusable = std::min(reusable, index);
+    } else if (slot.key == key) {
+      return index;
+    }
+  }
+}
+
+void HashConsTable::grow()
+{
+  std::vector<Slot> old{ std::move(m_slots) };
+  m_slots.assign(old.empty() ? MIN_CAPACITY : old.size() * 2, Slot{});
+  m_used = 0;
+  for (const Slot &slot : old) {
+    if (slot.node == NO_NODE || slot.node == TOMBSTONE) { continue; }
+    m_slots[probe(slot.key)] = slot;
+    m_used++;
+  }
+}
+
+NodeId HashConsTable::add(Ast &ast, NodeKind kind, std::size_t token, NodeId lhs, NodeId rhs)
+{
+  // at most half full, so probes stay short and always find an empty slot
+  if ((m_used + 1) * 2 > m_slots.size()) { grow(); }
+
+  const Key node_key{ key(kind, token, lhs, rhs) };
+  Slot &slot{ m_slots[probe(node_key)] };
+  if (slot.node != NO_NODE && slot.node != TOMBSTONE) {
+    m_hits.push_back(ast.size());
+    return slot.node;
+  }
+
+  const NodeId node{ ast.add(kind, token, lhs, rhs) };
+  if (slot.node == NO_NODE) { m_used++; }
+  slot = Slot{ node_key, node };
+  m_added.push_back(Added{ node_key, node });
+  return node;
+}
+
+void HashConsTable::erase(const Key &key, NodeId node)
+{
+  if (m_slots.empty()) { return; }
+  Slot &slot{ m_slots[probe(key)] };
+  if (slot.node != NO_NODE && slot.node != TOMBSTONE && (node == NO_NODE || slot.node == node)) {
+    slot.node = TOMBSTONE;
+  }
+}
+
+void HashConsTable::write(std::string_view name)
+{
+  // the next read adds a new node, which no expression in the table is over
+  erase(Key{ NodeKind::variable, TokenType::t_identifier, NO_NODE, m_epoch, name }, NO_NODE);
+}
+
+void HashConsTable::truncate(std::size_t nodes)
+{
+  while (!m_hits.empty() && m_hits.back() >= nodes) { m_hits.pop_back(); }
+  // nodes are added in increasing order, so the dropped ones are the newest
+  while (!m_added.empty() && m_added.back().node >= nodes) {
+    erase(m_added.back().key, m_added.back().node);
+    m_added.pop_back();
+  }
+}
+
+}// namespace blang
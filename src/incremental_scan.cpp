@@ -0,0 +1,66 @@
+#include "blang/scanner.hpp"
+#include <algorithm>
+#include <cstdint>
+
+namespace blang {
+
+namespace {
+
+  // Bytes the lexer may read past the end of a token to decide where it
+  // ends: "0x" and "0b" are only a prefix when a digit of their base follows,
+  // so "0" looks two bytes ahead. Every other token looks at most one.
+  constexpr std::size_t MAX_LOOKAHEAD = 2;
+
+}// namespace
+
+TokenStream Scanner::rescan(TokenStream previous, const TextEdit &edit)
+{
+  const std::size_t old_size{ previous.source().size() };
+  const std::size_t edit_begin{ std::min(edit.offset, old_size) };
+  const std::size_t edit_end{ edit_begin + std::min(edit.removed, old_size - edit_begin) };
+  const std::int64_t offset_delta{ static_cast<std::int64_t>(m_source.size()) - static_cast<std::int64_t>(old_size) };
+
+  if (previous.empty() || previous.type(previous.size() - 1) != TokenType::t_eof || m_position != 0
+      || m_lookahead_count > 0 || m_source.size() == 0) {
+    return scan();
+  }
+
+  // A token depends on its own bytes and the MAX_LOOKAHEAD bytes after it, so
+  // it survives the edit only if those bytes lie before the edited range.
+  // Lexing resumes right after the last such token, in normal state.
+  const auto restart_it{ std::partition_point(previous.begin(), previous.end(), [edit_begin](const Lexeme &lexeme) {
+    return std::size_t{ lexeme.offset } + lexeme.length + MAX_LOOKAHEAD <= edit_begin;
+  }) };
+  const auto kept{ static_cast<std::size_t>(restart_it - previous.begin()) };
+  if (kept > 0) {
+    m_position = previous.offset(kept - 1) + std::size_t{ previous.length(kept - 1) };
+  }
+
+  // Past the edit the old and new bytes are the same, so once a new token
+  // starts where an old one did the two lexers agree on everything after it.
+  TokenStream fresh{ m_source };
+  const auto resync_from{ static_cast<std::size_t>(static_cast<std::int64_t>(edit_end) + offset_delta) };
+  std::size_t old_index{ kept };
+  while (!m_finished) {
+    lex_next();
+    const std::size_t offset{ m_lexeme.offset };
+    if (offset >= resync_from) {
+      const auto old_offset{ static_cast<std::size_t>(static_cast<std::int64_t>(offset) - offset_delta) };
+      while (old_index < previous.size() && previous.offset(old_index) < old_offset) { old_index++; }
+      if (old_index < previous.size() && previous.offset(old_index) == old_offset
+          && previous.type(old_index) == m_lexeme.type) {
+        previous.splice(kept, old_index, std::move(fresh), offset_delta);
+        m_position = m_source.size();
+        m_finished = true;
+        return previous;
+      }
+    }
+    push_scanned(fresh);
+    m_finished = m_lexeme.type == TokenType::t_eof;
+  }
+
+  previous.splice(kept, previous.size(), std::move(fresh), 0);
+  return previous;
+}
+
+}// namespace blang
@@ -0,0 +1,139 @@
+#include "blang/interner.hpp"
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <mutex>
+
+namespace blang {
+
+namespace {
+
+  constexpr std::size_t INITIAL_SLOTS = 64;
+
+  std::size_t hash_text(std::string_view text) { return std::hash<std::string_view>{}(text); }
+
+}// namespace
+
+Atom Interner::intern(std::string_view text)
+{
+  std::size_t hash{ hash_text(text) };
+  std::size_t shard_index{ hash & (SHARD_COUNT - 1) };
+  Shard &shard{ m_shards.at(shard_index) };
+
+  {
+    std::shared_lock lock{ shard.mutex };
+    if (auto found = shard.probe(text, hash); found.has_value()) { return make_atom(shard_index, found.value()); }
+  }
+
+  std::unique_lock lock{ shard.mutex };
+  // another thread may have inserted it between the two locks
+  if (auto found = shard.probe(text, hash); found.has_value()) { return make_atom(shard_index, found.value()); }
+  return make_atom(shard_index, shard.insert(text, hash));
+}
+
+std::optional<Atom> Interner::find(std::string_view text) const
+{
+  std::size_t hash{ hash_text(text) };
+  std::size_t shard_index{ hash & (SHARD_COUNT - 1) };
+  const Shard &shard{ m_shards.at(shard_index) };
+
+  std::shared_lock lock{ shard.mutex };
+  if (auto found = shard.probe(text, hash); found.has_value()) { return make_atom(shard_index, found.value()); }
+  return {};
+}
+
+std::string_view Interner::view(Atom atom) const
+{
+  auto raw = static_cast<std::uint32_t>(atom);
+  const Shard &shard{ m_shards.at(raw & (SHARD_COUNT - 1)) };
+
+  std::shared_lock lock{ shard.mutex };
+  return shard.entries.at(raw >> SHARD_BITS).text;
+}
+
+std::size_t Interner::size() const
+{
+  std::size_t count{ 0 };
+  for (const Shard &shard : m_shards) {
+    std::shared_lock lock{ shard.mutex };
+    count += shard.entries.size();
+  }
+  return count;
+}
+
+std::size_t Interner::arena_bytes() const
+{
+  std::size_t bytes{ 0 };
+  for (const Shard &shard : m_shards) {
+    std::shared_lock lock{ shard.mutex };
+    bytes += shard.arena_bytes;
+  }
+  return bytes;
+}
+
+std::optional<std::uint32_t> Interner::Shard::probe(std::string_view text, std::size_t hash) const
+{
+  if (slots.empty()) { return {}; }
+
+  std::size_t mask{ slots.size() - 1 };
+  for (std::size_t slot = (hash >> SHARD_BITS) & mask;; slot = (slot + 1) & mask) {
+    std::uint32_t held{ slots[slot] };
+    if (held == 0) { return {}; }
+    const Entry &entry{ entries[held - 1] };
+    if (entry.hash == hash && entry.text == text) { return held - 1; }
+  }
+}
+
+std::uint32_t Interner::Shard::insert(std::string_view text, std::size_t hash)
+{
+  // keep the load factor at or below one half
+  if ((entries.size() + 1) * 2 > slots.size()) { grow(); }
+
+  auto index = static_cast<std::uint32_t>(entries.size());
+  entries.push_back(Entry{ store(text), hash });
+
+  std::size_t mask{ slots.size() - 1 };
+  std::size_t slot{ (hash >> SHARD_BITS) & mask };
+  while (slots[slot] != 0) { slot = (slot + 1) & mask; }
+  slots[slot] = index + 1;
+
+  return index;
+}
+
+std::string_view Interner::Shard::store(std::string_view text)
+{
+  if (text.empty()) { return {}; }
+
+  // strings larger than a chunk get a chunk of their own
+  if (chunk_used + text.size() > ARENA_CHUNK_SIZE) {
+    std::size_t chunk_size{ std::max(ARENA_CHUNK_SIZE, text.size()) };
+    chunks.push_back(std::make_unique<char[]>(chunk_size));// NOLINT
+    chunk_used = chunk_size == ARENA_CHUNK_SIZE ? 0 : chunk_size;
+    arena_bytes += chunk_size;
+    if (chunk_size != ARENA_CHUNK_SIZE) {
+      std::memcpy(chunks.back().get(), text.data(), text.size());
+      return { chunks.back().get(), text.size() };
+    }
+  }
+
+  char *destination{ chunks.back().get() + chunk_used };// NOLINT
+  std::memcpy(destination, text.data(), text.size());
+  chunk_used += text.size();
+  return { destination, text.size() };
+}
+
+void Interner::Shard::grow()
+{
+  std::vector<std::uint32_t> grown(slots.empty() ? INITIAL_SLOTS : slots.size() * 2, 0);
+  std::size_t mask{ grown.size() - 1 };
+
+  for (std::uint32_t index = 0; index < entries.size(); ++index) {
+    std::size_t slot{ (entries[index].hash >> SHARD_BITS) & mask };
+    while (grown[slot] != 0) { slot = (slot + 1) & mask; }
+    grown[slot] = index + 1;
+  }
+
+  slots = std::move(grown);
+}
+
+}// namespace blang
@@ -0,0 +1,74 @@
+#include "blang/line_table.hpp"
+#include "blang/simd/scan_kernels.hpp"
+#include <algorithm>
+#include <utility>
+
+namespace blang {
+
+LineTable::LineTable(std::string_view source)
+{
+  const simd::ScanKernels &kernels{ simd::kernels() };
+  const char *first{ source.data() };
+  const char *last{ source.data() + source.size() };
+
+  // one counting pass sizes the table exactly, a second collects the offsets
+  m_storage.reserve(kernels.count_byte(first, last, '\n'));
+  for (const char *newline{ kernels.find_byte(first, last, '\n') }; newline != last;
+       newline = kernels.find_byte(newline + 1, last, '\n')) {
+    m_storage.push_back(static_cast<std::uint32_t>(newline - first));
+  }
+  m_newlines = m_storage;
+}
+
+LineTable::LineTable(const LineTable &other) : m_storage(other.m_storage), m_newlines(other.m_newlines)
+{
+  if (!other.m_storage.empty()) { m_newlines = m_storage; }
+}
+
+LineTable::LineTable(LineTable &&other) noexcept
+  : m_storage(std::move(other.m_storage)), m_newlines(std::exchange(other.m_newlines, {}))
+{}
+
+LineTable &LineTable::operator=(const LineTable &other)
+{
+  if (this != &other) { *this = LineTable{ other }; }
+  return *this;
+}
+
+LineTable &LineTable::operator=(LineTable &&other) noexcept
+{
+  m_storage = std::move(other.m_storage);
+  m_newlines = std::exchange(other.m_newlines, {});
+  return *this;
+}
+
+LineTable LineTable::borrow(std::span<const std::uint32_t> newlines)
+{
+  LineTable table{};
+  table.m_newlines = newlines;
+  return table;
+}
+
+int LineTable::line(std::size_t offset) const
+{
+  // a newline belongs to the line it ends
+  auto after{ std::lower_bound(m_newlines.begin(), m_newlines.end(), offset) };
+  return static_cast<int>(after - m_newlines.begin()) + 1;
+}
+
+int LineTable::column(std::size_t offset) const { return locate(offset).column; }
+
+SourceLocation LineTable::locate(std::size_t offset) const
+{
+  const int number{ line(offset) };
+  return SourceLocation{ number, static_cast<int>(offset - line_start(number)) + 1 };
+}
+
+std::size_t LineTable::line_start(int line) const
+{
+  if (line <= 1 || m_newlines.empty()) { return 0; }
+  const auto index{ std::min(static_cast<std::size_t>(line - 2), m_newlines.size() - 1) };
+  return std::size_t{ m_newlines[index] } + 1;
+}
+
+}// namespace blang
@@ -0,0 +1,119 @@
+#include "blang/error/error_reporter.hpp"
+#include "blang/exec/interpreter.hpp"
+#include "blang/interner.hpp"
+#include "blang/sema/type_checker.hpp"
+#include "blang/sema/types.hpp"
+#include "blang/session.hpp"
+#include "blang/source_buffer.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <optional>
+#include <span>
+#include <string>
+
+// blang FILE runs a program: its top-level statements in order, then `main`
+// when it defines one, whose result is the exit status. Without a file it is
+// a REPL taking one statement or declaration per line. Each line is compiled
+// together with the lines accepted before it, which run again silently to
+// rebuild the globals; a line that does not compile or fails at run time is
+// dropped.
+
+namespace {
+
+// exit statuses of sysexits.h
+constexpr int EXIT_USAGE = 64;
+constexpr int EXIT_DATA_ERROR = 65;
+constexpr int EXIT_NO_INPUT = 66;
+constexpr int EXIT_SOFTWARE = 70;
+
+enum class Outcome : std::uint8_t { ran, compile_error, runtime_error };
+
+struct Result
+{
+  Outcome outcome;
+  // top-level statements of the program
+  std::size_t roots;
+  std::int64_t exit_code;
+};
+
+// Compiles and runs `source` in `session`, printing whatever is reported. The
+// first `replayed` top-level statements print nothing.
+Result run(blang::Session &session, const blang::SourceBuffer &source, std::size_t replayed, bool with_main)
+{
+  blang::error::ErrorReporter &reporter{ session.reporter() };
+  const blang::TokenStream tokens{ session.scan(source) };
+  const blang::Ast ast{ session.parse_program(tokens) };
+  if (reporter.get_status() != blang::error::Status::OK) {
+    reporter.print_errors();
+    return Result{ Outcome::compile_error, 0, 0 };
+  }
+
+  blang::Interner interner{};
+  blang::sema::TypeTable types{};
+  blang::sema::TypeChecker checker{ tokens, ast, types, interner, reporter };
+  if (!checker.check()) {
+    reporter.print_errors();
+    return Result{ Outcome::compile_error, 0, 0 };
+  }
+
+  blang::exec::Interpreter interpreter{ tokens, ast, checker, reporter, std::cout };
+  const bool clean{ interpreter.run(replayed) && (!with_main || interpreter.run_main()) };
+  std::cout.flush();
+  if (!clean) {
+    reporter.print_errors();
+    return Result{ Outcome::runtime_error, 0, 0 };
+  }
+  return Result{ Outcome::ran, ast.roots().size(), interpreter.exit_code() };
+}
+
+int run_file(const char *path)
+{
+  const std::optional<blang::SourceBuffer> source{ blang::SourceBuffer::from_file(path) };
+  if (!source) {
+    std::cerr << "Cannot read " << path << "\n";
+    return EXIT_NO_INPUT;
+  }
+  blang::Session session{};
+  const Result result{ run(session, *source, 0, true) };
+  switch (result.outcome) {
+  case Outcome::compile_error:
+    return EXIT_DATA_ERROR;
+  case Outcome::runtime_error:
+    return EXIT_SOFTWARE;
+  default:
+    return static_cast<int>(result.exit_code);
+  }
+}
+
+int repl()
+{
+  blang::Session session{};
+  std::string program{};
+  std::size_t roots{ 0 };
+  std::string line{};
+  for (std::cout << "> " << std::flush; std::getline(std::cin, line); std::cout << "> " << std::flush) {
+    session.reset();
+    const std::string candidate{ program + line + "\n" };
+    const Result result{ run(session, session.add_source(candidate), roots, false) };
+    if (result.outcome == Outcome::ran) {
+      program = candidate;
+      roots = result.roots;
+    }
+  }
+  std::cout << "\n";
+  return 0;
+}
+
+}// namespace
+
+int main(int argc, char *argv[])
+{
+  const std::span<char *> args{ argv, static_cast<std::size_t>(argc) };
+  if (args.size() > 2) {
+    std::cerr << "Usage: blang [FILE]\n";
+    return EXIT_USAGE;
+  }
+  return args.size() == 2 ? run_file(args[1]) : repl();
+}
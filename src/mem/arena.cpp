@@ -0,0 +1,103 @@
+#include "blang/mem/arena.hpp"
+#include <algorithm>
+#include <cstring>
+
+namespace blang::mem {
+
+namespace {
+
+  constexpr std::size_t PAGE_HEADER = alignof(std::max_align_t) * 2;
+
+}// namespace
+
+Arena::Arena(std::size_t page_size, std::pmr::memory_resource *upstream)
+  : m_page_size(std::max(page_size, PAGE_HEADER * 2)), m_upstream(upstream)
+{}
+
+Arena::~Arena()
+{
+  release();
+  if (m_pages != nullptr) {
+    m_upstream->deallocate(m_pages, m_pages->size, alignof(std::max_align_t));
+  }
+}
+
+std::string_view Arena::copy(std::string_view text)
+{
+  if (text.empty()) { return {}; }
+  auto *bytes{ static_cast<char *>(bump(text.size(), 1)) };
+  std::memcpy(bytes, text.data(), text.size());
+  return { bytes, text.size() };
+}
+
+void Arena::release()
+{
+  // keep the oldest page, which is a full-size one
+  Page *keep{ nullptr };
+  for (Page *page = m_pages; page != nullptr;) {
+    Page *next{ page->next };
+    if (next == nullptr && page->size == m_page_size) {
+      keep = page;
+    } else {
+      m_upstream->deallocate(page, page->size, alignof(std::max_align_t));
+    }
+    page = next;
+  }
+
+  m_pages = keep;
+  m_page_count = keep == nullptr ? 0 : 1;
+  m_reserved = keep == nullptr ? 0 : keep->size;
+  m_cursor = keep == nullptr ? nullptr : reinterpret_cast<char *>(keep) + PAGE_HEADER;// NOLINT
+  m_end = keep == nullptr ? nullptr : reinterpret_cast<char *>(keep) + keep->size;// NOLINT
+  m_last = nullptr;
+  m_used = 0;
+}
+
+Arena::Page *Arena::new_page(std::size_t size)
+{
+  auto *page{ static_cast<Page *>(m_upstream->allocate(size, alignof(std::max_align_t))) };
+  page->size = size;
+  m_reserved += size;
+  m_page_count++;
+  return page;
+}
+
+void *Arena::allocate_slow(std::size_t bytes, std::size_t alignment)
+{
+  const std::size_t needed{ PAGE_HEADER + bytes + alignment };
+  if (needed > m_page_size / 2) {
+    // a page of its own, linked behind the current one so bumping carries on
+    // where it was
+    Page *page{ new_page(needed) };
+    if (m_pages == nullptr) {
+      page->next = nullptr;
+      m_pages = page;
+    } else {
+      page->next = m_pages->next;
+      m_pages->next = page;
+    }
+    const auto start{ reinterpret_cast<std::uintptr_t>(page) + PAGE_HEADER };// NOLINT
+    const std::uintptr_t aligned{ (start + alignment - 1) & ~(std::uintptr_t{ alignment } - 1) };
+    m_used += bytes;
+    return reinterpret_cast<void *>(aligned);// NOLINT
+  }
+
+  Page *page{ new_page(m_page_size) };
+  page->next = m_pages;
+  m_pages = page;
+  m_cursor = reinterpret_cast<char *>(page) + PAGE_HEADER;// NOLINT
+  m_end = reinterpret_cast<char *>(page) + page->size;// NOLINT
+  return bump(bytes, alignment);
+}
+
+void Arena::do_deallocate(void *pointer, std::size_t bytes, std::size_t /*alignment*/)
+{
+  // only the newest allocation can be taken back
+  if (pointer == m_last && m_last + bytes == m_cursor) {// NOLINT
+    m_used -= bytes;
+    m_cursor = m_last;
+    m_last = nullptr;
+  }
+}
+
+}// namespace blang::mem
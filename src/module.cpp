@@ -0,0 +1,360 @@
+#include "blang/module.hpp"
+#include "blang/version.hpp"
+#include <array>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <type_traits>
+#include <unistd.h>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace blang {
+
+namespace {
+
+  constexpr std::array<char, 8> MAGIC{ 'B', 'L', 'A', 'N', 'G', 'M', 'O', 'D' };
+  // reads back differently on a machine of the other byte order
+  constexpr std::uint32_t BYTE_ORDER_MARK = 0x01020304;
+  constexpr std::size_t SECTION_ALIGNMENT = 8;
+
+  enum Section : std::uint8_t {
+    s_source,
+    s_newlines,
+    s_token_types,
+    s_token_offsets,
+    s_token_lengths,
+    s_token_atoms,
+    s_node_kinds,
+    s_node_tokens,
+    s_node_lhs,
+    s_node_rhs,
+    s_extra,
+    s_roots,
+    s_string_offsets,
+    s_string_bytes,
+    s_count,
+  };
+
+  // Size of one element of each section.
+  constexpr std::array<std::size_t, s_count> ELEMENT_SIZE{ sizeof(char),
+    sizeof(std::uint32_t),
+    sizeof(TokenType),
+    sizeof(std::uint32_t),
+    sizeof(std::uint32_t),
+    sizeof(Atom),
+    sizeof(NodeKind),
+    sizeof(std::uint32_t),
+    sizeof(NodeId),
+    sizeof(NodeId),
+    sizeof(NodeId),
+    sizeof(NodeId),
+    sizeof(std::uint32_t),
+    sizeof(char) };
+
+  struct SectionEntry
+  {
+    std::uint64_t offset;// from the start of the file
+    std::uint64_t count;// of elements
+  };
+
+  struct Header
+  {
+    std::array<char, 8> magic;
+    std::uint32_t byte_order;
+    std::uint32_t format_version;
+    std::uint32_t compiler_major;
+    std::uint32_t compiler_minor;
+    std::uint32_t compiler_patch;
+    std::uint32_t reserved;
+    std::uint64_t checksum;// of every byte after the header
+    std::uint64_t size;// of the whole file
+    std::array<SectionEntry, s_count> sections;
+  };
+  static_assert(std::is_trivially_copyable_v<Header> && sizeof(Header) % SECTION_ALIGNMENT == 0);
+
+  // Word-at-a-time multiplicative hash; catches corruption, not tampering.
+  std::uint64_t checksum(std::string_view bytes)
+  {
+    constexpr std::uint64_t MULTIPLIER = 0x9E3779B97F4A7C15;
+    constexpr unsigned SHIFT = 29;
+    std::uint64_t hash{ bytes.size() };
+    std::size_t index{ 0 };
+    for (; index + sizeof(std::uint64_t) <= bytes.size(); index += sizeof(std::uint64_t)) {
+      std::uint64_t word{};
+      std::memcpy(&word, bytes.data() + index, sizeof(word));
+      hash = (hash ^ word) * MULTIPLIER;
+      hash ^= hash >> SHIFT;
+    }
+    for (; index < bytes.size(); ++index) {
+      hash = (hash ^ static_cast<unsigned char>(bytes[index])) * MULTIPLIER;
+      hash ^= hash >> SHIFT;
+    }
+    return hash;
+  }
+
+  class Writer
+  {
+  public:
+    Writer() { m_bytes.resize(sizeof(Header)); }
+
+    template<typename T> void section(Section section, std::span<const T> items)
+    {
+      m_bytes.resize((m_bytes.size() + SECTION_ALIGNMENT - 1) / SECTION_ALIGNMENT * SECTION_ALIGNMENT);
+      m_header.sections.at(section) = SectionEntry{ m_bytes.size(), items.size() };
+      const std::size_t start{ m_bytes.size() };
+      m_bytes.resize(start + items.size_bytes());
+      if (!items.empty()) { std::memcpy(m_bytes.data() + start, items.data(), items.size_bytes()); }
+    }
+
+    std::string finish()
+    {
+      m_bytes.resize((m_bytes.size() + SECTION_ALIGNMENT - 1) / SECTION_ALIGNMENT * SECTION_ALIGNMENT);
+      m_header.magic = MAGIC;
+      m_header.byte_order = BYTE_ORDER_MARK;
+      m_header.format_version = MODULE_FORMAT_VERSION;
+      m_header.compiler_major = BLANG_MAJOR_VERSION;
+      m_header.compiler_minor = BLANG_MINOR_VERSION;
+      m_header.compiler_patch = BLANG_PATCH_VERSION;
+      m_header.size = m_bytes.size();
+      m_header.checksum = checksum(std::string_view{ m_bytes }.substr(sizeof(Header)));
+      std::memcpy(m_bytes.data(), &m_header, sizeof(Header));
+      return std::move(m_bytes);
+    }
+
+  private:
+    std::string m_bytes;
+    Header m_header{};
+  };
+
+  // Checks everything about the bytes but the meaning of the indices they
+  // hold, which the checksum vouches for.
+  ModuleError validate(std::string_view bytes, Header &header)
+  {
+    if (bytes.size() < sizeof(Header)) { return ModuleError::truncated; }
+    std::memcpy(&header, bytes.data(), sizeof(Header));
+    if (header.magic != MAGIC || header.byte_order != BYTE_ORDER_MARK) { return ModuleError::bad_magic; }
+    if (header.format_version != MODULE_FORMAT_VERSION) { return ModuleError::format_version; }
+    if (header.compiler_major != BLANG_MAJOR_VERSION || header.compiler_minor != BLANG_MINOR_VERSION
+        || header.compiler_patch != BLANG_PATCH_VERSION) {
+      return ModuleError::compiler_version;
+    }
+    if (header.size != bytes.size()) { return ModuleError::truncated; }
+    if (header.checksum != checksum(bytes.substr(sizeof(Header)))) { return ModuleError::checksum; }
+
+    for (std::size_t section = 0; section < s_count; ++section) {
+      const SectionEntry &entry{ header.sections.at(section) };
+      if (entry.offset % SECTION_ALIGNMENT != 0 || entry.offset < sizeof(Header) || entry.offset > bytes.size()
+          || entry.count > (bytes.size() - entry.offset) / ELEMENT_SIZE.at(section)) {
+        return ModuleError::malformed;
+      }
+    }
+
+    auto count = [&header](Section section) { return header.sections.at(section).count; };
+    const bool tokens_agree{ count(s_token_offsets) == count(s_token_types)
+                             && count(s_token_lengths) == count(s_token_types)
+                             && (count(s_token_atoms) == 0 || count(s_token_atoms) == count(s_token_types)) };
+    const bool nodes_agree{ count(s_node_tokens) == count(s_node_kinds) && count(s_node_lhs) == count(s_node_kinds)
+                            && count(s_node_rhs) == count(s_node_kinds) };
+    if (!tokens_agree || !nodes_agree) { return ModuleError::malformed; }
+    return ModuleError::none;
+  }
+
+  template<typename T> std::span<const T> view(std::string_view bytes, const Header &header, Section section)
+  {
+    const SectionEntry &entry{ header.sections.at(section) };
+    // the section is aligned for T and lies inside the mapping, see validate()
+    const auto *first{ reinterpret_cast<const T *>(bytes.data() + entry.offset) };// NOLINT
+    return { first, static_cast<std::size_t>(entry.count) };
+  }
+
+}// namespace
+
+std::string_view module_error_message(ModuleError error)
+{
+  switch (error) {
+  case ModuleError::none:
+    return "no error";
+  case ModuleError::unreadable:
+    return "cannot read module";
+  case ModuleError::truncated:
+    return "module is truncated";
+  case ModuleError::bad_magic:
+    return "not a module";
+  case ModuleError::format_version:
+    return "module format version mismatch";
+  case ModuleError::compiler_version:
+    return "module written by another compiler version";
+  case ModuleError::checksum:
+    return "module checksum mismatch";
+  case ModuleError::malformed:
+    return "module is malformed";
+  }
+  return "unknown module error";
+}
+
+std::string serialize_module(const TokenStream &tokens, const Ast &ast, const Interner *interner)
+{
+  const TokenColumns &columns{ tokens.columns() };
+
+  // atoms are renumbered by first use into the module's string table
+  std::vector<Atom> atoms{};
+  std::vector<std::uint32_t> string_offsets{};
+  std::string string_bytes{};
+  if (interner != nullptr && !columns.atoms.empty()) {
+    std::unordered_map<Atom, Atom> local{};
+    atoms.reserve(columns.atoms.size());
+    string_offsets.push_back(0);
+    for (const Atom atom : columns.atoms) {
+      if (atom == NO_ATOM) {
+        atoms.push_back(NO_ATOM);
+        continue;
+      }
+      auto [slot, inserted] = local.try_emplace(atom, static_cast<Atom>(string_offsets.size() - 1));
+      if (inserted) {
+        string_bytes.append(interner->view(atom));
+        string_offsets.push_back(static_cast<std::uint32_t>(string_bytes.size()));
+      }
+      atoms.push_back(slot->second);
+    }
+    // the column stops at the last token given an atom
+    atoms.resize(columns.types.size(), NO_ATOM);
+  }
+
+  const AstColumns &nodes{ ast.columns() };
+  Writer writer{};
+  writer.section(s_source, std::span<const char>{ tokens.source().view() });
+  writer.section(s_newlines, tokens.source().lines().newlines());
+  writer.section(s_token_types, columns.types);
+  writer.section(s_token_offsets, columns.offsets);
+  writer.section(s_token_lengths, columns.lengths);
+  writer.section(s_token_atoms, std::span<const Atom>{ atoms });
+  writer.section(s_node_kinds, nodes.kinds);
+  writer.section(s_node_tokens, nodes.tokens);
+  writer.section(s_node_lhs, nodes.lhs);
+  writer.section(s_node_rhs, nodes.rhs);
+  writer.section(s_extra, nodes.extra);
+  writer.section(s_roots, nodes.roots);
+  writer.section(s_string_offsets, std::span<const std::uint32_t>{ string_offsets });
+  writer.section(s_string_bytes, std::span<const char>{ string_bytes });
+  return writer.finish();
+}
+
+bool write_module(const std::filesystem::path &path,
+  const TokenStream &tokens,
+  const Ast &ast,
+  const Interner *interner)
+{
+  const std::string bytes{ serialize_module(tokens, ast, interner) };
+  std::ofstream file(path, std::ios::out | std::ios::binary | std::ios::trunc);
+  if (!file) { return false; }
+  file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+  return static_cast<bool>(file);
+}
+
+Module::Module(Module &&other) noexcept
+  : m_mapping(std::exchange(other.m_mapping, nullptr)), m_size(std::exchange(other.m_size, 0)),
+    m_tokens(std::move(other.m_tokens)), m_ast(std::move(other.m_ast)),
+    m_string_offsets(std::exchange(other.m_string_offsets, {})),
+    m_string_bytes(std::exchange(other.m_string_bytes, {}))
+{}
+
+Module &Module::operator=(Module &&other) noexcept
+{
+  if (this != &other) {
+    unmap();
+    m_mapping = std::exchange(other.m_mapping, nullptr);
+    m_size = std::exchange(other.m_size, 0);
+    m_tokens = std::move(other.m_tokens);
+    m_ast = std::move(other.m_ast);
+    m_string_offsets = std::exchange(other.m_string_offsets, {});
+    m_string_bytes = std::exchange(other.m_string_bytes, {});
+  }
+  return *this;
+}
+
+Module::~Module() { unmap(); }
+
+void Module::unmap()
+{
+  if (m_mapping != nullptr) { ::munmap(m_mapping, m_size); }
+  m_mapping = nullptr;
+  m_size = 0;
+}
+
+std::optional<Module> Module::load(const std::filesystem::path &path, ModuleError *error)
+{
+  auto fail = [error](ModuleError reason) -> std::optional<Module> {
+    if (error != nullptr) { *error = reason; }
+    return {};
+  };
+
+  const int descriptor{ ::open(path.c_str(), O_RDONLY | O_CLOEXEC) };// NOLINT
+  if (descriptor < 0) { return fail(ModuleError::unreadable); }
+  struct stat info
+  {
+  };
+  if (::fstat(descriptor, &info) != 0) {
+    ::close(descriptor);
+    return fail(ModuleError::unreadable);
+  }
+  const auto size{ static_cast<std::size_t>(info.st_size) };
+  if (size < sizeof(Header)) {
+    ::close(descriptor);
+    return fail(ModuleError::truncated);
+  }
+  void *mapping{ ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, descriptor, 0) };
+  ::close(descriptor);
+  if (mapping == MAP_FAILED) { return fail(ModuleError::unreadable); }// NOLINT
+
+  Module module{};
+  module.m_mapping = mapping;
+  module.m_size = size;
+
+  const std::string_view bytes{ static_cast<const char *>(mapping), size };
+  Header header{};
+  const ModuleError reason{ validate(bytes, header) };
+  if (reason != ModuleError::none) { return fail(reason); }
+
+  const std::span<const std::uint32_t> string_offsets{ view<std::uint32_t>(bytes, header, s_string_offsets) };
+  const std::span<const char> string_bytes{ view<char>(bytes, header, s_string_bytes) };
+  for (std::size_t index = 0; index < string_offsets.size(); ++index) {
+    const std::uint32_t previous{ index == 0 ? 0 : string_offsets[index - 1] };
+    if (string_offsets[index] < previous || string_offsets[index] > string_bytes.size()) {
+      return fail(ModuleError::malformed);
+    }
+  }
+
+  const std::span<const char> source{ view<char>(bytes, header, s_source) };
+  module.m_tokens = TokenStream::borrow(
+    SourceBuffer::borrow(std::string_view{ source.data(), source.size() },
+      LineTable::borrow(view<std::uint32_t>(bytes, header, s_newlines))),
+    TokenColumns{ view<TokenType>(bytes, header, s_token_types),
+      view<std::uint32_t>(bytes, header, s_token_offsets),
+      view<std::uint32_t>(bytes, header, s_token_lengths),
+      view<Atom>(bytes, header, s_token_atoms) });
+  module.m_ast = Ast::borrow(AstColumns{ view<NodeKind>(bytes, header, s_node_kinds),
+    view<std::uint32_t>(bytes, header, s_node_tokens),
+    view<NodeId>(bytes, header, s_node_lhs),
+    view<NodeId>(bytes, header, s_node_rhs),
+    view<NodeId>(bytes, header, s_extra),
+    view<NodeId>(bytes, header, s_roots) });
+  module.m_string_offsets = string_offsets;
+  module.m_string_bytes = std::string_view{ string_bytes.data(), string_bytes.size() };
+
+  if (error != nullptr) { *error = ModuleError::none; }
+  return module;
+}
+
+std::string_view Module::string(Atom atom) const
+{
+  const auto index{ static_cast<std::size_t>(atom) };
+  if (atom == NO_ATOM || index + 1 >= m_string_offsets.size()) { return {}; }
+  const std::uint32_t first{ m_string_offsets[index] };
+  return m_string_bytes.substr(first, m_string_offsets[index + 1] - first);
+}
+
+}// namespace blang
@@ -0,0 +1,82 @@
+#include "blang/numeric_literal.hpp"
+#include <charconv>
+
+namespace blang {
+
+namespace {
+
+  // Base of a literal, from its prefix, and the number of prefix bytes.
+  struct Radix
+  {
+    int base;
+    std::size_t prefix;
+  };
+
+  Radix radix_of(std::string_view lexeme)
+  {
+    if (lexeme.size() > 2 && lexeme[0] == '0') {
+      if (lexeme[1] == 'x' || lexeme[1] == 'X') { return Radix{ 16, 2 }; }// NOLINT
+      if (lexeme[1] == 'b' || lexeme[1] == 'B') { return Radix{ 2, 2 }; }
+    }
+    return Radix{ 10, 0 };// NOLINT
+  }
+
+  // Most digits of each base that always fit in a signed 64-bit value.
+  constexpr std::size_t SAFE_DECIMAL_DIGITS = 18;
+  constexpr std::size_t SAFE_HEX_DIGITS = 15;
+  constexpr std::size_t SAFE_BINARY_DIGITS = 63;
+
+  bool is_binary_digit(char chh) { return chh == '0' || chh == '1'; }
+
+}// namespace
+
+const char *integer_literal_end(const char *first, const char *last, const simd::ScanKernels &kernels)
+{
+  // NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+  if (*first == '0' && last - first > 2) {
+    const char marker{ first[1] };
+    if ((marker == 'x' || marker == 'X') && simd::is_hex_digit(first[2])) {
+      const char *cursor{ first + 2 };
+      while (cursor != last && simd::is_hex_digit(*cursor)) { ++cursor; }
+      return cursor;
+    }
+    if ((marker == 'b' || marker == 'B') && is_binary_digit(first[2])) {
+      const char *cursor{ first + 2 };
+      while (cursor != last && is_binary_digit(*cursor)) { ++cursor; }
+      return cursor;
+    }
+  }
+  return kernels.digits_end(first + 1, last);
+  // NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+}
+
+std::optional<std::int64_t> parse_integer_literal(std::string_view lexeme)
+{
+  const Radix radix{ radix_of(lexeme) };
+  const std::string_view digits{ lexeme.substr(radix.prefix) };
+
+  std::int64_t value{ 0 };
+  const auto [end, error] = std::from_chars(digits.data(), digits.data() + digits.size(), value, radix.base);
+  if (error != std::errc{} || end != digits.data() + digits.size()) { return {}; }// NOLINT
+  return value;
+}
+
+bool integer_literal_in_range(std::string_view lexeme)
+{
+  const Radix radix{ radix_of(lexeme) };
+  const std::size_t digits{ lexeme.size() - radix.prefix };
+  switch (radix.base) {
+  case 16:// NOLINT
+    if (digits <= SAFE_HEX_DIGITS) { return true; }
+    break;
+  case 2:
+    if (digits <= SAFE_BINARY_DIGITS) { return true; }
+    break;
+  default:
+    if (digits <= SAFE_DECIMAL_DIGITS) { return true; }
+    break;
+  }
+  return parse_integer_literal(lexeme).has_value();
+}
+
+}// namespace blang
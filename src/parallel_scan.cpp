@@ -0,0 +1,147 @@
+#include "blang/scanner.hpp"
+#include <algorithm>
+#include <exception>
+#include <future>
+
+// Speculative chunked lexing. Each chunk is lexed on the pool as if it began
+// in normal state; the chunks are then stitched in order.
+// Whenever the previous chunk ended somewhere other than where the next one
+// began (a block comment or string ran over the boundary), that chunk is
+// re-lexed from the true position until it produces a token at the same offset
+// as the speculative run. From there both runs are in the same state, so the
+// rest of the speculative tokens are kept as they are.
+
+namespace blang {
+
+Scanner::Scanner(const Scanner &parent, std::size_t start, error::ErrorReporter &reporter)
+  : m_source(parent.m_source), m_limit(parent.m_source.size()), m_start(start), m_position(start),
+    m_reporter(&reporter), m_file(reporter.add_source(m_source)), m_interner(parent.m_interner),
+    m_kernels(parent.m_kernels)
+{}
+
+TokenStream Scanner::scan_until(std::size_t limit)
+{
+  TokenStream tokens{ m_source };
+  tokens.reserve((limit - m_position) / 4);
+  m_limit = limit;
+
+  lex_next();
+  while (m_emitted) {
+    push_scanned(tokens);
+    lex_next();
+  }
+
+  m_limit = m_source.size();
+  return tokens;
+}
+
+std::vector<std::size_t> Scanner::chunk_bounds(std::size_t chunk_count, std::size_t min_chunk_bytes) const
+{
+  const std::size_t size{ m_source.size() };
+  const std::size_t count{ std::min(chunk_count, size / std::max<std::size_t>(min_chunk_bytes, 1)) };
+
+  std::vector<std::size_t> bounds{ 0 };
+  for (std::size_t i{ 1 }; i < count; i++) {
+    const char *target{ m_source.data() + (i * size / count) };
+    const char *newline{ m_kernels->find_byte(target, m_source.data() + size, '\n') };
+    const auto bound{ static_cast<std::size_t>(newline - m_source.data()) + 1 };
+    if (bound < size && bound > bounds.back()) { bounds.push_back(bound); }
+  }
+  bounds.push_back(size);
+  return bounds;
+}
+
+Scanner::ChunkScan Scanner::scan_chunk(std::size_t begin, std::size_t end) const
+{
+  // speculative errors stay with the chunk until it is stitched
+  ChunkScan result{};
+  result.errors = std::make_unique<error::ErrorReporter>(0);
+  Scanner chunk{ *this, begin, *result.errors };
+  try {
+    result.tokens = chunk.scan_until(end);
+  } catch (const std::exception &) {
+    // a speculative start can land in a spot that makes lexing throw, the
+    // stitching re-lexes the whole chunk in that case
+    result.failed = true;
+  }
+  result.stop = chunk.m_position;
+  return result;
+}
+
+TokenStream Scanner::scan_parallel(util::ThreadPool &pool, std::size_t chunk_count, std::size_t min_chunk_bytes)
+{
+  const std::vector<std::size_t> bounds{ chunk_bounds(chunk_count, min_chunk_bytes) };
+  if (bounds.size() <= 2 || m_position != 0 || m_lookahead_count > 0) { return scan(); }
+
+  std::vector<std::future<ChunkScan>> chunks;
+  chunks.reserve(bounds.size() - 1);
+  for (std::size_t k{ 0 }; k + 1 < bounds.size(); k++) {
+    chunks.push_back(pool.submit([this, begin = bounds[k], end = bounds[k + 1]] { return scan_chunk(begin, end); }));
+  }
+
+  try {
+    return stitch_chunks(bounds, chunks);
+  } catch (...) {
+    // queued chunks still refer to this scanner
+    for (auto &chunk : chunks) {
+      if (chunk.valid()) { chunk.wait(); }
+    }
+    throw;
+  }
+}
+
+void Scanner::forward_errors(const error::ErrorReporter &errors, std::size_t from)
+{
+  for (const error::Diagnostic &diagnostic : errors.diagnostics()) {
+    if (diagnostic.span.offset >= from) { m_reporter->report_from(errors, diagnostic, m_file); }
+  }
+}
+
+TokenStream Scanner::stitch_chunks(const std::vector<std::size_t> &bounds, std::vector<std::future<ChunkScan>> &chunks)
+{
+  TokenStream tokens{ m_source };
+  tokens.reserve(m_source.size() / 4);
+  std::size_t stop{ 0 };
+
+  for (std::size_t k{ 0 }; k + 1 < bounds.size(); k++) {
+    ChunkScan chunk{ chunks[k].get() };
+    std::size_t first{ 0 };
+    std::size_t synced_offset{ bounds[k] };
+
+    if (chunk.failed || stop != bounds[k]) {
+      Scanner relexer{ *this, stop, *m_reporter };
+      relexer.m_limit = bounds[k + 1];
+      bool synced{ false };
+
+      relexer.lex_next();
+      while (relexer.m_emitted) {
+        const std::uint32_t offset{ relexer.m_lexeme.offset };
+        while (!chunk.failed && first < chunk.tokens.size() && chunk.tokens.offset(first) < offset) { first++; }
+        if (!chunk.failed && first < chunk.tokens.size() && chunk.tokens.offset(first) == offset) {
+          synced = true;
+          synced_offset = offset;
+          break;
+        }
+        relexer.push_scanned(tokens);
+        relexer.lex_next();
+      }
+
+      if (!synced) {
+        stop = relexer.m_position;
+        continue;
+      }
+    }
+
+    tokens.append(chunk.tokens, first);
+    forward_errors(*chunk.errors, synced_offset);
+    stop = chunk.stop;
+  }
+
+  m_position = stop;
+  lex_next();
+  tokens.push_back(m_lexeme);
+  m_finished = true;
+  return tokens;
+}
+
+}// namespace blang
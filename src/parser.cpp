@@ -0,0 +1,430 @@
+#include "blang/parser.hpp"
+
+#include <array>
+
+namespace blang {
+
+namespace {
+
+  std::string_view expected_spelling(TokenType type)
+  {
+    switch (type) {
+    case TokenType::t_right_paren:
+      return ")";
+    case TokenType::t_right_square:
+      return "]";
+    case TokenType::t_right_brace:
+      return "}";
+    case TokenType::t_left_paren:
+      return "(";
+    case TokenType::t_left_brace:
+      return "{";
+    case TokenType::t_colon:
+      return ":";
+    case TokenType::t_semicolon:
+      return ";";
+    case TokenType::t_equal:
+      return "=";
+    case TokenType::t_left_square:
+      return "[";
+    case TokenType::t_identifier:
+      return "identifier";
+    default:
+      return "token";
+    }
+  }
+
+}// namespace
+
+Parser::DepthGuard::DepthGuard(Parser &parser) : m_parser(parser)
+{
+  if (m_parser.m_depth == MAX_NESTING_DEPTH) { m_parser.fail(error::DiagnosticCode::nesting_too_deep); }
+  m_parser.m_depth++;
+}
+
+Parser::Parser(const TokenStream &tokens,
+  error::ErrorReporter &reporter,
+  std::pmr::memory_resource *resource,
+  NodeSharing sharing)
+  : m_tokens(&tokens), m_reporter(&reporter), m_ast(resource)
+{
+  if (sharing == NodeSharing::pure_subtrees) {
+    m_sharing.emplace(tokens);
+  } else {
+    // about one node per token, a little more for statements
+    m_ast.reserve(tokens.size());
+  }
+}
+
+Ast Parser::parse()
+{
+  try {
+    const NodeId expr{ expression() };
+    expect(TokenType::t_eof, "after expression");
+    m_ast.add_root(expr);
+  } catch (const ParseError &) {
+    truncate(0, 0);
+  }
+  return std::move(m_ast);
+}
+
+Ast Parser::parse_program()
+{
+  while (!at_end()) {
+    const NodeId stmt{ recovering_statement() };
+    if (stmt != NO_NODE) {
+      m_ast.add_root(stmt);
+    } else if (check(TokenType::t_right_brace)) {
+      // a '}' without a block to close, already reported
+      advance();
+    }
+  }
+  return std::move(m_ast);
+}
+
+std::size_t Parser::expect(TokenType type, std::string_view where)
+{
+  if (check(type)) { return advance(); }
+  if (type == TokenType::t_eof) { fail(error::DiagnosticCode::expected_token, { "end of input", where }); }
+  fail(error::DiagnosticCode::expected_token, { expected_spelling(type), where });
+}
+
+void Parser::fail(error::DiagnosticCode code, std::initializer_list<std::string_view> args)
+{
+  report(m_current, code, args);
+  throw ParseError{};
+}
+
+void Parser::report(std::size_t index, error::DiagnosticCode code, std::initializer_list<std::string_view> args)
+{
+  // the source is only registered once there is something to report
+  if (!m_file) { m_file = m_reporter->add_source(m_tokens->source()); }
+  m_reporter->report(*m_file, code, error::Span{ m_tokens->offset(index), m_tokens->length(index) }, args);
+}
+
+void Parser::note_write(NodeId target)
+{
+  if (!m_sharing) { return; }
+  // the variable written is the array an element of it is assigned through
+  while (m_ast.kind(target) == NodeKind::subscript || m_ast.kind(target) == NodeKind::grouping) {
+    target = m_ast.lhs(target);
+  }
+  if (m_ast.kind(target) == NodeKind::variable) { m_sharing->write(m_tokens->text(m_ast.token(target))); }
+}
+
+void Parser::truncate(std::size_t nodes, std::size_t extra)
+{
+  m_ast.truncate(nodes, extra);
+  if (m_sharing) { m_sharing->truncate(nodes); }
+}
+
+std::uint32_t Parser::finish_list(std::size_t mark)
+{
+  const auto first{ m_scratch.begin() + static_cast<std::ptrdiff_t>(mark) };
+  const std::uint32_t list{ m_ast.add_list({ first, m_scratch.end() }) };
+  m_scratch.erase(first, m_scratch.end());
+  return list;
+}
+
+NodeId Parser::statement()
+{
+  const DepthGuard guard{ *this };
+  if (check(TokenType::t_identifier) && peek_next() == TokenType::t_colon) { return declaration(); }
+
+  const std::size_t keyword{ m_current };
+  switch (peek()) {
+  case TokenType::t_left_brace:
+    return block("to open block");
+  case TokenType::t_print: {
+    advance();
+    const std::size_t mark{ m_scratch.size() };
+    if (!check(TokenType::t_semicolon)) {
+      do { m_scratch.push_back(expression()); } while (match(TokenType::t_comma));
+    }
+    expect(TokenType::t_semicolon, "after print");
+    return m_ast.add(NodeKind::print_stmt, keyword, NO_NODE, finish_list(mark));
+  }
+  case TokenType::t_return: {
+    advance();
+    const NodeId value{ check(TokenType::t_semicolon) ? NO_NODE : expression() };
+    expect(TokenType::t_semicolon, "after return");
+    return m_ast.add(NodeKind::return_stmt, keyword, value);
+  }
+  case TokenType::t_if: {
+    advance();
+    const NodeId condition{ parenthesized("after 'if'") };
+    const NodeId then_branch{ statement() };
+    const NodeId else_branch{ match(TokenType::t_else) ? statement() : NO_NODE };
+    const std::array<NodeId, 2> branches{ then_branch, else_branch };
+    return m_ast.add(NodeKind::if_stmt, keyword, condition, m_ast.add_extra(branches));
+  }
+  case TokenType::t_while: {
+    advance();
+    // the condition and body also run after the body's writes
+    barrier();
+    const NodeId condition{ parenthesized("after 'while'") };
+    const NodeId body{ statement() };
+    barrier();
+    return m_ast.add(NodeKind::while_stmt, keyword, condition, body);
+  }
+  case TokenType::t_for:
+    return for_statement();
+  default: {
+    const NodeId expr{ expression() };
+    expect(TokenType::t_semicolon, "after expression");
+    return m_ast.add(NodeKind::expression_stmt, keyword, expr);
+  }
+  }
+}
+
+NodeId Parser::recovering_statement()
+{
+  const std::size_t nodes{ m_ast.size() };
+  const std::size_t extra{ m_ast.extra_size() };
+  const std::size_t scratch{ m_scratch.size() };
+  try {
+    return statement();
+  } catch (const ParseError &) {
+    truncate(nodes, extra);
+    m_scratch.resize(scratch);
+    synchronize();
+    return NO_NODE;
+  }
+}
+
+void Parser::synchronize()
+{
+  int braces{ 0 };
+  while (!at_end()) {
+    switch (peek()) {
+    case TokenType::t_semicolon:
+      advance();
+      if (braces == 0) { return; }
+      break;
+    case TokenType::t_left_brace:
+      advance();
+      braces++;
+      break;
+    case TokenType::t_right_brace:
+      // the enclosing block's '}' is left for the block
+      if (braces == 0) { return; }
+      advance();
+      if (--braces == 0) { return; }
+      break;
+    default:
+      advance();
+      break;
+    }
+  }
+}
+
+NodeId Parser::block(std::string_view where)
+{
+  const DepthGuard guard{ *this };
+  const std::size_t brace{ expect(TokenType::t_left_brace, where) };
+  const std::size_t mark{ m_scratch.size() };
+  while (!check(TokenType::t_right_brace) && !at_end()) {
+    const NodeId stmt{ recovering_statement() };
+    if (stmt != NO_NODE) { m_scratch.push_back(stmt); }
+  }
+  expect(TokenType::t_right_brace, "after block");
+  // the names declared in the block go out of scope
+  barrier();
+  return m_ast.add(NodeKind::block, brace, NO_NODE, finish_list(mark));
+}
+
+NodeId Parser::parenthesized(std::string_view where)
+{
+  expect(TokenType::t_left_paren, where);
+  const NodeId condition{ expression() };
+  expect(TokenType::t_right_paren, "after condition");
+  return condition;
+}
+
+NodeId Parser::for_statement()
+{
+  const std::size_t keyword{ advance() };
+  expect(TokenType::t_left_paren, "after 'for'");
+  const NodeId init{ check(TokenType::t_semicolon) ? NO_NODE : expression() };
+  expect(TokenType::t_semicolon, "after loop initializer");
+  barrier();
+  const NodeId condition{ check(TokenType::t_semicolon) ? NO_NODE : expression() };
+  expect(TokenType::t_semicolon, "after loop condition");
+  const NodeId step{ check(TokenType::t_right_paren) ? NO_NODE : expression() };
+  expect(TokenType::t_right_paren, "after for clauses");
+  const NodeId body{ statement() };
+  barrier();
+  const std::array<NodeId, 3> clauses{ init, condition, step };
+  return m_ast.add(NodeKind::for_stmt, keyword, m_ast.add_extra(clauses), body);
+}
+
+// name ':' type ('=' initializer)? ';', or a function definition, whose body
+// follows the '=' with no ';'.
+NodeId Parser::declaration()
+{
+  const std::size_t name{ advance() };
+  advance();// ':'
+  const NodeId type{ type_spec() };
+  NodeId initializer{ NO_NODE };
+  NodeId body{ NO_NODE };
+  if (match(TokenType::t_equal)) {
+    if (m_ast.kind(type) == NodeKind::function_type) {
+      // the body runs when called, not where it is written
+      barrier();
+      body = block("before function body");
+      barrier();
+    } else {
+      initializer = check(TokenType::t_left_brace) ? init_list() : expression();
+    }
+  }
+  if (body == NO_NODE) { expect(TokenType::t_semicolon, "after declaration"); }
+  note_declaration(name);
+  const std::array<NodeId, 2> value{ initializer, body };
+  return m_ast.add(NodeKind::declaration, name, type, m_ast.add_extra(value));
+}
+
+NodeId Parser::type_spec()
+{
+  const DepthGuard guard{ *this };
+  const std::size_t keyword{ m_current };
+  switch (peek()) {
+  case TokenType::t_integer:
+  case TokenType::t_boolean:
+  case TokenType::t_char:
+  case TokenType::t_string:
+  case TokenType::t_void:
+    advance();
+    return m_ast.add(NodeKind::primitive_type, keyword);
+  case TokenType::t_array: {
+    advance();
+    expect(TokenType::t_left_square, "after 'array'");
+    const NodeId size{ check(TokenType::t_right_square) ? NO_NODE : expression() };
+    expect(TokenType::t_right_square, "after array size");
+    const NodeId element{ type_spec() };
+    return m_ast.add(NodeKind::array_type, keyword, size, element);
+  }
+  case TokenType::t_function: {
+    advance();
+    const NodeId returns{ type_spec() };
+    expect(TokenType::t_left_paren, "before parameters");
+    const std::size_t mark{ m_scratch.size() };
+    if (!check(TokenType::t_right_paren)) {
+      do {
+        const std::size_t param{ expect(TokenType::t_identifier, "for parameter name") };
+        expect(TokenType::t_colon, "after parameter name");
+        const NodeId type{ type_spec() };
+        note_declaration(param);
+        m_scratch.push_back(m_ast.add(NodeKind::param, param, type));
+      } while (match(TokenType::t_comma));
+    }
+    expect(TokenType::t_right_paren, "after parameters");
+    return m_ast.add(NodeKind::function_type, keyword, returns, finish_list(mark));
+  }
+  default:
+    fail(error::DiagnosticCode::expected_type, { "in declaration" });
+  }
+}
+
+NodeId Parser::init_list()
+{
+  const DepthGuard guard{ *this };
+  const std::size_t brace{ advance() };
+  const std::size_t mark{ m_scratch.size() };
+  if (!check(TokenType::t_right_brace)) {
+    do {
+      m_scratch.push_back(check(TokenType::t_left_brace) ? init_list() : expression());
+    } while (match(TokenType::t_comma));
+  }
+  expect(TokenType::t_right_brace, "after initializer list");
+  return m_ast.add(NodeKind::init_list, brace, NO_NODE, finish_list(mark));
+}
+
+NodeId Parser::parse_precedence(Precedence min)
+{
+  const DepthGuard guard{ *this };
+  NodeId left{ prefix() };
+
+  while (infix_rule(peek()).precedence >= min) {
+    const InfixRule rule{ infix_rule(peek()) };
+    const std::size_t op{ advance() };
+    switch (m_tokens->type(op)) {
+    case TokenType::t_plus_plus:
+    case TokenType::t_minus_minus:
+      note_write(left);
+      left = m_ast.add(NodeKind::postfix, op, left);
+      break;
+    case TokenType::t_left_paren:
+      left = finish_call(left, op);
+      break;
+    case TokenType::t_left_square: {
+      const NodeId index{ expression() };
+      expect(TokenType::t_right_square, "after subscript");
+      left = add_pure(NodeKind::subscript, op, left, index);
+      break;
+    }
+    default: {
+      // a right-associative operator takes an operand of its own precedence
+      const auto next{ static_cast<Precedence>(
+        static_cast<std::uint8_t>(rule.precedence) + (rule.right_associative ? 0U : 1U)) };
+      if (m_tokens->type(op) == TokenType::t_equal && m_ast.kind(left) != NodeKind::variable
+          && m_ast.kind(left) != NodeKind::subscript) {
+        report(op, error::DiagnosticCode::invalid_assignment_target);
+      }
+      const NodeId right{ parse_precedence(next) };
+      if (m_tokens->type(op) == TokenType::t_equal) {
+        note_write(left);
+        left = m_ast.add(NodeKind::binary, op, left, right);
+      } else {
+        left = add_pure(NodeKind::binary, op, left, right);
+      }
+      break;
+    }
+    }
+  }
+  return left;
+}
+
+NodeId Parser::prefix()
+{
+  const std::size_t index{ m_current };
+  switch (peek()) {
+  case TokenType::t_integer_lit:
+  case TokenType::t_char_lit:
+  case TokenType::t_string_lit:
+  case TokenType::t_true:
+  case TokenType::t_false:
+    advance();
+    return add_pure(NodeKind::literal, index);
+  case TokenType::t_identifier:
+    advance();
+    return add_pure(NodeKind::variable, index);
+  case TokenType::t_left_paren: {
+    advance();
+    const NodeId inner{ expression() };
+    expect(TokenType::t_right_paren, "after expression");
+    return add_pure(NodeKind::grouping, index, inner);
+  }
+  case TokenType::t_minus:
+  case TokenType::t_bang: {
+    advance();
+    const NodeId operand{ parse_precedence(Precedence::unary) };
+    return add_pure(NodeKind::unary, index, operand);
+  }
+  default:
+    fail(error::DiagnosticCode::expected_expression);
+  }
+}
+
+NodeId Parser::finish_call(NodeId callee, std::size_t paren)
+{
+  const std::size_t mark{ m_scratch.size() };
+  if (!check(TokenType::t_right_paren)) {
+    do { m_scratch.push_back(expression()); } while (match(TokenType::t_comma));
+  }
+  expect(TokenType::t_right_paren, "after arguments");
+  // the callee may write any variable it can see
+  barrier();
+  return m_ast.add(NodeKind::call, paren, callee, finish_list(mark));
+}
+
+}// namespace blang
@@ -1,88 +1,160 @@
 #include "blang/scanner.hpp"
+#include "blang/numeric_literal.hpp"
+#include "blang/string_literal.hpp"
 #include "blang/token_type.hpp"
-#include <cctype>
-#include <locale>
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <charconv>
 #include <string>
 
 namespace blang {
 
-using value_object = std::variant<int, std::string, char>;
+Scanner::Scanner(SourceBuffer source, error::ErrorReporter &reporter, Interner *interner)
+  : m_source(std::move(source)), m_reporter(&reporter), m_interner(interner)
+{
+  // offsets past the limit would wrap, so none of the bytes are looked at
+  const bool too_large{ m_source.size() > MAX_SOURCE_BYTES };
+  if (too_large) { m_source = SourceBuffer{ std::string{} }; }
+  m_limit = m_source.size();
+  m_file = reporter.add_source(m_source);
+  if (too_large) { report_error(error::DiagnosticCode::source_too_large, { std::to_string(MAX_SOURCE_BYTES) }); }
+}
+
+std::vector<Token> Scanner::scan_tokens() { return scan().materialize(); }
+
+TokenStream Scanner::scan(std::pmr::memory_resource *resource)
+{
+  TokenStream tokens{ m_source, resource };
+  tokens.reserve(m_source.size() / 4);
+
+  // hand over whatever was already peeked, then lex straight into the stream
+  while (!m_finished && m_lookahead_count > 0) {
+    ScannedToken scanned{ next_token() };
+    tokens.push_back(scanned.lexeme);
+    if (scanned.atom != NO_ATOM) { tokens.set_atom(scanned.atom); }
+  }
+
+  while (!m_finished) {
+    lex_next();
+    push_scanned(tokens);
+    m_finished = m_lexeme.type == TokenType::t_eof;
+  }
+
+  return tokens;
+}
+
+void Scanner::push_scanned(TokenStream &tokens)
+{
+  tokens.push_back(m_lexeme);
+  if (m_atom != NO_ATOM) { tokens.set_atom(m_atom); }
+}
+
+ScannedToken Scanner::next_token()
+{
+  ScannedToken token{};
+  if (m_lookahead_count > 0) {
+    token = std::move(m_lookahead.at(m_lookahead_head));
+    m_lookahead_head = (m_lookahead_head + 1) % LOOKAHEAD_CAPACITY;
+    m_lookahead_count--;
+  } else {
+    token = lex_token();
+  }
+
+  if (token.lexeme.type == TokenType::t_eof) { m_finished = true; }
+  return token;
+}
+
+const ScannedToken &Scanner::peek(std::size_t ahead)
+{
+  assert(ahead < LOOKAHEAD_CAPACITY);// NOLINT
+
+  while (m_lookahead_count <= ahead) {
+    m_lookahead.at((m_lookahead_head + m_lookahead_count) % LOOKAHEAD_CAPACITY) = lex_token();
+    m_lookahead_count++;
+  }
+
+  return m_lookahead.at((m_lookahead_head + ahead) % LOOKAHEAD_CAPACITY);
+}
+
+ScannedToken Scanner::lex_token()
+{
+  lex_next();
+  return ScannedToken{ m_lexeme, m_atom };
+}
 
-std::vector<Token> Scanner::scan_tokens()
+void Scanner::lex_next()
 {
+  m_emitted = false;
+  m_atom = NO_ATOM;
 
-  while (m_position < m_source.size()) {// NOLINT // unsure abt this condition, check later
-    char current_char{ consume() };
+  while (!m_emitted && m_position < m_limit) {// NOLINT
+    m_start = m_position;
+    char current_char{ m_source.data()[m_position++] };// NOLINT
 
     switch (current_char) {
     case ':':
-      add_token(TokenType::t_colon, ':');
+      add_token(TokenType::t_colon);
       break;
     case ';':
-      add_token(TokenType::t_semicolon, ';');
+      add_token(TokenType::t_semicolon);
       break;
     case '=':
-      consume_next('=', TokenType::t_equal_equal, "==", TokenType::t_equal, '=');
+      consume_next('=', TokenType::t_equal_equal, TokenType::t_equal);
       break;
     case '[':
-      add_token(TokenType::t_left_square, '[');
+      add_token(TokenType::t_left_square);
       break;
     case ']':
-      add_token(TokenType::t_right_square, ']');
+      add_token(TokenType::t_right_square);
       break;
     case '{':
-      add_token(TokenType::t_left_brace, '{');
+      add_token(TokenType::t_left_brace);
       break;
     case '}':
-      add_token(TokenType::t_right_brace, '}');
+      add_token(TokenType::t_right_brace);
       break;
     case ',':
-      add_token(TokenType::t_comma, ',');
+      add_token(TokenType::t_comma);
       break;
     case '(':
-      add_token(TokenType::t_left_paren, '(');
+      add_token(TokenType::t_left_paren);
       break;
     case ')':
-      add_token(TokenType::t_right_paren, ')');
+      add_token(TokenType::t_right_paren);
       break;
     case '-':
-      consume_next('-', TokenType::t_minus_minus, "--", TokenType::t_minus, '-');
+      consume_next('-', TokenType::t_minus_minus, TokenType::t_minus);
       break;
     case '!':
-      consume_next('=', TokenType::t_bang_equal, "!=", TokenType::t_bang, '!');
+      consume_next('=', TokenType::t_bang_equal, TokenType::t_bang);
       break;
     case '^':
-      add_token(TokenType::t_exponent, '^');
+      add_token(TokenType::t_exponent);
       break;
     case '*':
-      add_token(TokenType::t_star, '*');
+      add_token(TokenType::t_star);
       break;
     case '/':
       process_comments();
       break;
     case '%':
-      add_token(TokenType::t_modulo, '%');
+      add_token(TokenType::t_modulo);
       break;
     case '+':
-      consume_next('+', TokenType::t_plus_plus, "++", TokenType::t_plus, '+');
+      consume_next('+', TokenType::t_plus_plus, TokenType::t_plus);
       break;
     case '<':
-      consume_next('=', TokenType::t_less_equal, "<=", TokenType::t_less_than, '<');
+      consume_next('=', TokenType::t_less_equal, TokenType::t_less_than);
       break;
     case '>':
-      consume_next('=', TokenType::t_greater_equal, ">=", TokenType::t_greater_than, '>');
+      consume_next('=', TokenType::t_greater_equal, TokenType::t_greater_than);
       break;
     case '&':
-      if (peek_next().has_value() && peek_next().value() == '&') {
-        consume();
-        add_token(TokenType::t_and_and, "&&");
-      }
+      if (match_next('&')) { add_token(TokenType::t_and_and); }
       break;
     case '|':
-      if (peek_next().has_value() && peek_next().value() == '|') {
-        consume();
-        add_token(TokenType::t_or_or, "||");
-      }
+      if (match_next('|')) { add_token(TokenType::t_or_or); }
       break;
     case '\'':
       process_char_lit();
@@ -91,160 +163,160 @@ std::vector<Token> Scanner::scan_tokens()
       process_string_lit();
       break;
     case ' ':
-      break;
     case '\n':
-      m_line++;
+      skip_whitespace();
       break;
     default:
 
-      if (valid_identifier_start_char(current_char)) {
-        process_identifier(current_char);
-      } else if (static_cast<bool>(std::isdigit(current_char))) {
-        process_integer_lit(current_char);
+      if (simd::is_identifier_start(current_char)) {
+        process_identifier();
+      } else if (simd::is_digit(current_char)) {
+        process_integer_lit();
       } else {
-        std::string message{ "Unexpected character: " + std::to_string(current_char) };
-        m_reporter.set_error(m_line, message);
+        // the character is shown by its numeric value
+        std::array<char, 4> digits{};
+        const auto result{ std::to_chars(digits.begin(), digits.end(), static_cast<int>(current_char)) };
+        report_error(error::DiagnosticCode::unexpected_character,
+          { std::string_view{ digits.data(), static_cast<std::size_t>(result.ptr - digits.data()) } });
       }
     }
   }
 
-  m_tokens.push_back(Token{ TokenType::t_eof, m_position + 1, m_line, '\0' });
-
-  return m_tokens;
+  if (!m_emitted && m_position >= m_source.size()) {
+    // eof covers one virtual byte past the end of the source
+    m_lexeme = Lexeme{ TokenType::t_eof, static_cast<std::uint32_t>(m_position), 1 };
+  }
 }
 
-char Scanner::consume() { return m_source.at(m_position++); }
-
-void Scanner::add_token(TokenType type, const value_object &value)
+void Scanner::add_token(TokenType type)
 {
-  m_tokens.push_back(Token{ type, m_position, m_line, value });
+  m_lexeme = Lexeme{ type, static_cast<std::uint32_t>(m_start), static_cast<std::uint32_t>(m_position - m_start) };
+  m_emitted = true;
 }
 
-std::optional<char> Scanner::peek_next() const
+void Scanner::report_error(error::DiagnosticCode code, std::initializer_list<std::string_view> args)
 {
-  if (m_position >= m_source.size()) { return {}; }
-  return m_source.at(m_position);
+  const error::Span span{ static_cast<std::uint32_t>(m_start), static_cast<std::uint32_t>(m_position - m_start) };
+  m_reporter->report(m_file, code, span, args);
 }
 
-void Scanner::consume_next(char next,
-  TokenType dbl,
-  const value_object &val_dbl,
-  TokenType single,
-  const value_object &val_single)
+void Scanner::intern_token(std::string_view text)
 {
-  if (peek_next().has_value() && peek_next().value() == next) {
-    consume();
-    add_token(dbl, val_dbl);
-  } else {
-    add_token(single, val_single);
-  }
+  if (m_interner != nullptr) { m_atom = m_interner->intern(text); }
 }
 
-bool Scanner::valid_identifier_start_char(char chh)
+bool Scanner::match_next(char next)
 {
-  std::locale c_loc("C");
-  return std::isalpha(chh, c_loc) || chh == '_';
+  if (m_position >= m_source.size() || m_source.view()[m_position] != next) { return false; }
+  m_position++;
+  return true;
 }
 
-bool Scanner::valid_identifier_char(char chh)
-{
-  return valid_identifier_start_char(chh) || static_cast<bool>(std::isdigit(chh));
-}
+void Scanner::consume_next(char next, TokenType dbl, TokenType single) { add_token(match_next(next) ? dbl : single); }
 
-void Scanner::process_identifier(char curr_char)
+void Scanner::skip_whitespace()
 {
-  std::string buffer{};
-  buffer.push_back(curr_char);
-
-  while (peek_next().has_value() && valid_identifier_char(peek_next().value())) {// NOLINT
-    char next_char = consume();
-    buffer.push_back(next_char);
+  // most blanks are a single space between tokens, only longer runs go to the kernel
+  if (m_position >= m_source.size() || !simd::has_class(m_source.data()[m_position], simd::c_blank)) {// NOLINT
+    return;
   }
 
-  TokenType type = {};
-  if (auto search = m_keywords.find(buffer); search != m_keywords.end()) {
-    type = search->second;
-  } else {
-    type = TokenType::t_identifier;
-  }
+  m_position = offset_of(m_kernels->skip_whitespace(cursor(m_position), source_end()));
+}
 
-  add_token(type, buffer);
+void Scanner::process_identifier()
+{
+  m_position = offset_of(m_kernels->identifier_end(cursor(m_position), source_end()));
+
+  std::string_view text{ m_source.view().substr(m_start, m_position - m_start) };
+  TokenType type{ keyword_or_identifier(text) };
+  add_token(type);
+  if (type == TokenType::t_identifier) { intern_token(text); }
 }
 
-void Scanner::process_integer_lit(char curr_char)
+void Scanner::process_integer_lit()
 {
-  std::string buffer{};
-  buffer.push_back(curr_char);
+  m_position = offset_of(integer_literal_end(cursor(m_start), source_end(), *m_kernels));
+  add_token(TokenType::t_integer_lit);
 
-  while (peek_next().has_value() && static_cast<bool>(std::isdigit(peek_next().value()))) {// NOLINT
-    char next_char = consume();
-    buffer.push_back(next_char);
+  // the value is read from the source when asked for, only range is checked here
+  std::string_view text{ m_source.view().substr(m_start, m_position - m_start) };
+  if (!integer_literal_in_range(text)) {
+    report_error(error::DiagnosticCode::integer_out_of_range, { text });
   }
-
-  int value = std::stoi(buffer);
-  add_token(TokenType::t_integer_lit, value);
 }
 
 void Scanner::process_char_lit()
 {
-  // TODO: process more chars other than letters only...:)
-  // just a stupid initial implementation, didn;t realize
-  std::locale c_loc("C");
-  if (peek_next().has_value() && std::isalpha(peek_next().value(), c_loc)) {
-    char value = consume();
-    if (peek_next().has_value() && peek_next().value() == '\'') {
-      add_token(TokenType::t_char_lit, value);
-      consume();
-    } else {
-      std::string message{ "Unterminated character, missing \"'\"" };
-      m_reporter.set_error(m_line, message);
+  // a char literal holds one byte or one escape and never spans lines
+  std::string_view rest{ m_source.view().substr(m_position) };
+  std::size_t length{ 0 };
+  if (!rest.empty() && rest.front() == '\\') {
+    length = escape_length(rest);
+    if (length == 0) {
+      report_error(error::DiagnosticCode::invalid_escape, { "character" });
+      length = std::min<std::size_t>(rest.size(), 2);
     }
+  } else if (!rest.empty() && rest.front() != '\'' && rest.front() != '\n') {
+    length = 1;
+  }
+
+  m_position += length;
+  if (match_next('\'')) {
+    if (length == 0) { report_error(error::DiagnosticCode::empty_char); }
+    add_token(TokenType::t_char_lit);
+  } else {
+    report_error(error::DiagnosticCode::unterminated_char);
   }
 }
 
 void Scanner::process_string_lit()
 {
-  std::string buffer{};
-  while (peek_next().has_value() && peek_next().value() != '"') {// NOLINT
-    // allow multi-line strings FOR NOW!!
-    // TODO: Disallow multi-line string literals
-    char next_char = consume();
-    if (next_char == '\n') {
-      m_line++;
-    } else {
-      buffer.push_back(next_char);
-    }
+  bool escaped{ false };
+  const char *quote{ quoted_literal_end(cursor(m_position), source_end(), '"', escaped, *m_kernels) };
+  if (quote == source_end()) {
+    m_position = m_source.size();
+    report_error(error::DiagnosticCode::unterminated_string);
+    return;
   }
 
-  consume();
-  add_token(TokenType::t_string_lit, buffer);
+  // allow multi-line strings FOR NOW!!
+  // TODO: Disallow multi-line string literals
+  m_position = offset_of(quote) + 1;
+  add_token(TokenType::t_string_lit);
+
+  // the value is decoded on demand, only escapes are checked here
+  std::string_view body{ m_source.view().substr(m_start + 1, m_position - m_start - 2) };
+  if (escaped && find_invalid_escape(body) != std::string_view::npos) {
+    report_error(error::DiagnosticCode::invalid_escape, { "string" });
+  }
+  if (m_interner != nullptr) { intern_token(literal_value(body, m_scratch)); }
 }
 
 void Scanner::process_comments()
 {
-  if (peek_next().has_value() && peek_next().value() == '*') {
-    consume();
-    while (peek_next().has_value()) {// NOLINT
-      if (peek_next().value() == '*') {
-        consume();
-        if (peek_next().has_value() && peek_next().value() == '/') {
-          consume();
-          break;
-        }
-        continue;
-      }
-    }
-  } else if (peek_next().has_value() && peek_next().value() == '/') {
-    consume();
-    while (peek_next().has_value() && peek_next().value() != '\n') {// NOLINT
-      consume();
+  if (match_next('*')) {
+    const char *star{ m_kernels->find_comment_end(cursor(m_position), source_end()) };
+    if (star == source_end()) {
+      m_position = m_source.size();
+      report_error(error::DiagnosticCode::unterminated_comment);
+      return;
     }
-    consume();
-    m_line++;
+    m_position = offset_of(star) + 2;
+  } else if (match_next('/')) {
+    // the comment runs to the end of the line, or of the source
+    const char *newline{ m_kernels->find_byte(cursor(m_position), source_end(), '\n') };
+    m_position = std::min(offset_of(newline) + 1, m_source.size());
   } else {
-    add_token(TokenType::t_slash, '/');
+    add_token(TokenType::t_slash);
   }
 }
 
-error::Status Scanner::get_status() const { return m_reporter.get_status(); }
+value_object Scanner::value(const ScannedToken &token) const
+{
+  const Lexeme &lexeme{ token.lexeme };
+  return derive_value(lexeme.type, m_source.slice(lexeme.offset, lexeme.length));
+}
+
+error::Status Scanner::get_status() const { return m_reporter->get_status(); }
 }// namespace blang
@@ -0,0 +1,268 @@
+#include "blang/sema/constant_folder.hpp"
+#include "blang/arithmetic.hpp"
+#include "blang/numeric_literal.hpp"
+#include <array>
+#include <optional>
+
+namespace blang::sema {
+
+ConstantFolder::ConstantFolder(const TokenStream &tokens,
+  const Ast &ast,
+  const TypeChecker &checker,
+  std::pmr::memory_resource *resource)
+  : m_tokens(&tokens), m_ast(&ast), m_checker(&checker), m_out(resource), m_known(ast.size(), Known::no),
+    m_values(ast.size(), 0), m_written(ast.size(), false), m_emitted(ast.size(), NO_NODE)
+{}
+
+Ast ConstantFolder::fold()
+{
+  find_writes();
+  for (NodeId node = 0; node < m_ast->size(); ++node) { evaluate(node); }
+
+  m_out.reserve(m_ast->size());
+  for (const NodeId root : m_ast->roots()) { m_out.add_root(emit(root)); }
+  m_stats.nodes_before = m_ast->size();
+  m_stats.nodes_after = m_out.size();
+  return std::move(m_out);
+}
+
+void ConstantFolder::find_writes()
+{
+  for (NodeId node = 0; node < m_ast->size(); ++node) {
+    const NodeKind kind{ m_ast->kind(node) };
+    const bool assignment{ kind == NodeKind::binary
+                           && m_tokens->type(m_ast->token(node)) == TokenType::t_equal };
+    if (!assignment && kind != NodeKind::postfix) { continue; }
+    NodeId target{ m_ast->lhs(node) };
+    while (m_ast->kind(target) == NodeKind::grouping) { target = m_ast->lhs(target); }
+    if (m_ast->kind(target) != NodeKind::variable) { continue; }
+    const NodeId declaration{ m_checker->declaration(target) };
+    if (declaration != NO_NODE) { m_written[declaration] = true; }
+  }
+}
+
+void ConstantFolder::evaluate(NodeId node)
+{
+  const NodeId lhs{ m_ast->lhs(node) };
+  switch (m_ast->kind(node)) {
+  case NodeKind::literal: {
+    const std::uint32_t token{ m_ast->token(node) };
+    switch (m_tokens->type(token)) {
+    case TokenType::t_integer_lit: {
+      // out of range literals were reported by the scanner and stay unknown
+      const std::optional<std::int64_t> value{ parse_integer_literal(m_tokens->text(token)) };
+      if (value) { set(node, Known::integer, *value); }
+      break;
+    }
+    case TokenType::t_true:
+      set(node, Known::boolean, 1);
+      break;
+    case TokenType::t_false:
+      set(node, Known::boolean, 0);
+      break;
+    default:
+      break;
+    }
+    break;
+  }
+  case NodeKind::integer_constant:
+    set(node, Known::integer, m_ast->constant(node));
+    break;
+  case NodeKind::boolean_constant:
+    set(node, Known::boolean, m_ast->constant(node));
+    break;
+  case NodeKind::variable: {
+    const NodeId declaration{ m_checker->declaration(node) };
+    if (declaration != NO_NODE) { set(node, m_known[declaration], m_values[declaration]); }
+    break;
+  }
+  case NodeKind::declaration: {
+    const Type *type{ m_checker->type(node) };
+    const NodeId initializer{ m_ast->extra(m_ast->rhs(node)) };
+    if (initializer == NO_NODE || m_written[node] || type == nullptr
+        || (type->kind != TypeKind::t_integer && type->kind != TypeKind::t_boolean)) {
+      break;
+    }
+    set(node, m_known[initializer], m_values[initializer]);
+    break;
+  }
+  case NodeKind::grouping:
+    set(node, m_known[lhs], m_values[lhs]);
+    break;
+  case NodeKind::unary:
+    if (m_tokens->type(m_ast->token(node)) == TokenType::t_bang) {
+      if (m_known[lhs] == Known::boolean) { set(node, Known::boolean, m_values[lhs] == 0 ? 1 : 0); }
+    } else if (m_known[lhs] == Known::integer) {
+      set(node, Known::integer, integer_negate(m_values[lhs]));
+    }
+    break;
+  case NodeKind::binary:
+    evaluate_binary(node);
+    break;
+  default:
+    break;
+  }
+}
+
+void ConstantFolder::evaluate_binary(NodeId node)
+{
+  const NodeId lhs{ m_ast->lhs(node) };
+  const NodeId rhs{ m_ast->rhs(node) };
+  const TokenType op{ m_tokens->type(m_ast->token(node)) };
+  switch (op) {
+  case TokenType::t_equal:
+    break;
+  case TokenType::t_and_and:
+  case TokenType::t_or_or: {
+    // the value that decides the result without the right operand
+    const std::int64_t decisive{ op == TokenType::t_or_or ? 1 : 0 };
+    if (m_known[lhs] != Known::boolean) { break; }
+    if (m_values[lhs] == decisive) {
+      set(node, Known::boolean, decisive);
+    } else if (m_known[rhs] == Known::boolean) {
+      set(node, Known::boolean, m_values[rhs]);
+    }
+    break;
+  }
+  case TokenType::t_equal_equal:
+  case TokenType::t_bang_equal:
+    if (m_known[lhs] != Known::no && m_known[lhs] == m_known[rhs]) {
+      set(node, Known::boolean, integer_compare(op, m_values[lhs], m_values[rhs]) ? 1 : 0);
+    }
+    break;
+  case TokenType::t_less_than:
+  case TokenType::t_less_equal:
+  case TokenType::t_greater_than:
+  case TokenType::t_greater_equal:
+    if (m_known[lhs] == Known::integer && m_known[rhs] == Known::integer) {
+      set(node, Known::boolean, integer_compare(op, m_values[lhs], m_values[rhs]) ? 1 : 0);
+    }
+    break;
+  default:
+    if (m_known[lhs] == Known::integer && m_known[rhs] == Known::integer) {
+      const std::optional<std::int64_t> value{ integer_binary(op, m_values[lhs], m_values[rhs]) };
+      if (value) { set(node, Known::integer, *value); }
+    }
+    break;
+  }
+}
+
+NodeId ConstantFolder::emit(NodeId node)
+{
+  if (m_emitted[node] == NO_NODE) { m_emitted[node] = emit_node(node); }
+  return m_emitted[node];
+}
+
+NodeId ConstantFolder::emit_node(NodeId node)
+{
+  const NodeKind kind{ m_ast->kind(node) };
+  const std::uint32_t token{ m_ast->token(node) };
+  const NodeId lhs{ m_ast->lhs(node) };
+  const NodeId rhs{ m_ast->rhs(node) };
+
+  // expressions with a value, apart from the literals already spelling it
+  const bool expression{ kind == NodeKind::variable || kind == NodeKind::grouping || kind == NodeKind::unary
+                         || kind == NodeKind::binary };
+  if (expression && m_known[node] != Known::no) {
+    if (kind == NodeKind::variable) {
+      m_stats.propagated++;
+    } else {
+      m_stats.folded++;
+    }
+    const NodeKind constant{ m_known[node] == Known::integer ? NodeKind::integer_constant
+                                                              : NodeKind::boolean_constant };
+    return m_out.add_constant(constant, token, m_values[node]);
+  }
+
+  switch (kind) {
+  case NodeKind::binary: {
+    // `true && x` and `false || x` are x
+    const TokenType op{ m_tokens->type(token) };
+    if ((op == TokenType::t_and_and || op == TokenType::t_or_or) && m_known[lhs] == Known::boolean) {
+      m_stats.folded++;
+      return emit(rhs);
+    }
+    const NodeId left{ emit(lhs) };
+    return m_out.add(kind, token, left, emit(rhs));
+  }
+  case NodeKind::subscript:
+  case NodeKind::while_stmt:
+  case NodeKind::array_type: {
+    if (kind == NodeKind::while_stmt && m_known[lhs] == Known::boolean && m_values[lhs] == 0) {
+      m_stats.pruned++;
+      return empty_block(node);
+    }
+    const NodeId left{ emit_optional(lhs) };
+    return m_out.add(kind, token, left, emit(rhs));
+  }
+  case NodeKind::call:
+  case NodeKind::function_type: {
+    const NodeId left{ emit(lhs) };
+    return m_out.add(kind, token, left, emit_list(rhs));
+  }
+  case NodeKind::grouping:
+  case NodeKind::postfix:
+  case NodeKind::unary:
+  case NodeKind::expression_stmt:
+  case NodeKind::return_stmt:
+  case NodeKind::param:
+    return m_out.add(kind, token, emit_optional(lhs));
+  case NodeKind::init_list:
+  case NodeKind::block:
+  case NodeKind::print_stmt:
+    return m_out.add(kind, token, NO_NODE, emit_list(rhs));
+  case NodeKind::declaration: {
+    const NodeId type{ emit(lhs) };
+    return m_out.add(kind, token, type, emit_extra(rhs, 2));
+  }
+  case NodeKind::for_stmt: {
+    const std::uint32_t clauses{ emit_extra(lhs, 3) };
+    return m_out.add(kind, token, clauses, emit(rhs));
+  }
+  case NodeKind::if_stmt: {
+    if (m_known[lhs] == Known::boolean) {
+      m_stats.pruned++;
+      const NodeId taken{ m_ast->extra(rhs + (m_values[lhs] != 0 ? 0 : 1)) };
+      if (taken == NO_NODE) { return empty_block(node); }
+      // a lone declaration keeps the scope the if gave it
+      if (m_ast->kind(taken) != NodeKind::declaration) { return emit(taken); }
+      const std::array<NodeId, 1> scoped{ emit(taken) };
+      return m_out.add(NodeKind::block, token, NO_NODE, m_out.add_list(scoped));
+    }
+    const NodeId condition{ emit(lhs) };
+    return m_out.add(kind, token, condition, emit_extra(rhs, 2));
+  }
+  default:
+    // literals, constants, variables and primitive types
+    return m_out.add(kind, token, lhs, rhs);
+  }
+}
+
+std::uint32_t ConstantFolder::emit_list(std::uint32_t list)
+{
+  const std::size_t mark{ m_scratch.size() };
+  for (const NodeId item : m_ast->list(list)) {
+    const NodeId emitted{ emit(item) };
+    m_scratch.push_back(emitted);
+  }
+  const auto first{ m_scratch.begin() + static_cast<std::ptrdiff_t>(mark) };
+  const std::uint32_t emitted{ m_out.add_list({ first, m_scratch.end() }) };
+  m_scratch.erase(first, m_scratch.end());
+  return emitted;
+}
+
+std::uint32_t ConstantFolder::emit_extra(std::uint32_t index, std::size_t count)
+{
+  std::array<NodeId, 3> children{ NO_NODE, NO_NODE, NO_NODE };
+  for (std::uint32_t child = 0; child < count; ++child) {
+    children.at(child) = emit_optional(m_ast->extra(index + child));
+  }
+  return m_out.add_extra(std::span<const NodeId>{ children }.first(count));
+}
+
+NodeId ConstantFolder::empty_block(NodeId node)
+{
+  return m_out.add(NodeKind::block, m_ast->token(node), NO_NODE, m_out.add_list({}));
+}
+
+}// namespace blang::sema
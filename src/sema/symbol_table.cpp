@@ -0,0 +1,85 @@
+#include "blang/sema/symbol_table.hpp"
+
+namespace blang::sema {
+
+SymbolTable::SymbolTable() : m_scopes{ 0 }, m_slots(MIN_CAPACITY) {}
+
+SymbolTable::SymbolTable(const SymbolTable &outer, std::size_t visible)
+  : m_outer(&outer), m_visible(visible), m_scopes{ 0 }, m_slots(MIN_CAPACITY)
+{}
+
+std::size_t SymbolTable::probe(Atom name) const
+{
+  // atoms are dense within a shard, so the same finalizer-style mix as the
+  // hash-consing table spreads them
+  std::uint64_t hash{ static_cast<std::uint32_t>(name) };
+  hash *= 0x9E3779B97F4A7C15;// NOLINT
+  hash ^= hash >> 32U;// NOLINT
+  const std::size_t mask{ m_slots.size() - 1 };
+  for (std::size_t index{ hash & mask };; index = (index + 1) & mask) {
+    const Slot &slot{ m_slots[index] };
+    if (slot.name == name || slot.name == NO_ATOM) { return index; }
+  }
+}
+
+void SymbolTable::grow()
+{
+  std::vector<Slot> old{ std::move(m_slots) };
+  m_slots.assign(old.size() * 2, Slot{});
+  for (const Slot &slot : old) {
+    if (slot.name != NO_ATOM) { m_slots[probe(slot.name)] = slot; }
+  }
+}
+
+void SymbolTable::pop_scope()
+{
+  const std::uint32_t mark{ m_scopes.back() };
+  m_scopes.pop_back();
+  while (m_bindings.size() > mark) {
+    const Symbol &symbol{ m_bindings.back() };
+    m_slots[probe(symbol.name)].binding = symbol.shadowed;
+    m_bindings.pop_back();
+  }
+}
+
+std::uint32_t SymbolTable::binding(Atom name, std::size_t visible) const
+{
+  std::uint32_t binding{ m_slots[probe(name)].binding };
+  while (binding != NO_BINDING && binding >= visible) { binding = m_bindings[binding].shadowed; }
+  return binding;
+}
+
+const Symbol *SymbolTable::find(Atom name) const
+{
+  const std::uint32_t own{ m_slots[probe(name)].binding };
+  if (own != NO_BINDING) { return &m_bindings[own]; }
+  if (m_outer == nullptr) { return nullptr; }
+  const std::uint32_t outer{ m_outer->binding(name, m_visible) };
+  return outer == NO_BINDING ? nullptr : &m_outer->m_bindings[outer];
+}
+
+Symbol *SymbolTable::find_local(Atom name)
+{
+  const std::uint32_t binding{ m_slots[probe(name)].binding };
+  return binding == NO_BINDING || binding < m_scopes.back() ? nullptr : &m_bindings[binding];
+}
+
+Symbol &SymbolTable::declare(Atom name, const Type *type, NodeId declaration, bool defined)
+{
+  std::size_t index{ probe(name) };
+  if (m_slots[index].name == NO_ATOM) {
+    // at most half full, so probes stay short and always find an empty slot
+    if ((m_used + 1) * 2 > m_slots.size()) {
+      grow();
+      index = probe(name);
+    }
+    m_slots[index].name = name;
+    m_used++;
+  }
+  Slot &slot{ m_slots[index] };
+  m_bindings.push_back(Symbol{ name, type, declaration, slot.binding, defined });
+  slot.binding = static_cast<std::uint32_t>(m_bindings.size() - 1);
+  return m_bindings.back();
+}
+
+}// namespace blang::sema
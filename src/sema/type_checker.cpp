@@ -0,0 +1,477 @@
+#include "blang/sema/type_checker.hpp"
+#include <algorithm>
+#include <future>
+#include <string>
+
+namespace blang::sema {
+
+TypeChecker::TypeChecker(const TokenStream &tokens,
+  const Ast &ast,
+  TypeTable &types,
+  Interner &interner,
+  error::ErrorReporter &reporter)
+  : m_tokens(&tokens), m_ast(&ast), m_table(&types), m_interner(&interner), m_reporter(&reporter),
+    m_type_storage(ast.size(), nullptr), m_declaration_storage(ast.size(), NO_NODE), m_types(m_type_storage),
+    m_declarations(m_declaration_storage)
+{}
+
+TypeChecker::TypeChecker(const TypeChecker &parent)
+  : m_tokens(parent.m_tokens), m_ast(parent.m_ast), m_table(parent.m_table), m_interner(parent.m_interner),
+    m_reporter(parent.m_reporter), m_file(parent.m_file), m_symbols(parent.m_symbols, 0),
+    m_types(parent.m_types), m_declarations(parent.m_declarations)
+{}
+
+bool TypeChecker::check()
+{
+  for (const NodeId root : m_ast->roots()) { statement(root); }
+  return !m_failed;
+}
+
+bool TypeChecker::check(util::ThreadPool &pool)
+{
+  m_defer = true;
+  for (const NodeId root : m_ast->roots()) { statement(root); }
+  m_defer = false;
+  if (m_deferred.empty()) { return !m_failed; }
+
+  // cut the bodies into batches of about the same number of nodes, which is
+  // what lies between one deferred declaration and the next
+  const std::size_t batch_count{ std::min(m_deferred.size(), pool.size() * BATCHES_PER_THREAD) };
+  const std::size_t batch_nodes{ m_deferred.back().declaration / batch_count + 1 };
+  std::vector<std::future<bool>> batches;
+  batches.reserve(batch_count + 1);
+  std::size_t first{ 0 };
+  NodeId start{ 0 };
+  for (std::size_t index = 0; index < m_deferred.size(); ++index) {
+    const NodeId end{ m_deferred[index].declaration };
+    if (end - start < batch_nodes && index + 1 < m_deferred.size()) { continue; }
+    const std::span<const DeferredBody> batch{ std::span{ m_deferred }.subspan(first, index + 1 - first) };
+    batches.push_back(pool.submit([this, batch] { return check_bodies(batch); }));
+    first = index + 1;
+    start = end;
+  }
+  bool clean{ !m_failed };
+  for (std::future<bool> &batch : batches) { clean = batch.get() && clean; }
+  m_deferred.clear();
+  return clean;
+}
+
+bool TypeChecker::check_bodies(std::span<const DeferredBody> bodies)
+{
+  TypeChecker checker{ *this };
+  for (const DeferredBody &body : bodies) {
+    checker.m_symbols.set_visible(body.visible);
+    const NodeId type{ m_ast->lhs(body.declaration) };
+    checker.function_body(type, m_types[type], m_ast->extra(m_ast->rhs(body.declaration) + 1));
+  }
+  return !checker.m_failed;
+}
+
+void TypeChecker::report(NodeId node, error::DiagnosticCode code, std::initializer_list<std::string_view> args)
+{
+  m_failed = true;
+  // registered on the first error, so a clean check never touches the reporter
+  if (!m_file) { m_file = m_reporter->add_source(m_tokens->source()); }
+  const std::uint32_t token{ m_ast->token(node) };
+  m_reporter->report(*m_file, code, error::Span{ m_tokens->offset(token), m_tokens->length(token) }, args);
+}
+
+Atom TypeChecker::name(NodeId node)
+{
+  const std::uint32_t token{ m_ast->token(node) };
+  const Atom atom{ m_tokens->atom(token) };
+  return atom != NO_ATOM ? atom : m_interner->intern(m_tokens->text(token));
+}
+
+bool TypeChecker::storable(const Type *type)
+{
+  switch (type->kind) {
+  case TypeKind::t_void:
+  case TypeKind::t_function:
+    return false;
+  case TypeKind::t_array:
+    return storable(type->inner);
+  default:
+    return true;
+  }
+}
+
+bool TypeChecker::scalar(const Type *type)
+{
+  return type->kind == TypeKind::t_boolean || type->kind == TypeKind::t_char || type->kind == TypeKind::t_integer
+         || type->kind == TypeKind::t_string;
+}
+
+void TypeChecker::statement(NodeId node)
+{
+  switch (m_ast->kind(node)) {
+  case NodeKind::block:
+    block(node);
+    break;
+  case NodeKind::declaration:
+    declaration_stmt(node);
+    break;
+  case NodeKind::expression_stmt:
+    expression(m_ast->lhs(node));
+    break;
+  case NodeKind::print_stmt:
+    for (const NodeId value : m_ast->list(m_ast->rhs(node))) {
+      const Type *type{ expression(value) };
+      if (type != m_table->error() && !scalar(type)) {
+        report(value, error::DiagnosticCode::invalid_operand, { "print", type_name(type) });
+      }
+    }
+    break;
+  case NodeKind::return_stmt: {
+    const NodeId value{ m_ast->lhs(node) };
+    const Type *type{ value == NO_NODE ? m_table->primitive(TypeKind::t_void) : expression(value) };
+    if (m_returns.empty()) {
+      report(node, error::DiagnosticCode::misplaced_return);
+    } else {
+      expect(value == NO_NODE ? node : value, m_returns.back(), type, "in return");
+    }
+    break;
+  }
+  case NodeKind::if_stmt: {
+    condition(m_ast->lhs(node));
+    body(m_ast->extra(m_ast->rhs(node)));
+    const NodeId else_branch{ m_ast->extra(m_ast->rhs(node) + 1) };
+    if (else_branch != NO_NODE) { body(else_branch); }
+    break;
+  }
+  case NodeKind::while_stmt:
+    condition(m_ast->lhs(node));
+    body(m_ast->rhs(node));
+    break;
+  case NodeKind::for_stmt: {
+    const std::uint32_t clauses{ m_ast->lhs(node) };
+    if (m_ast->extra(clauses) != NO_NODE) { expression(m_ast->extra(clauses)); }
+    if (m_ast->extra(clauses + 1) != NO_NODE) { condition(m_ast->extra(clauses + 1)); }
+    if (m_ast->extra(clauses + 2) != NO_NODE) { expression(m_ast->extra(clauses + 2)); }
+    body(m_ast->rhs(node));
+    break;
+  }
+  default:
+    break;
+  }
+}
+
+void TypeChecker::block(NodeId node)
+{
+  m_symbols.push_scope();
+  for (const NodeId stmt : m_ast->list(m_ast->rhs(node))) { statement(stmt); }
+  m_symbols.pop_scope();
+}
+
+void TypeChecker::body(NodeId node)
+{
+  m_symbols.push_scope();
+  statement(node);
+  m_symbols.pop_scope();
+}
+
+void TypeChecker::declaration_stmt(NodeId node)
+{
+  const Type *type{ type_spec(m_ast->lhs(node)) };
+  const NodeId initializer{ m_ast->extra(m_ast->rhs(node)) };
+  const NodeId body{ m_ast->extra(m_ast->rhs(node) + 1) };
+  const Atom atom{ name(node) };
+  const std::string_view text{ m_tokens->text(m_ast->token(node)) };
+
+  if (type->kind == TypeKind::t_function) {
+    if (type->inner->kind == TypeKind::t_array || type->inner->kind == TypeKind::t_function) {
+      report(node, error::DiagnosticCode::invalid_declaration_type, { text, type_name(type) });
+    }
+    record_type(node, type);
+    // a prototype may be repeated, and then defined once
+    Symbol *existing{ m_symbols.find_local(atom) };
+    if (existing == nullptr) {
+      m_symbols.declare(atom, type, node, body != NO_NODE);
+    } else if (existing->type != type || (existing->defined && body != NO_NODE)) {
+      report(node, error::DiagnosticCode::redeclared_name, { text });
+    } else if (body != NO_NODE) {
+      existing->defined = true;
+    }
+    if (body == NO_NODE) { return; }
+    if (m_defer && m_symbols.depth() == 1) {
+      m_deferred.push_back(DeferredBody{ node, m_symbols.bindings() });
+    } else {
+      function_body(m_ast->lhs(node), type, body);
+    }
+    return;
+  }
+
+  // the initializer is checked before the name is in scope
+  if (initializer != NO_NODE) {
+    if (m_ast->kind(initializer) == NodeKind::init_list) {
+      init_list(initializer, type);
+    } else {
+      expect(initializer, type, expression(initializer), "in initializer");
+    }
+  }
+  if (!storable(type)) {
+    report(node, error::DiagnosticCode::invalid_declaration_type, { text, type_name(type) });
+    type = m_table->error();
+  }
+  record_type(node, type);
+  if (m_symbols.find_local(atom) != nullptr) {
+    report(node, error::DiagnosticCode::redeclared_name, { text });
+  } else {
+    m_symbols.declare(atom, type, node);
+  }
+}
+
+void TypeChecker::function_body(NodeId node, const Type *type, NodeId body)
+{
+  m_returns.push_back(type->inner);
+  // the parameters and the outermost block of the body share a scope
+  m_symbols.push_scope();
+  for (const NodeId param : m_ast->list(m_ast->rhs(node))) {
+    const Atom atom{ name(param) };
+    if (m_symbols.find_local(atom) != nullptr) {
+      report(param, error::DiagnosticCode::redeclared_name, { m_tokens->text(m_ast->token(param)) });
+    } else {
+      m_symbols.declare(atom, m_types[param], param);
+    }
+  }
+  for (const NodeId stmt : m_ast->list(m_ast->rhs(body))) { statement(stmt); }
+  m_symbols.pop_scope();
+  m_returns.pop_back();
+}
+
+void TypeChecker::condition(NodeId node) { expect(node, m_table->boolean(), expression(node), "in condition"); }
+
+void TypeChecker::init_list(NodeId node, const Type *type)
+{
+  if (type->kind != TypeKind::t_array) {
+    if (type != m_table->error()) {
+      report(node, error::DiagnosticCode::type_mismatch, { "in initializer", type_name(type), "initializer list" });
+    }
+    return;
+  }
+  for (const NodeId element : m_ast->list(m_ast->rhs(node))) {
+    if (m_ast->kind(element) == NodeKind::init_list) {
+      init_list(element, type->inner);
+    } else {
+      expect(element, type->inner, expression(element), "in initializer list");
+    }
+  }
+}
+
+const Type *TypeChecker::type_spec(NodeId node)
+{
+  const Type *type{ m_table->error() };
+  switch (m_ast->kind(node)) {
+  case NodeKind::primitive_type:
+    switch (m_tokens->type(m_ast->token(node))) {
+    case TokenType::t_integer:
+      type = m_table->integer();
+      break;
+    case TokenType::t_boolean:
+      type = m_table->boolean();
+      break;
+    case TokenType::t_char:
+      type = m_table->primitive(TypeKind::t_char);
+      break;
+    case TokenType::t_string:
+      type = m_table->primitive(TypeKind::t_string);
+      break;
+    default:
+      type = m_table->primitive(TypeKind::t_void);
+      break;
+    }
+    break;
+  case NodeKind::array_type: {
+    const NodeId size{ m_ast->lhs(node) };
+    if (size != NO_NODE) { expect(size, m_table->integer(), expression(size), "in array size"); }
+    const Type *element{ type_spec(m_ast->rhs(node)) };
+    type = element == m_table->error() ? element : m_table->array(element);
+    break;
+  }
+  case NodeKind::function_type: {
+    const Type *returns{ type_spec(m_ast->lhs(node)) };
+    const std::size_t mark{ m_params.size() };
+    for (const NodeId param : m_ast->list(m_ast->rhs(node))) {
+      const Type *param_type{ type_spec(m_ast->lhs(param)) };
+      if (!storable(param_type)) {
+        report(param, error::DiagnosticCode::invalid_declaration_type,
+          { m_tokens->text(m_ast->token(param)), type_name(param_type) });
+        param_type = m_table->error();
+      }
+      record_type(param, param_type);
+      m_params.push_back(param_type);
+    }
+    type = m_table->function(returns, std::span<const Type *const>{ m_params }.subspan(mark));
+    m_params.resize(mark);
+    break;
+  }
+  default:
+    break;
+  }
+  record_type(node, type);
+  return type;
+}
+
+const Type *TypeChecker::expression(NodeId node)
+{
+  const Type *type{ m_table->error() };
+  switch (m_ast->kind(node)) {
+  case NodeKind::literal:
+    switch (m_tokens->type(m_ast->token(node))) {
+    case TokenType::t_integer_lit:
+      type = m_table->integer();
+      break;
+    case TokenType::t_char_lit:
+      type = m_table->primitive(TypeKind::t_char);
+      break;
+    case TokenType::t_string_lit:
+      type = m_table->primitive(TypeKind::t_string);
+      break;
+    default:
+      type = m_table->boolean();
+      break;
+    }
+    break;
+  case NodeKind::integer_constant:
+    type = m_table->integer();
+    break;
+  case NodeKind::boolean_constant:
+    type = m_table->boolean();
+    break;
+  case NodeKind::variable: {
+    const Symbol *symbol{ m_symbols.find(name(node)) };
+    if (symbol == nullptr) {
+      report(node, error::DiagnosticCode::undeclared_name, { m_tokens->text(m_ast->token(node)) });
+      record_declaration(node, NO_NODE);
+    } else {
+      record_declaration(node, symbol->declaration);
+      type = symbol->type;
+    }
+    break;
+  }
+  case NodeKind::grouping:
+    type = expression(m_ast->lhs(node));
+    break;
+  case NodeKind::unary: {
+    const bool negation{ m_tokens->type(m_ast->token(node)) == TokenType::t_bang };
+    type = negation ? m_table->boolean() : m_table->integer();
+    operand(node, m_ast->lhs(node), type, expression(m_ast->lhs(node)));
+    break;
+  }
+  case NodeKind::postfix: {
+    const NodeId target{ m_ast->lhs(node) };
+    if (m_ast->kind(target) != NodeKind::variable && m_ast->kind(target) != NodeKind::subscript) {
+      report(node, error::DiagnosticCode::invalid_assignment_target);
+    }
+    type = m_table->integer();
+    operand(node, target, type, expression(target));
+    break;
+  }
+  case NodeKind::subscript: {
+    const Type *array{ expression(m_ast->lhs(node)) };
+    expect(m_ast->rhs(node), m_table->integer(), expression(m_ast->rhs(node)), "in subscript");
+    if (array->kind == TypeKind::t_array) {
+      type = array->inner;
+    } else if (array != m_table->error()) {
+      report(m_ast->lhs(node), error::DiagnosticCode::not_an_array, { type_name(array) });
+    }
+    break;
+  }
+  case NodeKind::binary:
+    type = binary(node);
+    break;
+  case NodeKind::call:
+    type = call(node);
+    break;
+  default:
+    // an initializer list outside of a declaration, which the parser never
+    // produces
+    break;
+  }
+  record_type(node, type);
+  return type;
+}
+
+const Type *TypeChecker::binary(NodeId node)
+{
+  const NodeId lhs{ m_ast->lhs(node) };
+  const NodeId rhs{ m_ast->rhs(node) };
+  const Type *left{ expression(lhs) };
+  const Type *right{ expression(rhs) };
+  const Type *integer{ m_table->integer() };
+  const Type *boolean{ m_table->boolean() };
+  // operators with the wrong operands still give their usual type, so only
+  // the operator is reported and not everything over it
+  switch (m_tokens->type(m_ast->token(node))) {
+  case TokenType::t_equal:
+    if (left != m_table->error() && !scalar(left)) {
+      report(lhs, error::DiagnosticCode::invalid_operand, { "=", type_name(left) });
+    } else {
+      expect(rhs, left, right, "in assignment");
+    }
+    return left;
+  case TokenType::t_less_than:
+  case TokenType::t_less_equal:
+  case TokenType::t_greater_than:
+  case TokenType::t_greater_equal:
+    operand(node, lhs, integer, left);
+    operand(node, rhs, integer, right);
+    return boolean;
+  case TokenType::t_equal_equal:
+  case TokenType::t_bang_equal:
+    if (left == m_table->error() || right == m_table->error()) { return boolean; }
+    if (!scalar(left)) {
+      report(lhs, error::DiagnosticCode::invalid_operand, { m_tokens->text(m_ast->token(node)), type_name(left) });
+    } else {
+      expect(rhs, left, right, "in comparison");
+    }
+    return boolean;
+  case TokenType::t_and_and:
+  case TokenType::t_or_or:
+    operand(node, lhs, boolean, left);
+    operand(node, rhs, boolean, right);
+    return boolean;
+  default:
+    operand(node, lhs, integer, left);
+    operand(node, rhs, integer, right);
+    return integer;
+  }
+}
+
+const Type *TypeChecker::call(NodeId node)
+{
+  const Type *callee{ expression(m_ast->lhs(node)) };
+  const std::span<const NodeId> arguments{ m_ast->list(m_ast->rhs(node)) };
+  if (callee->kind != TypeKind::t_function) {
+    for (const NodeId argument : arguments) { expression(argument); }
+    if (callee != m_table->error()) {
+      report(m_ast->lhs(node), error::DiagnosticCode::not_callable, { type_name(callee) });
+    }
+    return m_table->error();
+  }
+  if (arguments.size() != callee->params.size()) {
+    for (const NodeId argument : arguments) { expression(argument); }
+    report(node,
+      error::DiagnosticCode::argument_count,
+      { std::to_string(callee->params.size()), std::to_string(arguments.size()) });
+    return callee->inner;
+  }
+  for (std::size_t index = 0; index < arguments.size(); ++index) {
+    expect(arguments[index], callee->params[index], expression(arguments[index]), "in argument");
+  }
+  return callee->inner;
+}
+
+void TypeChecker::expect(NodeId node, const Type *expected, const Type *found, std::string_view where)
+{
+  if (found == expected || found == m_table->error() || expected == m_table->error()) { return; }
+  report(node, error::DiagnosticCode::type_mismatch, { where, type_name(expected), type_name(found) });
+}
+
+void TypeChecker::operand(NodeId op, NodeId node, const Type *expected, const Type *found)
+{
+  if (found == expected || found == m_table->error()) { return; }
+  report(node, error::DiagnosticCode::invalid_operand, { m_tokens->text(m_ast->token(op)), type_name(found) });
+}
+
+}// namespace blang::sema
@@ -0,0 +1,99 @@
+#include "blang/sema/types.hpp"
+#include <algorithm>
+#include <functional>
+#include <mutex>
+
+namespace blang::sema {
+
+TypeTable::TypeTable()
+  : m_primitives{ { { TypeKind::t_error, nullptr, {} },
+    { TypeKind::t_void, nullptr, {} },
+    { TypeKind::t_boolean, nullptr, {} },
+    { TypeKind::t_char, nullptr, {} },
+    { TypeKind::t_integer, nullptr, {} },
+    { TypeKind::t_string, nullptr, {} } } }
+{}
+
+std::size_t TypeTable::size() const
+{
+  const std::shared_lock lock{ m_mutex };
+  return m_primitives.size() + m_arrays.size() + m_functions.size();
+}
+
+std::size_t TypeTable::SignatureHash::operator()(const Signature &signature) const
+{
+  std::size_t hash{ std::hash<const Type *>{}(signature.returns) };
+  for (const Type *type : signature.params) {
+    hash = (hash * 31) ^ std::hash<const Type *>{}(type);// NOLINT
+  }
+  return hash;
+}
+
+bool TypeTable::SignatureEqual::equal(const Signature &lhs, const Signature &rhs)
+{
+  return lhs.returns == rhs.returns && std::ranges::equal(lhs.params, rhs.params);
+}
+
+const Type *TypeTable::array(const Type *element)
+{
+  {
+    const std::shared_lock lock{ m_mutex };
+    const auto found{ m_arrays.find(element) };
+    if (found != m_arrays.end()) { return found->second; }
+  }
+  const std::unique_lock lock{ m_mutex };
+  auto [slot, inserted] = m_arrays.try_emplace(element, nullptr);
+  if (inserted) { slot->second = m_arena.create<Type>(Type{ TypeKind::t_array, element, {} }); }
+  return slot->second;
+}
+
+const Type *TypeTable::function(const Type *returns, std::span<const Type *const> params)
+{
+  const Signature signature{ returns, params };
+  {
+    const std::shared_lock lock{ m_mutex };
+    const auto found{ m_functions.find(signature) };
+    if (found != m_functions.end()) { return *found; }
+  }
+  const std::unique_lock lock{ m_mutex };
+  // another checker may have made it since the lookup
+  const auto found{ m_functions.find(signature) };
+  if (found != m_functions.end()) { return *found; }
+
+  const std::span<const Type *> copy{ m_arena.make_array<const Type *>(params.size()) };
+  std::copy(params.begin(), params.end(), copy.begin());
+  const Type *type{ m_arena.create<Type>(Type{ TypeKind::t_function, returns, copy }) };
+  m_functions.insert(type);
+  return type;
+}
+
+std::string type_name(const Type *type)
+{
+  switch (type->kind) {
+  case TypeKind::t_error:
+    return "<error>";
+  case TypeKind::t_void:
+    return "void";
+  case TypeKind::t_boolean:
+    return "boolean";
+  case TypeKind::t_char:
+    return "char";
+  case TypeKind::t_integer:
+    return "integer";
+  case TypeKind::t_string:
+    return "string";
+  case TypeKind::t_array:
+    return "array [] " + type_name(type->inner);
+  case TypeKind::t_function: {
+    std::string name{ "function " + type_name(type->inner) + " (" };
+    for (std::size_t index = 0; index < type->params.size(); ++index) {
+      if (index > 0) { name += ", "; }
+      name += type_name(type->params[index]);
+    }
+    return name + ")";
+  }
+  }
+  return "";
+}
+
+}// namespace blang::sema
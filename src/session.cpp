@@ -0,0 +1,31 @@
+#include "blang/session.hpp"
+#include "blang/parser.hpp"
+#include "blang/scanner.hpp"
+
+namespace blang {
+
+Session::Session(std::size_t page_size, std::size_t max_errors) : m_max_errors(max_errors), m_arena(page_size)
+{
+  m_reporter.emplace(m_max_errors);
+}
+
+SourceBuffer Session::add_source(std::string_view text) { return SourceBuffer::borrow(m_arena.copy(text)); }
+
+TokenStream Session::scan(const SourceBuffer &source)
+{
+  Scanner scanner{ source, *m_reporter };
+  return scanner.scan(&m_arena);
+}
+
+Ast Session::parse_program(const TokenStream &tokens)
+{
+  return Parser{ tokens, *m_reporter, &m_arena }.parse_program();
+}
+
+void Session::reset()
+{
+  m_reporter.emplace(m_max_errors);
+  m_arena.release();
+}
+
+}// namespace blang
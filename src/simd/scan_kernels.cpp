@@ -0,0 +1,310 @@
+#include "blang/simd/scan_kernels.hpp"
+#include <algorithm>
+#include <cstring>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define BLANG_X86_KERNELS 1
+#include <immintrin.h>
+#endif
+
+namespace blang::simd {
+
+namespace {
+
+  // NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+
+  // Scalar fallbacks, also used for the tails the vector loops leave over.
+
+  const char *skip_whitespace_scalar(const char *first, const char *last)
+  {
+    return std::find_if_not(first, last, [](char chh) { return has_class(chh, c_blank); });
+  }
+
+  const char *identifier_end_scalar(const char *first, const char *last)
+  {
+    return std::find_if_not(first, last, is_identifier_char);
+  }
+
+  const char *digits_end_scalar(const char *first, const char *last) { return std::find_if_not(first, last, is_digit); }
+
+  const char *find_byte_scalar(const char *first, const char *last, char byte)
+  {
+    const void *found = std::memchr(first, byte, static_cast<std::size_t>(last - first));
+    return found != nullptr ? static_cast<const char *>(found) : last;
+  }
+
+  std::size_t count_byte_scalar(const char *first, const char *last, char byte)
+  {
+    return static_cast<std::size_t>(std::count(first, last, byte));
+  }
+
+  const char *find_comment_end_scalar(const char *first, const char *last)
+  {
+    while (first != last) {
+      first = find_byte_scalar(first, last, '*');
+      if (first == last || first + 1 == last) { return last; }
+      if (first[1] == '/') { return first; }
+      ++first;
+    }
+    return last;
+  }
+
+#ifdef BLANG_X86_KERNELS
+
+  // SSE2 kernels, 16 bytes per step. SSE2 is part of the x86-64 baseline.
+
+  constexpr std::ptrdiff_t SSE_WIDTH = 16;
+  constexpr unsigned SSE_ALL = 0xFFFFU;
+
+  inline __m128i sse_load(const char *ptr) { return _mm_loadu_si128(reinterpret_cast<const __m128i *>(ptr)); }// NOLINT
+
+  // bytes in [lo, hi]; bytes >= 0x80 compare as negative and never match
+  inline __m128i sse_in_range(__m128i bytes, char lo, char hi)
+  {
+    return _mm_and_si128(_mm_cmpgt_epi8(bytes, _mm_set1_epi8(static_cast<char>(lo - 1))),
+      _mm_cmplt_epi8(bytes, _mm_set1_epi8(static_cast<char>(hi + 1))));
+  }
+
+  inline __m128i sse_identifier_mask(__m128i bytes)
+  {
+    __m128i lower = _mm_or_si128(bytes, _mm_set1_epi8(0x20));
+    __m128i alpha = sse_in_range(lower, 'a', 'z');
+    __m128i digit = sse_in_range(bytes, '0', '9');
+    __m128i under = _mm_cmpeq_epi8(bytes, _mm_set1_epi8('_'));
+    return _mm_or_si128(_mm_or_si128(alpha, digit), under);
+  }
+
+  const char *skip_whitespace_sse2(const char *first, const char *last)
+  {
+    while (last - first >= SSE_WIDTH) {
+      __m128i bytes = sse_load(first);
+      __m128i blank =
+        _mm_or_si128(_mm_cmpeq_epi8(bytes, _mm_set1_epi8('\n')), _mm_cmpeq_epi8(bytes, _mm_set1_epi8(' ')));
+      auto blank_bits = static_cast<unsigned>(_mm_movemask_epi8(blank));
+      if (blank_bits != SSE_ALL) { return first + __builtin_ctz(~blank_bits); }
+      first += SSE_WIDTH;
+    }
+    return skip_whitespace_scalar(first, last);
+  }
+
+  const char *identifier_end_sse2(const char *first, const char *last)
+  {
+    while (last - first >= SSE_WIDTH) {
+      auto bits = static_cast<unsigned>(_mm_movemask_epi8(sse_identifier_mask(sse_load(first))));
+      if (bits != SSE_ALL) { return first + __builtin_ctz(~bits); }
+      first += SSE_WIDTH;
+    }
+    return identifier_end_scalar(first, last);
+  }
+
+  const char *digits_end_sse2(const char *first, const char *last)
+  {
+    while (last - first >= SSE_WIDTH) {
+      auto bits = static_cast<unsigned>(_mm_movemask_epi8(sse_in_range(sse_load(first), '0', '9')));
+      if (bits != SSE_ALL) { return first + __builtin_ctz(~bits); }
+      first += SSE_WIDTH;
+    }
+    return digits_end_scalar(first, last);
+  }
+
+  const char *find_byte_sse2(const char *first, const char *last, char byte)
+  {
+    __m128i needle = _mm_set1_epi8(byte);
+    while (last - first >= SSE_WIDTH) {
+      auto bits = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(sse_load(first), needle)));
+      if (bits != 0U) { return first + __builtin_ctz(bits); }
+      first += SSE_WIDTH;
+    }
+    return find_byte_scalar(first, last, byte);
+  }
+
+  std::size_t count_byte_sse2(const char *first, const char *last, char byte)
+  {
+    __m128i needle = _mm_set1_epi8(byte);
+    std::size_t count{ 0 };
+    while (last - first >= SSE_WIDTH) {
+      auto bits = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(sse_load(first), needle)));
+      count += static_cast<std::size_t>(__builtin_popcount(bits));
+      first += SSE_WIDTH;
+    }
+    return count + count_byte_scalar(first, last, byte);
+  }
+
+  const char *find_comment_end_sse2(const char *first, const char *last)
+  {
+    while (last - first > SSE_WIDTH) {
+      __m128i star = _mm_cmpeq_epi8(sse_load(first), _mm_set1_epi8('*'));
+      __m128i slash = _mm_cmpeq_epi8(sse_load(first + 1), _mm_set1_epi8('/'));
+      auto bits = static_cast<unsigned>(_mm_movemask_epi8(_mm_and_si128(star, slash)));
+      if (bits != 0U) { return first + __builtin_ctz(bits); }
+      first += SSE_WIDTH;
+    }
+    return find_comment_end_scalar(first, last);
+  }
+
+  // AVX2 kernels, 32 bytes per step, only called after a CPU check.
+
+  constexpr std::ptrdiff_t AVX_WIDTH = 32;
+  constexpr unsigned AVX_ALL = 0xFFFFFFFFU;
+
+#define BLANG_AVX2 __attribute__((target("avx2")))
+
+  BLANG_AVX2 inline __m256i avx_load(const char *ptr)
+  {
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(ptr));// NOLINT
+  }
+
+  BLANG_AVX2 inline __m256i avx_in_range(__m256i bytes, char lo, char hi)
+  {
+    return _mm256_and_si256(_mm256_cmpgt_epi8(bytes, _mm256_set1_epi8(static_cast<char>(lo - 1))),
+      _mm256_cmpgt_epi8(_mm256_set1_epi8(static_cast<char>(hi + 1)), bytes));
+  }
+
+  BLANG_AVX2 inline unsigned avx_mask(__m256i bytes) { return static_cast<unsigned>(_mm256_movemask_epi8(bytes)); }
+
+  BLANG_AVX2 const char *skip_whitespace_avx2(const char *first, const char *last)
+  {
+    while (last - first >= AVX_WIDTH) {
+      __m256i bytes = avx_load(first);
+      unsigned blank_bits = avx_mask(_mm256_or_si256(
+        _mm256_cmpeq_epi8(bytes, _mm256_set1_epi8('\n')), _mm256_cmpeq_epi8(bytes, _mm256_set1_epi8(' '))));
+      if (blank_bits != AVX_ALL) { return first + __builtin_ctz(~blank_bits); }
+      first += AVX_WIDTH;
+    }
+    return skip_whitespace_sse2(first, last);
+  }
+
+  BLANG_AVX2 const char *identifier_end_avx2(const char *first, const char *last)
+  {
+    while (last - first >= AVX_WIDTH) {
+      __m256i bytes = avx_load(first);
+      __m256i alpha = avx_in_range(_mm256_or_si256(bytes, _mm256_set1_epi8(0x20)), 'a', 'z');
+      __m256i digit = avx_in_range(bytes, '0', '9');
+      __m256i under = _mm256_cmpeq_epi8(bytes, _mm256_set1_epi8('_'));
+      unsigned bits = avx_mask(_mm256_or_si256(_mm256_or_si256(alpha, digit), under));
+      if (bits != AVX_ALL) { return first + __builtin_ctz(~bits); }
+      first += AVX_WIDTH;
+    }
+    return identifier_end_sse2(first, last);
+  }
+
+  BLANG_AVX2 const char *digits_end_avx2(const char *first, const char *last)
+  {
+    while (last - first >= AVX_WIDTH) {
+      unsigned bits = avx_mask(avx_in_range(avx_load(first), '0', '9'));
+      if (bits != AVX_ALL) { return first + __builtin_ctz(~bits); }
+      first += AVX_WIDTH;
+    }
+    return digits_end_sse2(first, last);
+  }
+
+  BLANG_AVX2 const char *find_byte_avx2(const char *first, const char *last, char byte)
+  {
+    __m256i needle = _mm256_set1_epi8(byte);
+    while (last - first >= AVX_WIDTH) {
+      unsigned bits = avx_mask(_mm256_cmpeq_epi8(avx_load(first), needle));
+      if (bits != 0U) { return first + __builtin_ctz(bits); }
+      first += AVX_WIDTH;
+    }
+    return find_byte_sse2(first, last, byte);
+  }
+
+  BLANG_AVX2 std::size_t count_byte_avx2(const char *first, const char *last, char byte)
+  {
+    __m256i needle = _mm256_set1_epi8(byte);
+    std::size_t count{ 0 };
+    while (last - first >= AVX_WIDTH) {
+      count += static_cast<std::size_t>(__builtin_popcount(avx_mask(_mm256_cmpeq_epi8(avx_load(first), needle))));
+      first += AVX_WIDTH;
+    }
+    return count + count_byte_sse2(first, last, byte);
+  }
+
+  BLANG_AVX2 const char *find_comment_end_avx2(const char *first, const char *last)
+  {
+    while (last - first > AVX_WIDTH) {
+      __m256i star = _mm256_cmpeq_epi8(avx_load(first), _mm256_set1_epi8('*'));
+      __m256i slash = _mm256_cmpeq_epi8(avx_load(first + 1), _mm256_set1_epi8('/'));
+      unsigned bits = avx_mask(_mm256_and_si256(star, slash));
+      if (bits != 0U) { return first + __builtin_ctz(bits); }
+      first += AVX_WIDTH;
+    }
+    return find_comment_end_sse2(first, last);
+  }
+
+#undef BLANG_AVX2
+
+#endif
+
+  // NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+
+  constexpr ScanKernels SCALAR_KERNELS{ skip_whitespace_scalar,
+    identifier_end_scalar,
+    digits_end_scalar,
+    find_byte_scalar,
+    count_byte_scalar,
+    find_comment_end_scalar,
+    Isa::scalar };
+
+#ifdef BLANG_X86_KERNELS
+  constexpr ScanKernels SSE2_KERNELS{ skip_whitespace_sse2,
+    identifier_end_sse2,
+    digits_end_sse2,
+    find_byte_sse2,
+    count_byte_sse2,
+    find_comment_end_sse2,
+    Isa::sse2 };
+
+  constexpr ScanKernels AVX2_KERNELS{ skip_whitespace_avx2,
+    identifier_end_avx2,
+    digits_end_avx2,
+    find_byte_avx2,
+    count_byte_avx2,
+    find_comment_end_avx2,
+    Isa::avx2 };
+#endif
+
+  Isa detect_isa()
+  {
+#ifdef BLANG_X86_KERNELS
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) { return Isa::avx2; }
+    if (__builtin_cpu_supports("sse2")) { return Isa::sse2; }
+#endif
+    return Isa::scalar;
+  }
+
+}// namespace
+
+const ScanKernels &kernels()
+{
+  static const ScanKernels &best = kernels_for(detect_isa());
+  return best;
+}
+
+const ScanKernels &kernels_for(Isa isa)
+{
+#ifdef BLANG_X86_KERNELS
+  static const Isa supported = detect_isa();
+  isa = std::min(isa, supported);
+  if (isa == Isa::avx2) { return AVX2_KERNELS; }
+  if (isa == Isa::sse2) { return SSE2_KERNELS; }
+#else
+  (void)isa;
+#endif
+  return SCALAR_KERNELS;
+}
+
+std::string_view isa_name(Isa isa)
+{
+  switch (isa) {
+  case Isa::avx2:
+    return "avx2";
+  case Isa::sse2:
+    return "sse2";
+  default:
+    return "scalar";
+  }
+}
+
+}// namespace blang::simd
@@ -0,0 +1,71 @@
+#include "blang/source_buffer.hpp"
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+
+namespace blang {
+
+SourceBuffer SourceBuffer::borrow(std::string_view source)
+{
+  SourceBuffer buffer{};
+  buffer.m_view = source;
+  buffer.m_lines = std::make_shared<LazyLines>();
+  return buffer;
+}
+
+SourceBuffer SourceBuffer::borrow(std::string_view source, LineTable lines)
+{
+  SourceBuffer buffer{ borrow(source) };
+  std::call_once(buffer.m_lines->built, [&] { buffer.m_lines->table = std::move(lines); });
+  return buffer;
+}
+
+std::optional<SourceBuffer> SourceBuffer::from_file(const std::filesystem::path &path)
+{
+  std::ifstream file(path, std::ios::in | std::ios::binary);
+  if (!file) { return {}; }
+
+  std::error_code err;
+  auto file_size = std::filesystem::file_size(path, err);
+  std::string bytes{};
+  if (!err) {
+    bytes.resize(file_size);
+    file.read(bytes.data(), static_cast<std::streamsize>(file_size));
+    bytes.resize(static_cast<std::size_t>(file.gcount()));
+  } else {
+    bytes.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+  }
+
+  return SourceBuffer{ std::move(bytes) };
+}
+
+std::string_view SourceBuffer::slice(std::size_t offset, std::size_t length) const
+{
+  if (offset >= m_view.size()) { return {}; }
+  return m_view.substr(offset, length);
+}
+
+const LineTable &SourceBuffer::lines() const
+{
+  if (m_lines == nullptr) {
+    static const LineTable empty{};
+    return empty;
+  }
+  std::call_once(m_lines->built, [this] { m_lines->table = LineTable{ m_view }; });
+  return m_lines->table;
+}
+
+SourceBuffer SourceBuffer::edited(const TextEdit &edit) const
+{
+  const std::size_t offset{ std::min(edit.offset, m_view.size()) };
+  const std::size_t removed{ std::min(edit.removed, m_view.size() - offset) };
+
+  std::string bytes{};
+  bytes.reserve(m_view.size() - removed + edit.inserted.size());
+  bytes.append(m_view.substr(0, offset));
+  bytes.append(edit.inserted);
+  bytes.append(m_view.substr(offset + removed));
+  return SourceBuffer{ std::move(bytes) };
+}
+
+}// namespace blang
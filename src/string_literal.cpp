@@ -0,0 +1,141 @@
+#include "blang/string_literal.hpp"
+
+namespace blang {
+
+namespace {
+
+  int hex_value(char chh)
+  {
+    if (chh >= '0' && chh <= '9') { return chh - '0'; }
+    if (chh >= 'a' && chh <= 'f') { return chh - 'a' + 10; }// NOLINT
+    return chh - 'A' + 10;// NOLINT
+  }
+
+  // Byte an escape of length `length` at the front of `text` stands for.
+  char escaped_byte(std::string_view text, std::size_t length)
+  {
+    switch (text[1]) {
+    case 'n':
+      return '\n';
+    case 't':
+      return '\t';
+    case '0':
+      return '\0';
+    case 'x':
+      if (length == 4) { return static_cast<char>(hex_value(text[2]) * 16 + hex_value(text[3])); }// NOLINT
+      break;
+    default:
+      break;
+    }
+    return text[1];
+  }
+
+  // Writes the value of `body` over `value`.
+  void decode_into(std::string_view body, std::string &value)
+  {
+    value.clear();
+    value.reserve(body.size());
+
+    std::size_t position{ 0 };
+    while (position < body.size()) {
+      const std::size_t special{ body.find_first_of("\\\n", position) };
+      value.append(body.substr(position, special - position));
+      if (special == std::string_view::npos) { break; }
+
+      if (body[special] == '\n') {
+        position = special + 1;
+        continue;
+      }
+      // an invalid escape has already been reported, its bytes are kept as is
+      const std::size_t length{ escape_length(body.substr(special)) };
+      if (length == 0) {
+        value += '\\';
+        position = special + 1;
+      } else {
+        value += escaped_byte(body.substr(special), length);
+        position = special + length;
+      }
+    }
+  }
+
+}// namespace
+
+const char *quoted_literal_end(const char *first,
+  const char *last,
+  char quote,
+  bool &escaped,
+  const simd::ScanKernels &kernels)
+{
+  // NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+  // the first quote at or after the cursor, searched for again only once an
+  // escape has consumed it, so every byte is looked at a bounded number of times
+  const char *cursor{ first };
+  const char *closing{ kernels.find_byte(cursor, last, quote) };
+  while (true) {
+    if (closing < cursor) { closing = kernels.find_byte(cursor, last, quote); }
+    const char *backslash{ kernels.find_byte(cursor, closing, '\\') };
+    if (backslash == closing) { return closing; }
+
+    // whatever follows a backslash is part of the escape, a quote included
+    escaped = true;
+    if (last - backslash < 2) { return last; }
+    cursor = backslash + 2;
+  }
+  // NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+}
+
+std::size_t escape_length(std::string_view text)
+{
+  if (text.size() < 2) { return 0; }
+  switch (text[1]) {
+  case 'n':
+  case 't':
+  case '\\':
+  case '"':
+  case '\'':
+  case '0':
+    return 2;
+  case 'x':
+    if (text.size() >= 4 && simd::is_hex_digit(text[2]) && simd::is_hex_digit(text[3])) { return 4; }// NOLINT
+    return 0;
+  default:
+    return 0;
+  }
+}
+
+std::size_t find_invalid_escape(std::string_view body)
+{
+  std::size_t position{ body.find('\\') };
+  while (position != std::string_view::npos) {
+    const std::size_t length{ escape_length(body.substr(position)) };
+    if (length == 0) { return position; }
+    position = body.find('\\', position + length);
+  }
+  return std::string_view::npos;
+}
+
+bool literal_needs_decoding(std::string_view body) { return body.find_first_of("\\\n") != std::string_view::npos; }
+
+std::string decode_literal(std::string_view body)
+{
+  std::string value{};
+  decode_into(body, value);
+  return value;
+}
+
+std::string_view literal_value(std::string_view body, std::string &scratch)
+{
+  if (!literal_needs_decoding(body)) { return body; }
+  decode_into(body, scratch);
+  return scratch;
+}
+
+char decode_char_literal(std::string_view body)
+{
+  if (body.empty()) { return '\0'; }
+  if (body.front() != '\\') { return body.front(); }
+  const std::size_t length{ escape_length(body) };
+  return length == 0 ? body.front() : escaped_byte(body, length);
+}
+
+}// namespace blang
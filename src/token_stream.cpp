@@ -0,0 +1,233 @@
+#include "blang/token_stream.hpp"
+#include "blang/numeric_literal.hpp"
+#include "blang/string_literal.hpp"
+#include <algorithm>
+#include <iterator>
+#include <utility>
+
+namespace blang {
+
+TokenStream::TokenStream(const TokenStream &other)
+  : m_source(other.m_source), m_types(other.m_types), m_offsets(other.m_offsets), m_lengths(other.m_lengths),
+    m_atoms(other.m_atoms), m_view(other.m_view), m_borrowed(other.m_borrowed)
+{
+  if (!m_borrowed) { sync(); }
+}
+
+TokenStream::TokenStream(TokenStream &&other) noexcept
+  : m_source(std::move(other.m_source)), m_types(std::move(other.m_types)), m_offsets(std::move(other.m_offsets)),
+    m_lengths(std::move(other.m_lengths)), m_atoms(std::move(other.m_atoms)), m_view(std::exchange(other.m_view, {})),
+    m_borrowed(std::exchange(other.m_borrowed, false))
+{
+  if (!m_borrowed) { sync(); }
+}
+
+TokenStream &TokenStream::operator=(const TokenStream &other)
+{
+  if (this != &other) {
+    m_source = other.m_source;
+    m_types = other.m_types;
+    m_offsets = other.m_offsets;
+    m_lengths = other.m_lengths;
+    m_atoms = other.m_atoms;
+    m_borrowed = other.m_borrowed;
+    m_view = other.m_view;
+    if (!m_borrowed) { sync(); }
+  }
+  return *this;
+}
+
+TokenStream &TokenStream::operator=(TokenStream &&other) noexcept
+{
+  if (this != &other) {
+    m_source = std::move(other.m_source);
+    m_types = std::move(other.m_types);
+    m_offsets = std::move(other.m_offsets);
+    m_lengths = std::move(other.m_lengths);
+    m_atoms = std::move(other.m_atoms);
+    m_borrowed = std::exchange(other.m_borrowed, false);
+    m_view = std::exchange(other.m_view, {});
+    // columns moved between different resources are copied, so the view is
+    // always rebuilt from them
+    if (!m_borrowed) { sync(); }
+  }
+  return *this;
+}
+
+TokenStream TokenStream::borrow(SourceBuffer source, TokenColumns columns)
+{
+  TokenStream stream{ std::move(source) };
+  stream.m_view = columns;
+  stream.m_borrowed = true;
+  return stream;
+}
+
+void TokenStream::own()
+{
+  m_types.assign(m_view.types.begin(), m_view.types.end());
+  m_offsets.assign(m_view.offsets.begin(), m_view.offsets.end());
+  m_lengths.assign(m_view.lengths.begin(), m_view.lengths.end());
+  m_atoms.assign(m_view.atoms.begin(), m_view.atoms.end());
+  m_borrowed = false;
+  sync();
+}
+
+void TokenStream::reserve(std::size_t count)
+{
+  if (m_borrowed) { own(); }
+  m_types.reserve(count);
+  m_offsets.reserve(count);
+  m_lengths.reserve(count);
+  sync();
+}
+
+void TokenStream::set_atom(Atom atom)
+{
+  if (m_borrowed) { own(); }
+  m_atoms.resize(size(), NO_ATOM);
+  m_atoms.back() = atom;
+  sync();
+}
+
+void TokenStream::append(const TokenStream &other, std::size_t first)
+{
+  if (first >= other.size()) { return; }
+  if (m_borrowed) { own(); }
+  const std::size_t base{ size() };
+  const TokenColumns &from{ other.m_view };
+
+  m_types.insert(m_types.end(), from.types.begin() + static_cast<std::ptrdiff_t>(first), from.types.end());
+  m_offsets.insert(m_offsets.end(), from.offsets.begin() + static_cast<std::ptrdiff_t>(first), from.offsets.end());
+  m_lengths.insert(m_lengths.end(), from.lengths.begin() + static_cast<std::ptrdiff_t>(first), from.lengths.end());
+
+  if (from.atoms.size() > first) {
+    m_atoms.resize(base, NO_ATOM);
+    m_atoms.insert(m_atoms.end(), from.atoms.begin() + static_cast<std::ptrdiff_t>(first), from.atoms.end());
+  }
+  sync();
+}
+
+namespace {
+
+  // Overwrites column[first, last) with `source`, growing or shrinking the
+  // column in place.
+  template<typename T>
+  void splice_column(std::pmr::vector<T> &column, std::size_t first, std::size_t last, std::pmr::vector<T> &&source)
+  {
+    const std::size_t common{ std::min(last - first, source.size()) };
+    const auto begin{ column.begin() + static_cast<std::ptrdiff_t>(first) };
+    std::move(source.begin(), source.begin() + static_cast<std::ptrdiff_t>(common), begin);
+    if (common < last - first) {
+      column.erase(begin + static_cast<std::ptrdiff_t>(common), column.begin() + static_cast<std::ptrdiff_t>(last));
+    } else {
+      column.insert(begin + static_cast<std::ptrdiff_t>(common),
+        std::make_move_iterator(source.begin() + static_cast<std::ptrdiff_t>(common)),
+        std::make_move_iterator(source.end()));
+    }
+  }
+
+}// namespace
+
+void TokenStream::splice(std::size_t first, std::size_t last, TokenStream &&replacement, std::int64_t offset_delta)
+{
+  if (m_borrowed) { own(); }
+  if (replacement.m_borrowed) { replacement.own(); }
+  const std::size_t count{ replacement.size() };
+  const std::size_t old_size{ size() };
+  const bool has_atoms{ !m_atoms.empty() || !replacement.m_atoms.empty() };
+  if (has_atoms) {
+    m_atoms.resize(old_size, NO_ATOM);
+    replacement.m_atoms.resize(count, NO_ATOM);
+  }
+
+  splice_column(m_types, first, last, std::move(replacement.m_types));
+  splice_column(m_offsets, first, last, std::move(replacement.m_offsets));
+  splice_column(m_lengths, first, last, std::move(replacement.m_lengths));
+  if (has_atoms) { splice_column(m_atoms, first, last, std::move(replacement.m_atoms)); }
+
+  const std::size_t tail{ first + count };
+  if (offset_delta != 0) {
+    std::for_each(m_offsets.begin() + static_cast<std::ptrdiff_t>(tail),
+      m_offsets.end(),
+      [offset_delta](std::uint32_t &offset) { offset = static_cast<std::uint32_t>(offset + offset_delta); });
+  }
+
+  m_source = std::move(replacement.m_source);
+  sync();
+  replacement.sync();
+}
+
+void TokenStream::shrink_to_fit()
+{
+  m_types.shrink_to_fit();
+  m_offsets.shrink_to_fit();
+  m_lengths.shrink_to_fit();
+  m_atoms.shrink_to_fit();
+  if (!m_borrowed) { sync(); }
+}
+
+std::string_view TokenStream::text(std::size_t index) const
+{
+  return m_source.slice(m_view.offsets[index], m_view.lengths[index]);
+}
+
+std::string_view TokenStream::literal(std::size_t index, std::string &scratch) const
+{
+  // the lexeme includes both quotes
+  const std::string_view lexeme{ text(index) };
+  return literal_value(lexeme.substr(1, lexeme.size() - 2), scratch);
+}
+
+value_object derive_value(TokenType type, std::string_view lexeme)
+{
+  switch (type) {
+  case TokenType::t_eof:
+    return '\0';
+  case TokenType::t_integer_lit:
+    return parse_integer_literal(lexeme).value_or(0);
+  case TokenType::t_string_lit:
+    // the lexeme includes both quotes
+    return decode_literal(lexeme.substr(1, lexeme.size() - 2));
+  case TokenType::t_char_lit:
+    return decode_char_literal(lexeme.substr(1, lexeme.size() - 2));
+  default:
+    break;
+  }
+
+  if (type >= TokenType::t_colon && lexeme.size() == 1) { return lexeme.front(); }
+  return std::string{ lexeme };
+}
+
+value_object TokenStream::value(std::size_t index) const { return derive_value(m_view.types[index], text(index)); }
+
+Token TokenStream::token(std::size_t index) const
+{
+  std::size_t position{ std::size_t{ m_view.offsets[index] } + m_view.lengths[index] };
+  // a char literal token has always been positioned before its closing quote
+  if (m_view.types[index] == TokenType::t_char_lit) { position--; }
+
+  return Token{ m_view.types[index], position, line(index), value(index) };
+}
+
+std::vector<Token> TokenStream::materialize() const
+{
+  std::vector<Token> tokens{};
+  tokens.reserve(size());
+  for (std::size_t index = 0; index < size(); ++index) { tokens.push_back(token(index)); }
+
+  return tokens;
+}
+
+std::size_t TokenStream::memory_usage() const
+{
+  return m_types.capacity() * sizeof(TokenType) + m_offsets.capacity() * sizeof(std::uint32_t)
+         + m_lengths.capacity() * sizeof(std::uint32_t) + m_atoms.capacity() * sizeof(Atom);
+}
+
+double TokenStream::bytes_per_token() const
+{
+  if (empty()) { return 0.0; }
+  return static_cast<double>(memory_usage()) / static_cast<double>(size());
+}
+
+}// namespace blang
@@ -0,0 +1,92 @@
+#include "blang/util/thread_pool.hpp"
+#include <algorithm>
+
+namespace blang::util {
+
+namespace {
+  // pool and deque of the worker running on this thread
+  thread_local const ThreadPool *t_pool{ nullptr };
+  thread_local std::size_t t_index{ 0 };
+}// namespace
+
+ThreadPool::ThreadPool(std::size_t threads)
+{
+  if (threads == 0) { threads = std::max(1U, std::thread::hardware_concurrency()); }
+
+  m_queues.reserve(threads);
+  for (std::size_t index = 0; index < threads; ++index) { m_queues.push_back(std::make_unique<Queue>()); }
+  m_workers.reserve(threads);
+  for (std::size_t index = 0; index < threads; ++index) {
+    m_workers.emplace_back([this, index] { work(index); });
+  }
+}
+
+ThreadPool::~ThreadPool()
+{
+  m_stopping = true;
+  m_wakeups.fetch_add(1);
+  m_wakeups.notify_all();
+  for (std::thread &worker : m_workers) { worker.join(); }
+}
+
+void ThreadPool::enqueue(std::function<void()> job)
+{
+  const std::size_t index{ t_pool == this ? t_index
+                                          : m_next.fetch_add(1, std::memory_order_relaxed) % m_queues.size() };
+  // counted before the push, so a thief never takes a job that is not counted
+  // yet, and before the wakeup, so a worker woken by it sees the job
+  m_pending.fetch_add(1);
+  {
+    std::lock_guard lock{ m_queues[index]->mutex };
+    m_queues[index]->jobs.push_back(std::move(job));
+  }
+  m_wakeups.fetch_add(1);
+  m_wakeups.notify_one();
+}
+
+std::optional<std::function<void()>> ThreadPool::take(std::size_t index)
+{
+  {
+    Queue &own{ *m_queues[index] };
+    std::lock_guard lock{ own.mutex };
+    if (!own.jobs.empty()) {
+      std::function<void()> job{ std::move(own.jobs.back()) };
+      own.jobs.pop_back();
+      return job;
+    }
+  }
+  for (std::size_t offset = 1; offset < m_queues.size(); ++offset) {
+    Queue &victim{ *m_queues[(index + offset) % m_queues.size()] };
+    std::lock_guard lock{ victim.mutex };
+    if (!victim.jobs.empty()) {
+      std::function<void()> job{ std::move(victim.jobs.front()) };
+      victim.jobs.pop_front();
+      m_steals.fetch_add(1, std::memory_order_relaxed);
+      return job;
+    }
+  }
+  return std::nullopt;
+}
+
+void ThreadPool::work(std::size_t index)
+{
+  t_pool = this;
+  t_index = index;
+  while (true) {
+    std::optional<std::function<void()>> job{ take(index) };
+    if (job) {
+      m_pending.fetch_sub(1, std::memory_order_relaxed);
+      (*job)();
+      continue;
+    }
+    // a submission or shutdown after this load changes the count, so the wait
+    // below returns at once rather than missing it
+    const std::uint32_t wakeups{ m_wakeups.load() };
+    if (m_pending.load() > 0) { continue; }
+    // drain every deque before stopping so no submitted future is left hanging
+    if (m_stopping.load()) { return; }
+    m_wakeups.wait(wakeups);
+  }
+}
+
+}// namespace blang::util
@@ -0,0 +1,217 @@
+#include "blang/error/error_reporter.hpp"
+#include "blang/exec/interpreter.hpp"
+#include "blang/parser.hpp"
+#include "blang/scanner.hpp"
+#include "blang/sema/constant_folder.hpp"
+#include "blang/sema/type_checker.hpp"
+
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <sstream>
+#include <string>
+
+// Tests
+
+namespace blang::exec {
+
+class ExecTest1 : public testing::Test
+{
+protected:
+  Interner interner;
+  sema::TypeTable types;
+  TokenStream tokens;
+  Ast ast;
+  std::int64_t exit_code{ 0 };
+
+  // Checks and runs `source` and its main, returning what it printed, or its
+  // runtime error. With `folded`, the constant-folded tree is run instead.
+  std::string run(const std::string &source, bool folded = false, NodeSharing sharing = NodeSharing::none)
+  {
+    error::ErrorReporter reporter{ 0 };
+    Scanner scanner{ SourceBuffer{ source }, reporter, &interner };
+    tokens = scanner.scan();
+    ast = Parser{ tokens, reporter, std::pmr::get_default_resource(), sharing }.parse_program();
+    sema::TypeChecker checker{ tokens, ast, types, interner, reporter };
+    EXPECT_TRUE(checker.check());
+    if (folded) {
+      sema::ConstantFolder folder{ tokens, ast, checker };
+      ast = folder.fold();
+      return run_checked(reporter);
+    }
+    return run_checked(reporter, checker);
+  }
+
+  std::string run_checked(error::ErrorReporter &reporter)
+  {
+    sema::TypeChecker checker{ tokens, ast, types, interner, reporter };
+    EXPECT_TRUE(checker.check());
+    return run_checked(reporter, checker);
+  }
+
+  std::string run_checked(error::ErrorReporter &reporter, const sema::TypeChecker &checker)
+  {
+    std::ostringstream out;
+    Interpreter interpreter{ tokens, ast, checker, reporter, out };
+    if (!interpreter.run() || !interpreter.run_main()) { return reporter.get_errors().front(); }
+    exit_code = interpreter.exit_code();
+    return out.str();
+  }
+};
+
+TEST_F(ExecTest1, TestExpressionsAndPrint)
+{
+  ASSERT_EQ(run("print 2 + 3 * 4, \" \", 2 ^ 10, \" \", -7 / 2, \" \", -7 % 3, \"\\n\";"), "14 1024 -3 -1\n");
+  ASSERT_EQ(run("print 1 < 2, ' ', !true || 3 >= 4, ' ', 'a' == 'a', ' ', \"ab\" == \"a\\x62\";"),
+    "true false true true");
+  ASSERT_EQ(run("print 9223372036854775807 + 1, \" \", 2 ^ -1;"), "-9223372036854775808 0");
+  ASSERT_EQ(run("s: string; c: char; b: boolean; i: integer;\nprint s, \"|\", b, i;"), "|false0");
+}
+
+TEST_F(ExecTest1, TestStatements)
+{
+  ASSERT_EQ(run("x: integer = 0;\n"
+                "i: integer;\n"
+                "for (i = 0; i < 5; i++) { x = x + i; }\n"
+                "while (x > 3) x--;\n"
+                "if (x == 3) print \"three\"; else print \"other\";\n"
+                "{ x: integer = 10; print \" \", x; }\n"
+                "print \" \", x, \" \", i++, \" \", i;\n"),
+    "three 10 3 5 6");
+  // an assignment has the value assigned, and && does not run its right side
+  ASSERT_EQ(run("a: integer; b: integer;\nprint a = b = 4, a + b;\nprint false && a++ == 0, a;"), "48false4");
+}
+
+TEST_F(ExecTest1, TestFunctions)
+{
+  ASSERT_EQ(run("fib: function integer (n: integer);\n"
+                "main: function integer () = { print fib(20); return 7; }\n"
+                "fib: function integer (n: integer) = {\n"
+                "  if (n < 2) return n;\n"
+                "  return fib(n - 1) + fib(n - 2);\n"
+                "}\n"),
+    "6765");
+  ASSERT_EQ(exit_code, 7);// NOLINT
+
+  // arguments are evaluated into the callee's frame while other calls run
+  ASSERT_EQ(run("add: function integer (a: integer, b: integer) = { return a + b; }\n"
+                "greet: function void (name: string) = { print \"hi \", name; }\n"
+                "print add(add(1, 2), add(add(3, 4), 5));\n"
+                "greet(\" you\");\n"),
+    "15hi  you");
+}
+
+TEST_F(ExecTest1, TestArrays)
+{
+  ASSERT_EQ(run("table: array [4] integer = { 1, 2 };\n"
+                "grid: array [2] array [3] integer;\n"
+                "fill: function void (values: array [] integer, count: integer, value: integer) = {\n"
+                "  i: integer;\n"
+                "  for (i = 0; i < count; i++) values[i] = value + i;\n"
+                "}\n"
+                "fill(grid[1], 3, 7);\n"
+                "grid[0][2]++;\n"
+                "print table[0], table[1], table[3], \" \", grid[0][2], grid[1][0], grid[1][2];\n"),
+    "120 179");
+  // arrays declared in a loop body are popped at the end of every iteration
+  ASSERT_EQ(run("total: integer;\n"
+                "i: integer;\n"
+                "for (i = 0; i < 100000; i++) {\n"
+                "  words: array [] string = { \"a\", \"b\" };\n"
+                "  scratch: array [1000] integer;\n"
+                "  scratch[999] = i;\n"
+                "  total = total + scratch[999] % 2;\n"
+                "}\n"
+                "print total;\n"),
+    "50000");
+  // and so are those a loop or if body declares without a block
+  const std::string bare{
+    "main: function integer () = {\n"
+    "  j: integer = 0;\n"
+    "  while (j++ < 100000) a: array [1000] integer;\n"
+    "  for (j = 0; j < 100000; j++) if (j % 2 == 0) b: array [1000] integer; else c: array [1000] integer;\n"
+    "  print \"done\\n\";\n"
+    "  return 0;\n"
+    "}\n"
+  };
+  ASSERT_EQ(run(bare), "done\n");
+  // folding an if down to a lone declaration keeps it scoped
+  ASSERT_EQ(run("x: integer = 1;\nif (true) x: boolean = false;\nprint x;", true), "1");
+}
+
+TEST_F(ExecTest1, TestRuntimeErrors)
+{
+  ASSERT_EQ(run("x: integer = 0;\nprint 1 / x;"), "[Line 2] Error: 1 / 0 has no value");
+  ASSERT_EQ(run("print 0 ^ -1;"), "[Line 1] Error: 0 ^ -1 has no value");
+  ASSERT_EQ(run("a: array [3] integer;\nprint a[3];"),
+    "[Line 2] Error: Index 3 is out of bounds for an array of 3 elements");
+  ASSERT_EQ(run("n: integer = -1;\na: array [n] integer;"), "[Line 2] Error: Array size -1 is out of range");
+  ASSERT_EQ(run("a: array [1] integer = { 1, 2 };"), "[Line 1] Error: 2 initializers for an array of 1 elements");
+  ASSERT_EQ(run("f: function integer ();\nprint f();"), "[Line 2] Error: Function 'f' is called but never defined");
+  ASSERT_EQ(run("f: function integer (x: integer) = { if (x > 0) return x; }\nprint f(1), f(0);"),
+    "[Line 2] Error: Function 'f' ended without returning a value");
+  ASSERT_EQ(run("f: function integer (x: integer) = { return f(x + 1); }\nprint f(0);"),
+    "[Line 1] Error: Calls nested more than 1000 deep");
+  ASSERT_EQ(run("f: function void () = {\n  x: integer;\n  g: function integer () = { return x; }\n}\n"),
+    "[Line 3] Error: 'x' is a local of an enclosing function");
+}
+
+TEST_F(ExecTest1, TestFoldedTree)
+{
+  const std::string source{
+    "k: integer = 6;\n"
+    "debug: boolean = false;\n"
+    "main: function integer () = {\n"
+    "  if (debug) print \"never\";\n"
+    "  total: integer = 0;\n"
+    "  while (total < k * 10 - 3) total = total + (k ^ 2 - 30) / 2;\n"
+    "  print total, \" \", debug || total > k;\n"
+    "  return total % k;\n"
+    "}\n"
+  };
+  const std::string expected{ run(source) };
+  ASSERT_EQ(expected, "57 true");
+  ASSERT_EQ(run(source, true), expected);
+  ASSERT_EQ(exit_code, 3);// NOLINT
+}
+
+TEST_F(ExecTest1, TestSharedTree)
+{
+  const std::string source{
+    "x: integer = 2;\n"
+    "print x * 3, \" \";\n"
+    "{ x: integer = 7; print x * 3, \" \"; }\n"
+    "f: function integer (x: integer) = { return x * 3; }\n"
+    "print x * 3, \" \", f(5), \" \";\n"
+    "x = x + 1;\n"
+    "print x * 3, \" \";\n"
+  };
+  const std::string expected{ run(source) };
+  ASSERT_EQ(expected, "6 21 6 15 9 ");
+  ASSERT_EQ(run(source, false, NodeSharing::pure_subtrees), expected);
+  ASSERT_EQ(run(source, true, NodeSharing::pure_subtrees), expected);
+}
+
+TEST_F(ExecTest1, TestReplay)
+{
+  error::ErrorReporter reporter{ 0 };
+  Scanner scanner{
+    SourceBuffer{ std::string{ "x: integer = 2;\nprint x;\nx = x * 5;\nprint x;\n" } }, reporter, &interner
+  };
+  tokens = scanner.scan();
+  ast = Parser{ tokens, reporter }.parse_program();
+  sema::TypeChecker checker{ tokens, ast, types, interner, reporter };
+  ASSERT_TRUE(checker.check());
+  std::ostringstream out;
+  Interpreter interpreter{ tokens, ast, checker, reporter, out };
+  // the first three statements run again without printing
+  ASSERT_TRUE(interpreter.run(3));
+  ASSERT_EQ(out.str(), "10");
+}
+
+}// namespace blang::exec
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
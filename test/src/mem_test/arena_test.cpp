@@ -0,0 +1,178 @@
+#include "blang/ast_printer.hpp"
+#include "blang/mem/arena.hpp"
+#include "blang/parser.hpp"
+#include "blang/scanner.hpp"
+#include "blang/session.hpp"
+
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+// Tests
+
+namespace blang {
+
+namespace {
+
+  // Heap resource that counts what goes through it.
+  class CountingResource : public std::pmr::memory_resource
+  {
+  public:
+    std::size_t allocations{ 0 };
+    std::size_t deallocations{ 0 };
+
+  private:
+    void *do_allocate(std::size_t bytes, std::size_t alignment) override
+    {
+      allocations++;
+      return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+    void do_deallocate(void *pointer, std::size_t bytes, std::size_t alignment) override
+    {
+      deallocations++;
+      std::pmr::new_delete_resource()->deallocate(pointer, bytes, alignment);
+    }
+    [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override
+    {
+      return this == &other;
+    }
+  };
+
+  struct Tracked
+  {
+    explicit Tracked(std::vector<int> &destroyed, int number) : log(&destroyed), id(number) {}
+    Tracked(const Tracked &) = delete;
+    Tracked(Tracked &&) = delete;
+    Tracked &operator=(const Tracked &) = delete;
+    Tracked &operator=(Tracked &&) = delete;
+    ~Tracked() { log->push_back(id); }
+
+    std::vector<int> *log;
+    int id;
+  };
+
+}// namespace
+
+class MemTest1 : public testing::Test
+{
+protected:
+  CountingResource upstream;
+};
+
+TEST_F(MemTest1, TestBumpAllocation)
+{
+  constexpr std::size_t page = 4096;
+  mem::Arena arena{ page, &upstream };
+  ASSERT_EQ(arena.page_count(), 0);
+
+  auto *byte{ arena.create<char>('x') };
+  auto *word{ arena.create<std::uint64_t>(42U) };
+  ASSERT_EQ(*byte, 'x');
+  ASSERT_EQ(*word, 42U);
+  ASSERT_EQ(reinterpret_cast<std::uintptr_t>(word) % alignof(std::uint64_t), 0);// NOLINT
+  ASSERT_EQ(arena.page_count(), 1);
+
+  const std::string_view copy{ arena.copy("hello world") };
+  ASSERT_EQ(copy, "hello world");
+  std::span<int> numbers{ arena.make_array<int>(100) };// NOLINT
+  ASSERT_EQ(numbers.size(), 100);
+  ASSERT_EQ(numbers[99], 0);// NOLINT
+  ASSERT_EQ(arena.page_count(), 1);
+  ASSERT_EQ(upstream.allocations, 1);
+
+  // a large allocation gets its own page and bumping carries on in the old one
+  auto *big{ static_cast<char *>(arena.allocate(page * 2)) };
+  big[page * 2 - 1] = 'z';// NOLINT
+  auto *after{ arena.create<char>('y') };
+  ASSERT_EQ(arena.page_count(), 2);
+  ASSERT_LT(reinterpret_cast<std::uintptr_t>(after) - reinterpret_cast<std::uintptr_t>(byte), page);// NOLINT
+}
+
+TEST_F(MemTest1, TestReleaseKeepsOnePage)
+{
+  constexpr std::size_t page = 4096;
+  {
+    mem::Arena arena{ page, &upstream };
+    for (int i = 0; i < 1000; ++i) { arena.create<std::uint64_t>(1U); }// NOLINT
+    ASSERT_GT(arena.page_count(), 1);
+    const std::size_t pages{ arena.page_count() };
+
+    // one free per page, whatever was allocated in them
+    arena.release();
+    ASSERT_EQ(arena.page_count(), 1);
+    ASSERT_EQ(arena.bytes_used(), 0);
+    ASSERT_EQ(upstream.deallocations, pages - 1);
+
+    // the kept page serves the next round without going upstream
+    const std::size_t allocations{ upstream.allocations };
+    arena.create<std::uint64_t>(2U);
+    ASSERT_EQ(upstream.allocations, allocations);
+  }
+  ASSERT_EQ(upstream.allocations, upstream.deallocations);
+}
+
+TEST_F(MemTest1, TestPmrContainers)
+{
+  mem::Arena arena{ mem::DEFAULT_PAGE_SIZE, &upstream };
+  std::pmr::vector<std::uint32_t> numbers{ &arena };
+  for (std::uint32_t i = 0; i < 10000; ++i) { numbers.push_back(i); }// NOLINT
+  ASSERT_EQ(numbers.back(), 9999);
+
+  // the buffers left behind by growth add up to less than the final one
+  ASSERT_LT(arena.bytes_used(), numbers.capacity() * sizeof(std::uint32_t) * 2);
+  ASSERT_EQ(upstream.allocations, 1);
+
+  // a temporary given back straight away leaves no trace
+  const std::size_t used{ arena.bytes_used() };
+  {
+    std::pmr::string scratch{ "a string too long for the small buffer", &arena };
+    ASSERT_GT(arena.bytes_used(), used);
+  }
+  ASSERT_EQ(arena.bytes_used(), used);
+}
+
+TEST_F(MemTest1, TestTypedArenaRunsDestructors)
+{
+  mem::Arena arena{ 4096, &upstream };// NOLINT
+  std::vector<int> log{};
+  {
+    mem::TypedArena<Tracked> tracked{ arena, 2 };
+    for (int id = 0; id < 5; ++id) { tracked.create(log, id); }// NOLINT
+    ASSERT_EQ(tracked.size(), 5);
+    ASSERT_TRUE(log.empty());
+  }
+  ASSERT_EQ(log, (std::vector<int>{ 4, 3, 2, 1, 0 }));
+}
+
+TEST_F(MemTest1, TestSession)
+{
+  const std::string source{ "x: integer = 1 + 2;\nprint x;\n" };
+  Session session{};
+  const SourceBuffer buffer{ session.add_source(source) };
+  const TokenStream tokens{ session.scan(buffer) };
+  const Ast ast{ session.parse_program(tokens) };
+
+  error::ErrorReporter reporter{};
+  const TokenStream heap_tokens{ Scanner{ source, reporter }.scan() };
+  const Ast heap_ast{ Parser{ heap_tokens, reporter }.parse_program() };
+  ASSERT_EQ(AstPrinter(ast, tokens).print_roots(), AstPrinter(heap_ast, heap_tokens).print_roots());
+  ASSERT_GT(session.arena().bytes_used(), source.size());
+
+  const TokenStream broken{ session.scan(session.add_source("y = ;")) };
+  session.parse_program(broken);
+  ASSERT_EQ(session.reporter().get_status(), error::Status::ERROR);
+
+  session.reset();
+  ASSERT_EQ(session.arena().bytes_used(), 0);
+  ASSERT_EQ(session.reporter().get_status(), error::Status::OK);
+}
+
+}// namespace blang
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,148 @@
+#include "blang/ast_printer.hpp"
+#include "blang/error/error_reporter.hpp"
+#include "blang/interner.hpp"
+#include "blang/module.hpp"
+#include "blang/parser.hpp"
+#include "blang/scanner.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <string>
+
+// Tests
+
+namespace blang {
+
+class ModuleTest1 : public testing::Test
+{
+protected:
+  error::ErrorReporter reporter{ 0 };
+  Interner interner;
+  std::filesystem::path path{ std::filesystem::temp_directory_path() / "blang_module_test.blm" };
+
+  const std::string source{
+    "square: function integer ( x: integer ) = {\n return x^2;\n}\nmain: function void () = {\n s: string = "
+    "\"sq\\n\";\n print s, square(4);\n}\n"
+  };
+
+  void TearDown() override { std::filesystem::remove(path); }
+
+  // Rewrites the written module with its byte at `offset` changed.
+  void overwrite(std::size_t offset, char byte)
+  {
+    std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+    file.seekp(static_cast<std::streamoff>(offset));
+    file.put(byte);
+  }
+};
+
+TEST_F(ModuleTest1, TestRoundTrip)
+{
+  Scanner scanner{ SourceBuffer{ source }, reporter, &interner };
+  const TokenStream tokens{ scanner.scan() };
+  const Ast ast{ Parser{ tokens, reporter }.parse_program() };
+  ASSERT_EQ(reporter.get_status(), error::Status::OK);
+  ASSERT_TRUE(write_module(path, tokens, ast, &interner));
+
+  ModuleError error{ ModuleError::malformed };
+  const std::optional<Module> module{ Module::load(path, &error) };
+  ASSERT_TRUE(module.has_value());
+  ASSERT_EQ(error, ModuleError::none);
+
+  // everything is read in place from the mapping
+  ASSERT_TRUE(module->tokens().borrowed());
+  ASSERT_TRUE(module->ast().borrowed());
+  ASSERT_FALSE(module->source().owns_bytes());
+  ASSERT_EQ(module->source().view(), source);
+  ASSERT_EQ(module->tokens().size(), tokens.size());
+  ASSERT_EQ(module->ast().size(), ast.size());
+  ASSERT_EQ(AstPrinter(module->ast(), module->tokens()).print_roots(), AstPrinter(ast, tokens).print_roots());
+
+  for (std::size_t index = 0; index < tokens.size(); ++index) {
+    ASSERT_EQ(module->tokens().type(index), tokens.type(index));
+    ASSERT_EQ(module->tokens().line(index), tokens.line(index));
+    ASSERT_EQ(module->tokens().value(index), tokens.value(index));
+    if (tokens.atom(index) != NO_ATOM) {
+      ASSERT_EQ(module->string(module->tokens().atom(index)), interner.view(tokens.atom(index)));
+    }
+  }
+  // square, x, main, s and "sq\n"
+  ASSERT_EQ(module->string_count(), 5);
+  ASSERT_EQ(module->source().locate(source.find("print")).line, 6);
+}
+
+TEST_F(ModuleTest1, TestBorrowedCopiesOnWrite)
+{
+  Scanner scanner{ SourceBuffer{ source }, reporter };
+  const TokenStream tokens{ scanner.scan() };
+  const Ast ast{ Parser{ tokens, reporter }.parse_program() };
+  ASSERT_TRUE(write_module(path, tokens, ast));
+
+  std::optional<Module> module{ Module::load(path) };
+  ASSERT_TRUE(module.has_value());
+  ASSERT_EQ(module->string_count(), 0);
+  ASSERT_EQ(module->tokens().atom(0), NO_ATOM);
+
+  Ast copy{ module->ast() };
+  ASSERT_TRUE(copy.borrowed());
+  const NodeId root{ copy.add(NodeKind::print_stmt, 0, NO_NODE, copy.add_list({})) };
+  copy.add_root(root);
+  ASSERT_FALSE(copy.borrowed());
+  ASSERT_EQ(copy.roots().size(), ast.roots().size() + 1);
+  ASSERT_EQ(module->ast().roots().size(), ast.roots().size());
+
+  // moving the module keeps what it handed out valid
+  const Module moved{ std::move(*module) };
+  ASSERT_EQ(AstPrinter(moved.ast(), moved.tokens()).print_roots(), AstPrinter(ast, tokens).print_roots());
+}
+
+TEST_F(ModuleTest1, TestRejected)
+{
+  Scanner scanner{ SourceBuffer{ source }, reporter };
+  const TokenStream tokens{ scanner.scan() };
+  const Ast ast{ Parser{ tokens, reporter }.parse_program() };
+  const std::string bytes{ serialize_module(tokens, ast) };
+  ModuleError error{ ModuleError::none };
+
+  ASSERT_FALSE(Module::load(path, &error).has_value());
+  ASSERT_EQ(error, ModuleError::unreadable);
+
+  ASSERT_TRUE(write_module(path, tokens, ast));
+  overwrite(bytes.size() - 1 - source.size() / 2, 'X');
+  ASSERT_FALSE(Module::load(path, &error).has_value());
+  ASSERT_EQ(error, ModuleError::checksum);
+
+  // the compiler version follows the magic, byte order mark and format version
+  ASSERT_TRUE(write_module(path, tokens, ast));
+  overwrite(16, static_cast<char>(bytes[16] + 1));// NOLINT
+  ASSERT_FALSE(Module::load(path, &error).has_value());
+  ASSERT_EQ(error, ModuleError::compiler_version);
+
+  ASSERT_TRUE(write_module(path, tokens, ast));
+  overwrite(12, static_cast<char>(bytes[12] + 1));// NOLINT
+  ASSERT_FALSE(Module::load(path, &error).has_value());
+  ASSERT_EQ(error, ModuleError::format_version);
+
+  ASSERT_TRUE(write_module(path, tokens, ast));
+  overwrite(0, 'b');
+  ASSERT_FALSE(Module::load(path, &error).has_value());
+  ASSERT_EQ(error, ModuleError::bad_magic);
+
+  std::filesystem::resize_file(path, bytes.size() - 8);// NOLINT
+  ASSERT_FALSE(Module::load(path, &error).has_value());
+  ASSERT_EQ(error, ModuleError::bad_magic);
+  ASSERT_TRUE(write_module(path, tokens, ast));
+  std::filesystem::resize_file(path, bytes.size() - 8);// NOLINT
+  ASSERT_FALSE(Module::load(path, &error).has_value());
+  ASSERT_EQ(error, ModuleError::truncated);
+  ASSERT_EQ(module_error_message(error), "module is truncated");
+}
+
+}// namespace blang
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,81 @@
+#include "blang/ast_printer.hpp"
+#include "blang/error/error_reporter.hpp"
+#include "blang/parser.hpp"
+#include "blang/scanner.hpp"
+
+#include <gtest/gtest.h>
+#include <string>
+
+// Tests
+
+namespace blang {
+
+class ParserTest1 : public testing::Test
+{
+protected:
+  error::ErrorReporter reporter;
+
+  // Parses `source` as one expression and prints it, "" when it fails.
+  std::string parse(const std::string &source)
+  {
+    Scanner scanner{ source, reporter };
+    TokenStream tokens{ scanner.scan() };
+    const Ast ast{ Parser{ tokens, reporter }.parse() };
+    return ast.roots().empty() ? "" : AstPrinter{ ast, tokens }.print(ast.roots().front());
+  }
+};
+
+TEST_F(ParserTest1, TestPrecedence)
+{
+  ASSERT_EQ(parse("1 + 2 * 3"), "(+ 1 (* 2 3))");
+  ASSERT_EQ(parse("1 * 2 + 3 % 4"), "(+ (* 1 2) (% 3 4))");
+  ASSERT_EQ(parse("a < b == c >= d"), "(== (< a b) (>= c d))");
+  ASSERT_EQ(parse("a || b && c == 1"), "(|| a (&& b (== c 1)))");
+  ASSERT_EQ(parse("-a ^ 2"), "(^ (- a) 2)");
+  ASSERT_EQ(parse("!(a - 1)"), "(! (group (- a 1)))");
+  ASSERT_EQ(reporter.get_status(), error::Status::OK);
+}
+
+TEST_F(ParserTest1, TestAssociativity)
+{
+  ASSERT_EQ(parse("a - b - c"), "(- (- a b) c)");
+  ASSERT_EQ(parse("2 ^ 3 ^ 2"), "(^ 2 (^ 3 2))");
+  ASSERT_EQ(parse("a = b = 5"), "(= a (= b 5))");
+  ASSERT_EQ(reporter.get_status(), error::Status::OK);
+}
+
+TEST_F(ParserTest1, TestPostfixCallsAndSubscripts)
+{
+  ASSERT_EQ(parse("-x++"), "(- (post++ x))");
+  ASSERT_EQ(parse("i--"), "(post-- i)");
+  ASSERT_EQ(parse("square(x, 2) + items[i + 1]"), "(+ (call square x 2) (index items (+ i 1)))");
+  ASSERT_EQ(parse("f()"), "(call f)");
+  ASSERT_EQ(parse("grid[1][2] = 'c'"), "(= (index (index grid 1) 2) 'c')");
+  ASSERT_EQ(parse("s == \"hi\" && true"), "(&& (== s \"hi\") true)");
+  ASSERT_EQ(reporter.get_status(), error::Status::OK);
+}
+
+TEST_F(ParserTest1, TestErrors)
+{
+  ASSERT_EQ(parse("1 +"), "");
+  ASSERT_EQ(parse("(1 + 2"), "");
+  ASSERT_EQ(parse("1 2"), "");
+  ASSERT_EQ(parse("1 = 2"), "(= 1 2)");
+  ASSERT_EQ(parse(std::string(1000, '(') + "1" + std::string(1000, ')')), "");// NOLINT
+
+  std::vector<std::string> errors{ reporter.get_errors() };
+  ASSERT_EQ(errors.size(), 5);
+  ASSERT_EQ(errors.at(0), "[Line 1] Error: Expected expression");
+  ASSERT_EQ(errors.at(1), "[Line 1] Error: Expected ')' after expression");
+  ASSERT_EQ(errors.at(2), "[Line 1] Error: Expected 'end of input' after expression");
+  ASSERT_EQ(errors.at(3), "[Line 1] Error: Invalid assignment target");
+  ASSERT_EQ(errors.at(4), "[Line 1] Error: Nested too deeply");
+}
+
+}// namespace blang
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,110 @@
+#include "blang/ast_printer.hpp"
+#include "blang/error/error_reporter.hpp"
+#include "blang/parser.hpp"
+#include "blang/scanner.hpp"
+
+#include <gtest/gtest.h>
+#include <string>
+
+// Tests
+
+namespace blang {
+
+class ParserTest3 : public testing::Test
+{
+protected:
+  error::ErrorReporter reporter{ 0 };
+  TokenStream tokens;
+  std::size_t shared{ 0 };
+
+  // Parses `source` as a program, sharing pure subtrees, and checks that the
+  // tree prints the same as one parsed without sharing.
+  Ast parse(const std::string &source)
+  {
+    Scanner scanner{ source, reporter };
+    tokens = scanner.scan();
+    const Ast plain{ Parser{ tokens, reporter }.parse_program() };
+    Parser parser{ tokens, reporter, std::pmr::get_default_resource(), NodeSharing::pure_subtrees };
+    Ast ast{ parser.parse_program() };
+    shared = parser.shared_nodes();
+    EXPECT_EQ(AstPrinter(ast, tokens).print_roots(), AstPrinter(plain, tokens).print_roots());
+    EXPECT_EQ(ast.size() + shared, plain.size());
+    return ast;
+  }
+
+  // Value of the expression statement at root `index`: the right of its
+  // assignment, or the first value printed.
+  static NodeId value(const Ast &ast, std::size_t index)
+  {
+    const NodeId root{ ast.roots()[index] };
+    if (ast.kind(root) == NodeKind::print_stmt) { return ast.list(ast.rhs(root)).front(); }
+    return ast.rhs(ast.lhs(root));
+  }
+};
+
+TEST_F(ParserTest3, TestRepeatedExpressions)
+{
+  const Ast ast{ parse("x = a[i] * 2 + 1;\ny = a[i] * 2 + 1;\nprint a[i] * 2 + 1, -(a[i] * 2 + 1);") };
+  ASSERT_EQ(value(ast, 0), value(ast, 1));
+  ASSERT_EQ(value(ast, 1), value(ast, 2));
+  // a, i, a[i], 2, *, 1, + twice, then all of it again under the negation
+  ASSERT_EQ(shared, 7 + 7 + 7);
+  ASSERT_EQ(reporter.get_status(), error::Status::OK);
+}
+
+TEST_F(ParserTest3, TestWritesEndSharing)
+{
+  const Ast ast{ parse("print a[i] + 1;\ni++;\nprint a[i] + 1;\na[0] = 5;\nprint a[i] + 1;\n") };
+  ASSERT_NE(value(ast, 0), value(ast, 2));
+  ASSERT_NE(value(ast, 2), value(ast, 4));
+  // literals and the variables nothing wrote are still shared
+  ASSERT_EQ(ast.rhs(value(ast, 0)), ast.rhs(value(ast, 2)));
+  ASSERT_EQ(ast.lhs(ast.lhs(value(ast, 0))), ast.lhs(ast.lhs(value(ast, 2))));
+
+  const Ast shadowed{ parse("x: integer = 1;\nprint x;\nx: integer = 2;\nprint x;\nprint x;") };
+  ASSERT_NE(value(shadowed, 1), value(shadowed, 3));
+  ASSERT_EQ(value(shadowed, 3), value(shadowed, 4));
+
+  // the read after the block is of the outer x again, not the inner one
+  const Ast inner{ parse("x: integer;\nprint x;\n{ x: integer = 1; print x; }\nprint x;") };
+  const NodeId block{ inner.roots()[2] };
+  const NodeId in_block{ inner.list(inner.rhs(inner.list(inner.rhs(block))[1])).front() };
+  ASSERT_NE(value(inner, 1), in_block);
+  ASSERT_NE(value(inner, 3), in_block);
+  ASSERT_EQ(reporter.get_status(), error::Status::OK);
+}
+
+TEST_F(ParserTest3, TestBarriers)
+{
+  const Ast called{ parse("print n * 2;\nf();\nprint n * 2;") };
+  ASSERT_NE(value(called, 0), value(called, 2));
+
+  const Ast looped{ parse("print n * 2;\nwhile (n > 0) print n * 2;\nprint n * 2;") };
+  const NodeId loop_body{ looped.rhs(looped.roots()[1]) };
+  const NodeId in_loop{ looped.list(looped.rhs(loop_body)).front() };
+  ASSERT_NE(value(looped, 0), in_loop);
+  ASSERT_NE(value(looped, 2), in_loop);
+
+  const Ast function{ parse("print n * 2;\nf: function void () = { print n * 2; }\nprint n * 2;") };
+  ASSERT_NE(value(function, 0), value(function, 2));
+}
+
+TEST_F(ParserTest3, TestRecovery)
+{
+  const Ast ast{ parse("print a + b;\nprint (c + d;\nprint c + d;\nprint a + b;\n") };
+  ASSERT_EQ(ast.roots().size(), 3);
+  ASSERT_EQ(value(ast, 0), value(ast, 2));
+  // nothing refers to the nodes of the dropped statement
+  for (NodeId node = 0; node < ast.size(); ++node) {
+    if (ast.lhs(node) != NO_NODE && ast.kind(node) != NodeKind::for_stmt) { ASSERT_LT(ast.lhs(node), node); }
+  }
+  ASSERT_EQ(reporter.get_status(), error::Status::ERROR);
+}
+
+}// namespace blang
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
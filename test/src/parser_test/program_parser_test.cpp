@@ -0,0 +1,113 @@
+#include "blang/ast_printer.hpp"
+#include "blang/error/error_reporter.hpp"
+#include "blang/parser.hpp"
+#include "blang/scanner.hpp"
+
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+// Tests
+
+namespace blang {
+
+class ParserTest2 : public testing::Test
+{
+protected:
+  error::ErrorReporter reporter{ 0 };
+
+  // Parses `source` as a program and prints what was kept of it.
+  std::string parse(const std::string &source)
+  {
+    Scanner scanner{ source, reporter };
+    TokenStream tokens{ scanner.scan() };
+    const Ast ast{ Parser{ tokens, reporter }.parse_program() };
+    return AstPrinter{ ast, tokens }.print_roots();
+  }
+};
+
+TEST_F(ParserTest2, TestDeclarations)
+{
+  ASSERT_EQ(parse("x: integer;\nb: boolean = false;\nc: char = 'q';\ns: string = \"hello world\";\n"),
+    "(decl x integer)\n(decl b boolean false)\n(decl c char 'q')\n(decl s string \"hello world\")\n");
+  ASSERT_EQ(parse("a: array [5] integer;\na: array [5] integer = {1,2,3};"),
+    "(decl a (array 5 integer))\n(decl a (array 5 integer) {1 2 3})\n");
+  ASSERT_EQ(parse("m: array [2] array [2] integer = {{1, 2}, {3, 4}};"),
+    "(decl m (array 2 (array 2 integer)) {{1 2} {3 4}})\n");
+  ASSERT_EQ(reporter.get_status(), error::Status::OK);
+}
+
+TEST_F(ParserTest2, TestFunctions)
+{
+  ASSERT_EQ(parse("square: function integer ( x: integer ) = {\n return x^2;\n}"),
+    "(decl square (function integer ((x integer))) (block (return (^ x 2))))\n");
+  ASSERT_EQ(parse("f: function void ();"), "(decl f (function void ()))\n");
+  ASSERT_EQ(parse("printarray: function void\n ( a: array [] integer, size: integer ) = {\n i: integer;\n for( "
+                  "i=0;i<size;i++) {\n print a[i], \"x\";\n }\n }"),
+    "(decl printarray (function void ((a (array integer)) (size integer))) (block (decl i integer) (for (= i 0) (< i "
+    "size) (post++ i) (block (print (index a i) \"x\")))))\n");
+  ASSERT_EQ(reporter.get_status(), error::Status::OK);
+}
+
+TEST_F(ParserTest2, TestControlFlow)
+{
+  ASSERT_EQ(parse("if (a < b) print a; else { return; }\nwhile (n > 0) n--;\nfor (;;) {}\nprint;"),
+    "(if (< a b) (print a) (block (return)))\n(while (> n 0) (expr (post-- n)))\n(for _ _ _ (block))\n(print)\n");
+  // else belongs to the nearest if
+  ASSERT_EQ(parse("if (a) if (b) x = 1; else x = 2;"), "(if a (if b (expr (= x 1)) (expr (= x 2))))\n");
+  ASSERT_EQ(reporter.get_status(), error::Status::OK);
+}
+
+TEST_F(ParserTest2, TestRecovery)
+{
+  const std::string source{
+    "x: integer = ;\ny: integer = 2;\nf: function void () = {\n a = (1 + ;\n b = 3;\n if (c == ) { d = 1; }\n e = "
+    "4;\n}\n}\nz = 5;\nq: 5;\n"
+  };
+  ASSERT_EQ(parse(source),
+    "(decl y integer 2)\n(decl f (function void ()) (block (expr (= b 3)) (expr (= e 4))))\n(expr (= z 5))\n");
+
+  std::vector<std::string> errors{ reporter.get_errors() };
+  ASSERT_EQ(errors.size(), 5);
+  ASSERT_EQ(errors.at(0), "[Line 1] Error: Expected expression");
+  ASSERT_EQ(errors.at(1), "[Line 4] Error: Expected expression");
+  ASSERT_EQ(errors.at(2), "[Line 6] Error: Expected expression");
+  ASSERT_EQ(errors.at(3), "[Line 9] Error: Expected expression");
+  ASSERT_EQ(errors.at(4), "[Line 11] Error: Expected a type in declaration");
+}
+
+TEST_F(ParserTest2, TestMissingDelimiters)
+{
+  ASSERT_EQ(parse("x = 1\ny = 2;\nw = 3;"), "(expr (= w 3))\n");
+  ASSERT_EQ(parse("f: function void () = {\n x = 1;\n"), "");
+
+  std::vector<std::string> errors{ reporter.get_errors() };
+  ASSERT_EQ(errors.size(), 2);
+  ASSERT_EQ(errors.at(0), "[Line 2] Error: Expected ';' after expression");
+  ASSERT_EQ(errors.at(1), "[Line 3] Error: Expected '}' after block");
+}
+
+TEST_F(ParserTest2, TestErrorsDoNotCascade)
+{
+  // one error per broken statement, however many there are
+  std::string source{};
+  for (int i = 0; i < 10000; ++i) { source += "x = ;\n"; }// NOLINT
+  ASSERT_EQ(parse(source + "ok: integer;"), "(decl ok integer)\n");
+  ASSERT_EQ(reporter.diagnostics().size(), 10000);// NOLINT
+
+  // blocks nested past the limit: one error there and one for the missing '}'
+  reporter.clear_errors();
+  ASSERT_EQ(parse(std::string(100000, '{')), "");// NOLINT
+  std::vector<std::string> errors{ reporter.get_errors() };
+  ASSERT_EQ(errors.size(), 2);
+  ASSERT_EQ(errors.at(0), "[Line 1] Error: Nested too deeply");
+  ASSERT_EQ(errors.at(1), "[Line 1] Error: Expected '}' after block");
+}
+
+}// namespace blang
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
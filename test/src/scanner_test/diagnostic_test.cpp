@@ -0,0 +1,192 @@
+#include "blang/error/diagnostic.hpp"
+#include "blang/error/error_reporter.hpp"
+#include "blang/scanner.hpp"
+#include "blang/source_buffer.hpp"
+
+#include <cstdint>
+#include <functional>
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Tests
+
+namespace blang {
+
+class ScannerTest23 : public testing::Test
+{
+protected:
+  error::ErrorReporter reporter;
+};
+
+TEST_F(ScannerTest23, TestArgumentsAndMessages)
+{
+  const error::FileId file{ reporter.add_source(SourceBuffer{ "n = 99999999999999999999;" }) };
+  reporter.report(
+    file, error::DiagnosticCode::integer_out_of_range, error::Span{ 4, 20 }, { "99999999999999999999" });// NOLINT
+  reporter.report(file, error::DiagnosticCode::unexpected_character, error::Span{ 1, 1 }, { "36" });
+
+  // diagnostics come out in source order, whatever order they were reported in
+  ASSERT_EQ(reporter.diagnostics().size(), 2);
+  ASSERT_EQ(reporter.message(reporter.diagnostics().at(0)), "Unexpected character: 36");
+  const error::Diagnostic &literal{ reporter.diagnostics().at(1) };
+  ASSERT_EQ(literal.severity, error::Severity::error);
+  ASSERT_EQ(reporter.argument(literal, 0), "99999999999999999999");
+  ASSERT_EQ(reporter.argument(literal, 1), "");
+  ASSERT_EQ(reporter.message(literal), "Integer literal 99999999999999999999 does not fit in 64 bits");
+  ASSERT_EQ(reporter.get_status(), error::Status::ERROR);
+}
+
+TEST_F(ScannerTest23, TestReportFromKeepsEveryArgument)
+{
+  error::ErrorReporter other{};
+  const SourceBuffer buffer{ "x = 1 / 0;" };
+  const error::FileId from{ other.add_source(buffer) };
+  other.report(from, error::DiagnosticCode::no_value, error::Span{ 4, 5 }, { "1", "/", "0" });// NOLINT
+  other.report(from, error::DiagnosticCode::type_mismatch, error::Span{ 0, 1 }, { "in assignment", "integer", "char" });
+
+  const error::FileId file{ reporter.add_source(buffer) };
+  for (const error::Diagnostic &diagnostic : other.diagnostics()) { reporter.report_from(other, diagnostic, file); }
+  ASSERT_EQ(reporter.diagnostics().size(), 2);
+  ASSERT_EQ(
+    reporter.message(reporter.diagnostics().at(0)), "Type mismatch in assignment: expected integer, found char");
+  ASSERT_EQ(reporter.message(reporter.diagnostics().at(1)), "1 / 0 has no value");
+}
+
+TEST_F(ScannerTest23, TestSnippetAndCaret)
+{
+  Scanner scanner{ "x = 1;\ny = $;\ns = \"open\n", reporter };
+  scanner.scan();
+
+  const std::string expected{
+    "[Line 2] Error: Unexpected character: 36\n"
+    "    2 | y = $;\n"
+    "      |     ^\n"
+    "[Line 3] Error: Unterminated string literal, missing closing '\"'\n"
+    "    3 | s = \"open\n"
+    "      |     ^~~~~\n"
+  };
+  ASSERT_EQ(scanner.get_reporter().render(), expected);
+}
+
+TEST_F(ScannerTest23, TestRepeatsAreDropped)
+{
+  const error::FileId file{ reporter.add_source(SourceBuffer{ "$" }) };
+  ASSERT_EQ(reporter.add_source(SourceBuffer{ "$" }), file + 1);
+
+  reporter.report(file, error::DiagnosticCode::unexpected_character, error::Span{ 0, 1 }, { "36" });
+  reporter.report(file, error::DiagnosticCode::unexpected_character, error::Span{ 0, 1 }, { "36" });
+  reporter.report(file + 1, error::DiagnosticCode::unexpected_character, error::Span{ 0, 1 }, { "36" });
+  ASSERT_EQ(reporter.diagnostics().size(), 2);
+
+  reporter.clear_errors();
+  ASSERT_TRUE(reporter.diagnostics().empty());
+  ASSERT_EQ(reporter.get_status(), error::Status::OK);
+}
+
+TEST_F(ScannerTest23, TestErrorCap)
+{
+  error::ErrorReporter capped_reporter{ 2 };
+  Scanner scanner{ SourceBuffer{ "$ ? $ ? $\n" }, capped_reporter };
+  scanner.scan();
+
+  const error::ErrorReporter &capped{ scanner.get_reporter() };
+  ASSERT_EQ(capped.diagnostics().size(), 2);
+  ASSERT_EQ(capped.suppressed_count(), 3);
+  ASSERT_EQ(capped.get_status(), error::Status::ERROR);
+
+  const std::string rendered{ capped.render() };
+  ASSERT_EQ(rendered.substr(rendered.rfind("Too")), "Too many errors, 3 more not shown\n");
+}
+
+TEST_F(ScannerTest23, TestConcurrentReportsMatchSerial)
+{
+  std::string source{};
+  for (int line = 0; line < 200; ++line) { source += "a $ b ? c\n"; }// NOLINT
+  const SourceBuffer buffer{ std::move(source) };
+  constexpr std::uint32_t thread_count = 4;
+
+  // every thread reports an interleaved share of the errors, back to front
+  auto report_share = [&buffer](error::ErrorReporter &sink, std::uint32_t share, std::uint32_t shares) {
+    const error::FileId file{ sink.add_source(buffer) };
+    for (auto offset{ static_cast<std::uint32_t>(buffer.size()) }; offset-- > 0;) {
+      if (offset % shares == share && buffer.view()[offset] == '$') {
+        sink.report(file, error::DiagnosticCode::unexpected_character, error::Span{ offset, 1 }, { "36" });
+      }
+    }
+  };
+
+  error::ErrorReporter serial{ 0 };
+  report_share(serial, 0, 1);
+
+  error::ErrorReporter shared{ 0 };
+  std::vector<std::thread> threads{};
+  for (std::uint32_t share = 0; share < thread_count; ++share) {
+    threads.emplace_back(report_share, std::ref(shared), share, thread_count);
+  }
+  for (std::thread &thread : threads) { thread.join(); }
+
+  ASSERT_EQ(shared.diagnostics().size(), 200);// NOLINT
+  ASSERT_EQ(shared.render(), serial.render());
+}
+
+TEST_F(ScannerTest23, TestCapAppliedAsReportsArrive)
+{
+  std::string source{};
+  for (int line = 0; line < 500; ++line) { source += "a $ b ? c\n"; }// NOLINT
+  const SourceBuffer buffer{ std::move(source) };
+  constexpr std::size_t cap = 7;
+  constexpr std::uint32_t thread_count = 3;
+
+  // back to front, so every buffer keeps replacing what it kept, then front
+  // to back, where all but the first few are dropped as they arrive; each
+  // error is shown or counted once all the same
+  auto report_share = [&buffer](error::ErrorReporter &sink, std::uint32_t share, std::uint32_t shares) {
+    const error::FileId file{ sink.add_source(buffer) };
+    const auto size{ static_cast<std::uint32_t>(buffer.size()) };
+    for (std::uint32_t index = 0; index < 2 * size; ++index) {
+      const std::uint32_t offset{ index < size ? size - 1 - index : index - size };
+      if (offset % shares == share && buffer.view()[offset] == '?') {
+        sink.report(file, error::DiagnosticCode::unexpected_character, error::Span{ offset, 1 }, { "63" });
+      }
+    }
+  };
+
+  error::ErrorReporter serial{ cap };
+  report_share(serial, 0, 1);
+  error::ErrorReporter shared{ cap };
+  std::vector<std::thread> threads{};
+  for (std::uint32_t share = 0; share < thread_count; ++share) {
+    threads.emplace_back(report_share, std::ref(shared), share, thread_count);
+  }
+  for (std::thread &thread : threads) { thread.join(); }
+
+  for (const error::ErrorReporter *sink : { &serial, &shared }) {
+    ASSERT_EQ(sink->diagnostics().size(), cap);
+    ASSERT_EQ(sink->diagnostics().front().span.offset, 6);// NOLINT
+    ASSERT_EQ(sink->diagnostics().back().span.offset, 66);// NOLINT
+  }
+  ASSERT_EQ(shared.render(), serial.render());
+  ASSERT_EQ(serial.suppressed_count(), 500 - cap);// NOLINT
+  ASSERT_EQ(shared.suppressed_count(), serial.suppressed_count());
+
+  // reporting it all again after a read changes nothing
+  report_share(serial, 0, 1);
+  ASSERT_EQ(serial.render(), shared.render());
+
+  // later reports still land in order among the kept ones
+  const error::FileId file{ serial.add_source(buffer) };
+  serial.report(file, error::DiagnosticCode::unexpected_character, error::Span{ 2, 1 }, { "36" });
+  ASSERT_EQ(serial.diagnostics().front().span.offset, 2);
+  ASSERT_EQ(serial.diagnostics().size(), cap);
+  ASSERT_EQ(serial.suppressed_count(), 500 - cap + 1);// NOLINT
+}
+
+}// namespace blang
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
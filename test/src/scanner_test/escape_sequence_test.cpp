@@ -0,0 +1,114 @@
+#include "blang/error/error_reporter.hpp"
+#include "blang/scanner.hpp"
+#include "blang/string_literal.hpp"
+#include "blang/token_type.hpp"
+
+#include <gtest/gtest.h>
+#include <string>
+
+// Tests
+
+namespace blang {
+
+class ScannerTest22 : public testing::Test
+{
+protected:
+  error::ErrorReporter reporter;
+};
+
+TEST_F(ScannerTest22, TestDecodeEscapes)
+{
+  ASSERT_EQ(decode_literal(R"(tab\there\n)"), "tab\there\n");
+  ASSERT_EQ(decode_literal(R"(\\ \" \' \x41\x7a)"), "\\ \" ' Az");
+  ASSERT_EQ(decode_literal(R"(nul\0)"), std::string("nul\0", 4));
+  ASSERT_EQ(decode_literal("one\ntwo"), "onetwo");
+  ASSERT_EQ(decode_literal(R"(\q)"), "\\q");
+
+  ASSERT_EQ(find_invalid_escape(R"(ok\n\x4F)"), std::string_view::npos);
+  ASSERT_EQ(find_invalid_escape(R"(ok\x4)"), 2);
+  ASSERT_EQ(find_invalid_escape(R"(\\\q)"), 2);
+
+  ASSERT_EQ(decode_char_literal("a"), 'a');
+  ASSERT_EQ(decode_char_literal(R"(\t)"), '\t');
+  ASSERT_EQ(decode_char_literal(R"(\x20)"), ' ');
+}
+
+TEST_F(ScannerTest22, TestScanEscapedLiterals)
+{
+  Scanner scanner{ R"(s: string = "say \"hi\"\n"; c: char = '\''; d: char = '0';)", reporter };
+  TokenStream tokens{ scanner.scan() };
+
+  ASSERT_EQ(scanner.get_status(), error::Status::OK);
+  ASSERT_EQ(tokens.size(), 19);// NOLINT
+  ASSERT_EQ(tokens.type(4), TokenType::t_string_lit);
+  ASSERT_EQ(tokens.text(4), R"("say \"hi\"\n")");
+  ASSERT_EQ(tokens.value(4), value_object{ "say \"hi\"\n" });
+  ASSERT_EQ(tokens.value(10), value_object{ '\'' });// NOLINT
+  ASSERT_EQ(tokens.value(16), value_object{ '0' });// NOLINT
+
+  std::string scratch{};
+  ASSERT_EQ(tokens.literal(4, scratch), "say \"hi\"\n");
+  ASSERT_EQ(tokens.token(10).position, 41);// NOLINT
+}
+
+TEST_F(ScannerTest22, TestPlainLiteralsAreNotCopied)
+{
+  Scanner scanner{ R"(a: string = "plain"; b: string = "escaped\t";)", reporter };
+  TokenStream tokens{ scanner.scan() };
+
+  std::string scratch{};
+  std::string_view plain{ tokens.literal(4, scratch) };
+  ASSERT_EQ(plain, "plain");
+  ASSERT_EQ(plain.data(), tokens.source().data() + tokens.offset(4) + 1);// NOLINT
+  ASSERT_TRUE(scratch.empty());
+
+  ASSERT_EQ(tokens.literal(10, scratch), "escaped\t");// NOLINT
+  ASSERT_EQ(scratch, "escaped\t");
+}
+
+TEST_F(ScannerTest22, TestInvalidEscapesAreReported)
+{
+  Scanner bad_string{ R"(s: string = "\q"; t: string = "fine";)", reporter };
+  TokenStream tokens{ bad_string.scan() };
+  ASSERT_EQ(bad_string.get_status(), error::Status::ERROR);
+  ASSERT_EQ(tokens.size(), 13);// NOLINT
+  ASSERT_EQ(tokens.value(10), value_object{ "fine" });// NOLINT
+
+  error::ErrorReporter char_reporter{};
+  Scanner bad_char{ R"(c: char = '\x4g'; d: char = '';)", char_reporter };
+  TokenStream chars{ bad_char.scan() };
+  ASSERT_EQ(bad_char.get_status(), error::Status::ERROR);
+  ASSERT_EQ(chars.type(chars.size() - 1), TokenType::t_eof);
+}
+
+TEST_F(ScannerTest22, TestLiteralEnd)
+{
+  const simd::ScanKernels &kernels{ simd::kernels() };
+  auto end_of = [&kernels](std::string_view body) {
+    bool escaped{ false };
+    return static_cast<std::size_t>(
+      quoted_literal_end(body.data(), body.data() + body.size(), '"', escaped, kernels) - body.data());
+  };
+  ASSERT_EQ(end_of(R"(a\"b\\" x")"), 6);
+  ASSERT_EQ(end_of(R"(\"\"\")"), 6);
+  ASSERT_EQ(end_of(R"(\\\\\\)"), 6);
+
+  // a body of escapes only is walked once, whether a quote closes it or not
+  std::string body{};
+  for (std::size_t count = 0; count < (std::size_t{ 1 } << 19U); ++count) { body += R"(\n)"; }// NOLINT
+  ASSERT_EQ(end_of(body + "\";"), body.size());
+  ASSERT_EQ(end_of(body), body.size());
+
+  Scanner scanner{ "\"" + body + "\";", reporter };
+  const TokenStream tokens{ scanner.scan() };
+  ASSERT_EQ(scanner.get_status(), error::Status::OK);
+  ASSERT_EQ(tokens.length(0), body.size() + 2);
+}
+
+}// namespace blang
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,125 @@
+#include "blang/error/error_reporter.hpp"
+#include "blang/interner.hpp"
+#include "blang/scanner.hpp"
+#include "blang/source_buffer.hpp"
+#include "blang/token_type.hpp"
+
+#include <array>
+#include <cstddef>
+#include <gtest/gtest.h>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+// Tests
+
+namespace blang {
+
+class ScannerTest18 : public testing::Test
+{
+protected:
+  error::ErrorReporter reporter;
+  Interner interner;
+
+  TokenStream scan(const SourceBuffer &source) { return Scanner{ source, reporter, &interner }.scan(); }
+
+  void expect_rescan_matches(const TokenStream &previous, const TextEdit &edit)
+  {
+    SourceBuffer next{ previous.source().edited(edit) };
+    TokenStream expected{ scan(next) };
+    TokenStream actual{ Scanner{ next, reporter, &interner }.rescan(previous, edit) };
+
+    ASSERT_EQ(actual.size(), expected.size()) << next.view();
+    for (std::size_t i = 0; i < expected.size(); ++i) {
+      ASSERT_EQ(actual.type(i), expected.type(i)) << i;
+      ASSERT_EQ(actual.offset(i), expected.offset(i)) << i;
+      ASSERT_EQ(actual.length(i), expected.length(i)) << i;
+      ASSERT_EQ(actual.line(i), expected.line(i)) << i;
+      ASSERT_EQ(actual.value(i), expected.value(i)) << i;
+      ASSERT_EQ(actual.atom(i), expected.atom(i)) << i;
+    }
+  }
+};
+
+TEST_F(ScannerTest18, TestSourceBufferEdit)
+{
+  SourceBuffer source{ std::string{ "x: integer = 5;" } };
+  ASSERT_EQ(source.edited(TextEdit{ 13, 1, "42" }).view(), "x: integer = 42;");
+  ASSERT_EQ(source.edited(TextEdit{ 0, 0, "y" }).view(), "yx: integer = 5;");
+  ASSERT_EQ(source.edited(TextEdit{ 10, 100, ";" }).view(), "x: integer;");// NOLINT
+  ASSERT_EQ(source.view(), "x: integer = 5;");
+}
+
+TEST_F(ScannerTest18, TestTypingSplicesIntoStream)
+{
+  TokenStream previous{ scan(SourceBuffer{ std::string{ "x: integer = 5;\ny = x + 1;\nprint y;\n" } }) };
+  expect_rescan_matches(previous, TextEdit{ 13, 1, "42" });// NOLINT
+  expect_rescan_matches(previous, TextEdit{ 17, 0, "yy" });// NOLINT
+  expect_rescan_matches(previous, TextEdit{ 15, 1, "" });// NOLINT
+  expect_rescan_matches(previous, TextEdit{ 0, 0, "\n\n" });
+  expect_rescan_matches(previous, TextEdit{ 19, 0, "=" });// NOLINT
+}
+
+TEST_F(ScannerTest18, TestEditsThatChangeLexerState)
+{
+  TokenStream previous{
+    scan(SourceBuffer{ std::string{ "a = 1;\nb = \"two\nlines\";\nc = 3; /* note */\nd = 4;\n" } })
+  };
+  // open a block comment that swallows the rest, then close it again
+  expect_rescan_matches(previous, TextEdit{ 7, 0, "/*" });// NOLINT
+  expect_rescan_matches(previous, TextEdit{ 31, 2, "" });// NOLINT
+  // turn a string into code and add one holding a comment opener
+  expect_rescan_matches(previous, TextEdit{ 11, 11, "two lines" });// NOLINT
+  expect_rescan_matches(previous, TextEdit{ 24, 0, "t = \"/* */\";\n" });// NOLINT
+}
+
+TEST_F(ScannerTest18, TestEditsAfterRadixPrefix)
+{
+  // "0" decides whether "0x" or "0b" is a prefix by the byte after the marker
+  expect_rescan_matches(scan(SourceBuffer{ std::string{ "a = 0x;" } }), TextEdit{ 6, 0, "1" });// NOLINT
+  expect_rescan_matches(scan(SourceBuffer{ std::string{ "a = 0b;" } }), TextEdit{ 6, 0, "1" });// NOLINT
+  expect_rescan_matches(scan(SourceBuffer{ std::string{ "a = 0xg;" } }), TextEdit{ 6, 1, "f" });// NOLINT
+  expect_rescan_matches(scan(SourceBuffer{ std::string{ "a = 0x1;" } }), TextEdit{ 6, 1, "" });// NOLINT
+}
+
+TEST_F(ScannerTest18, TestRandomEditsMatchFullScan)
+{
+  static constexpr std::array<std::string_view, 8> SNIPPETS{
+    "x", "42", " ", "\n", "/*", "*/", "\"", "= y == z;\n"
+  };
+  std::string text{};
+  for (int i = 0; i < 40; ++i) {// NOLINT
+    text += "v" + std::to_string(i) + ": integer = " + std::to_string(i * 7) + "; /* c */\n";// NOLINT
+  }
+  text += "s: string = \"end\";\n";
+
+  std::mt19937 rng{ 7 };// NOLINT
+  TokenStream previous{ scan(SourceBuffer{ text }) };
+  for (int round = 0; round < 300; ++round) {// NOLINT
+    const std::size_t size{ previous.source().size() };
+    TextEdit edit{ std::uniform_int_distribution<std::size_t>{ 0, size }(rng),
+      std::uniform_int_distribution<std::size_t>{ 0, 3 }(rng),
+      std::string{ SNIPPETS.at(std::uniform_int_distribution<std::size_t>{ 0, SNIPPETS.size() - 1 }(rng)) } };
+
+    // only keep edits the serial scanner can lex without throwing
+    SourceBuffer next{ previous.source().edited(edit) };
+    try {
+      scan(next);
+    } catch (const std::out_of_range &) {
+      continue;
+    }
+
+    expect_rescan_matches(previous, edit);
+    if (HasFatalFailure()) { return; }
+    previous = Scanner{ next, reporter, &interner }.rescan(std::move(previous), edit);
+  }
+}
+
+}// namespace blang
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
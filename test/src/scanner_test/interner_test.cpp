@@ -0,0 +1,107 @@
+#include "blang/error/error_reporter.hpp"
+#include "blang/interner.hpp"
+#include "blang/scanner.hpp"
+#include "blang/token_type.hpp"
+
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Tests
+
+namespace blang {
+
+class ScannerTest16 : public testing::Test
+{
+protected:
+  error::ErrorReporter reporter;
+  Interner interner;
+};
+
+TEST_F(ScannerTest16, TestInternReturnsStableAtoms)
+{
+  Atom size_atom{ interner.intern("size") };
+  Atom i_atom{ interner.intern("i") };
+  ASSERT_NE(size_atom, i_atom);
+  ASSERT_EQ(interner.intern(std::string{ "si" } + "ze"), size_atom);
+  ASSERT_EQ(interner.find("size"), size_atom);
+  ASSERT_FALSE(interner.find("temp").has_value());
+
+  std::string_view size_view{ interner.view(size_atom) };
+  for (int index = 0; index < 10000; ++index) { interner.intern("name" + std::to_string(index)); }// NOLINT
+
+  // neither the atom nor the bytes move when the table grows
+  ASSERT_EQ(interner.view(size_atom).data(), size_view.data());
+  ASSERT_EQ(interner.view(size_atom), "size");
+  ASSERT_EQ(interner.view(interner.intern("name42")), "name42");
+  ASSERT_EQ(interner.size(), 10002);// NOLINT
+
+  std::string huge(100000, 'x');// NOLINT
+  ASSERT_EQ(interner.view(interner.intern(huge)), huge);
+  ASSERT_EQ(interner.view(interner.intern("")), "");
+}
+
+TEST_F(ScannerTest16, TestScannerInternsIdentifiers)
+{
+  Scanner scanner{ SourceBuffer{ std::string{ "i: integer;\nfor (i=0; i<size; i++) { print \"size\", i; }" } },
+    reporter,
+    &interner };
+  TokenStream tokens{ scanner.scan() };
+
+  std::vector<Atom> atoms{};
+  for (std::size_t index = 0; index < tokens.size(); ++index) {
+    if (tokens.type(index) == TokenType::t_identifier) {
+      ASSERT_NE(tokens.atom(index), NO_ATOM);
+      ASSERT_EQ(interner.view(tokens.atom(index)), tokens.text(index));
+      atoms.push_back(tokens.atom(index));
+    } else if (tokens.type(index) == TokenType::t_string_lit) {
+      ASSERT_EQ(interner.view(tokens.atom(index)), "size");
+    } else {
+      ASSERT_EQ(tokens.atom(index), NO_ATOM);
+    }
+  }
+
+  // i, i, i, size, i, i
+  ASSERT_EQ(atoms.size(), 6);
+  ASSERT_EQ(atoms[0], atoms[1]);
+  ASSERT_EQ(atoms[0], atoms[5]);
+  ASSERT_EQ(atoms[3], interner.find("size"));
+  ASSERT_EQ(interner.size(), 2);
+}
+
+TEST_F(ScannerTest16, TestConcurrentInterning)
+{
+  constexpr int THREADS = 4;
+  constexpr int NAMES = 5000;
+
+  std::vector<std::vector<Atom>> results(THREADS);
+  std::vector<std::thread> workers{};
+  for (int thread = 0; thread < THREADS; ++thread) {
+    workers.emplace_back([this, thread, &results] {
+      // every thread interns the same names in a different order
+      for (int index = 0; index < NAMES; ++index) {
+        int name = (index * (thread + 1) * 7919) % NAMES;// NOLINT
+        results.at(static_cast<std::size_t>(thread)).push_back(interner.intern("var" + std::to_string(name)));
+      }
+    });
+  }
+  for (std::thread &worker : workers) { worker.join(); }
+
+  ASSERT_EQ(interner.size(), NAMES);
+  for (int thread = 0; thread < THREADS; ++thread) {
+    for (int index = 0; index < NAMES; ++index) {
+      int name = (index * (thread + 1) * 7919) % NAMES;// NOLINT
+      Atom atom{ results.at(static_cast<std::size_t>(thread)).at(static_cast<std::size_t>(index)) };
+      ASSERT_EQ(interner.find("var" + std::to_string(name)), atom);
+    }
+  }
+}
+
+}// namespace blang
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,47 @@
+#include "blang/keywords.hpp"
+#include "blang/token_type.hpp"
+
+#include <gtest/gtest.h>
+#include <string>
+
+// Tests
+
+namespace blang {
+
+class ScannerTest15 : public testing::Test
+{
+};
+
+TEST_F(ScannerTest15, TestEveryKeywordIsRecognized)
+{
+  for (const Keyword &keyword : KEYWORDS) {
+    ASSERT_EQ(keyword_or_identifier(keyword.spelling), keyword.type) << keyword.spelling;
+  }
+}
+
+TEST_F(ScannerTest15, TestNearMissesAreIdentifiers)
+{
+  for (const Keyword &keyword : KEYWORDS) {
+    std::string longer{ std::string{ keyword.spelling } + "_" };
+    std::string shorter{ keyword.spelling.substr(0, keyword.spelling.size() - 1) };
+    std::string upper{ keyword.spelling };
+    upper.front() = static_cast<char>(upper.front() - 'a' + 'A');
+
+    ASSERT_EQ(keyword_or_identifier(longer), TokenType::t_identifier) << longer;
+    ASSERT_EQ(keyword_or_identifier(shorter), TokenType::t_identifier) << shorter;
+    ASSERT_EQ(keyword_or_identifier(upper), TokenType::t_identifier) << upper;
+  }
+
+  ASSERT_EQ(keyword_or_identifier(""), TokenType::t_identifier);
+  ASSERT_EQ(keyword_or_identifier("i"), TokenType::t_identifier);
+  ASSERT_EQ(keyword_or_identifier("falsefalse"), TokenType::t_identifier);
+  ASSERT_EQ(keyword_or_identifier("voider"), TokenType::t_identifier);
+}
+
+}// namespace blang
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
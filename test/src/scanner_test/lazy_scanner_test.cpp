@@ -0,0 +1,80 @@
+#include "blang/error/error_reporter.hpp"
+#include "blang/scanner.hpp"
+#include "blang/token_type.hpp"
+
+#include <gtest/gtest.h>
+#include <ranges>
+#include <vector>
+
+// Tests
+
+namespace blang {
+
+static_assert(std::ranges::input_range<Scanner::TokenRange>);
+
+class ScannerTest13 : public testing::Test
+{
+protected:
+  error::ErrorReporter reporter;
+
+  Scanner sc_decl{ "x: integer = 7;", reporter };
+  Scanner sc_decl_copy{ "x: integer = 7;", reporter };
+  Scanner sc_empty{ "", reporter };
+};
+
+TEST_F(ScannerTest13, TestNextTokenAndPeek)
+{
+  ASSERT_EQ(sc_decl.peek().lexeme.type, TokenType::t_identifier);
+  ASSERT_EQ(sc_decl.peek(3).lexeme.type, TokenType::t_equal);
+  ASSERT_EQ(sc_decl.peek(1).lexeme.type, TokenType::t_colon);
+
+  ASSERT_EQ(sc_decl.next_token().lexeme.type, TokenType::t_identifier);
+  ASSERT_EQ(sc_decl.next_token().lexeme.type, TokenType::t_colon);
+  ASSERT_EQ(sc_decl.peek(2).lexeme.type, TokenType::t_integer_lit);
+  ASSERT_EQ(sc_decl.value(sc_decl.peek(2)), value_object{ 7 });
+  ASSERT_EQ(sc_decl.next_token().lexeme.type, TokenType::t_integer);
+  ASSERT_EQ(sc_decl.next_token().lexeme.type, TokenType::t_equal);
+
+  ScannedToken seven{ sc_decl.next_token() };
+  ASSERT_EQ(seven.lexeme.offset, 13);// NOLINT
+  ASSERT_EQ(seven.lexeme.length, 1);
+  ASSERT_EQ(sc_decl.value(seven), value_object{ 7 });
+
+  ASSERT_EQ(sc_decl.next_token().lexeme.type, TokenType::t_semicolon);
+  ASSERT_EQ(sc_decl.next_token().lexeme.type, TokenType::t_eof);
+  ASSERT_EQ(sc_decl.next_token().lexeme.type, TokenType::t_eof);
+  ASSERT_EQ(sc_decl.peek(3).lexeme.type, TokenType::t_eof);
+}
+
+TEST_F(ScannerTest13, TestTokenRangeMatchesScan)
+{
+  std::vector<TokenType> pulled{};
+  for (const ScannedToken &token : sc_decl.tokens()) { pulled.push_back(token.lexeme.type); }
+
+  std::vector<TokenType> scanned{};
+  TokenStream stream{ sc_decl_copy.scan() };
+  for (std::size_t index = 0; index < stream.size(); ++index) { scanned.push_back(stream.type(index)); }
+
+  ASSERT_EQ(pulled, scanned);
+  ASSERT_EQ(pulled.back(), TokenType::t_eof);
+
+  // the range is single pass, a drained scanner yields nothing more
+  ASSERT_TRUE(sc_decl.tokens().begin() == sc_decl.tokens().end());
+}
+
+TEST_F(ScannerTest13, TestEmptySource)
+{
+  auto types = sc_empty.tokens() | std::views::transform([](const ScannedToken &token) { return token.lexeme.type; });
+  std::vector<TokenType> pulled{};
+  for (TokenType type : types) { pulled.push_back(type); }
+
+  ASSERT_EQ(pulled, std::vector<TokenType>{ TokenType::t_eof });
+}
+
+}// namespace blang
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,80 @@
+#include "blang/error/error_reporter.hpp"
+#include "blang/line_table.hpp"
+#include "blang/scanner.hpp"
+#include "blang/source_buffer.hpp"
+#include "blang/token_type.hpp"
+
+#include <gtest/gtest.h>
+#include <string>
+
+// Tests
+
+namespace blang {
+
+class ScannerTest19 : public testing::Test
+{
+protected:
+  error::ErrorReporter reporter;
+};
+
+TEST_F(ScannerTest19, TestLineAndColumnLookup)
+{
+  LineTable table{ "ab\ncd\n\nefg" };
+  ASSERT_EQ(table.line_count(), 4);// NOLINT
+  ASSERT_EQ(table.line(0), 1);
+  ASSERT_EQ(table.line(2), 1);// the newline ends line 1
+  ASSERT_EQ(table.line(3), 2);// NOLINT
+  ASSERT_EQ(table.line(6), 3);// NOLINT
+  ASSERT_EQ(table.line(9), 4);// NOLINT
+  ASSERT_EQ(table.line(100), 4);// NOLINT
+  ASSERT_EQ(table.column(0), 1);
+  ASSERT_EQ(table.column(4), 2);// NOLINT
+  ASSERT_EQ(table.column(9), 3);// NOLINT
+  ASSERT_EQ(table.line_start(2), 3);// NOLINT
+  ASSERT_EQ(table.line_start(4), 7);// NOLINT
+
+  LineTable empty{ "" };
+  ASSERT_EQ(empty.line_count(), 1);
+  ASSERT_EQ(empty.line(0), 1);
+  ASSERT_EQ(empty.line_start(3), 0);// NOLINT
+}
+
+TEST_F(ScannerTest19, TestBlockCommentsCountLines)
+{
+  Scanner scanner{ std::string{ "a = 1;\n/* one\n two\n three */ b = 2;\n$" }, reporter };
+  TokenStream tokens{ scanner.scan() };
+
+  ASSERT_EQ(tokens.type(4), TokenType::t_identifier);
+  ASSERT_EQ(tokens.line(4), 4);// NOLINT
+  ASSERT_EQ(tokens.location(4).column, 11);// NOLINT
+  ASSERT_EQ(tokens.line(tokens.size() - 1), 5);// NOLINT
+
+  // diagnostics are resolved through the same table
+  ASSERT_EQ(scanner.get_status(), error::Status::ERROR);
+  ASSERT_EQ(scanner.get_reporter().get_errors().at(0), "[Line 5] Error: Unexpected character: 36");
+}
+
+TEST_F(ScannerTest19, TestMultiLineTokenLine)
+{
+  SourceBuffer source{ std::string{ "x = \"a\nb\nc\";\ny" } };
+  TokenStream tokens{ Scanner{ source, reporter }.scan() };
+
+  // a token is on the line of its last byte, and starts where it starts
+  ASSERT_EQ(tokens.type(2), TokenType::t_string_lit);
+  ASSERT_EQ(tokens.line(2), 3);// NOLINT
+  ASSERT_EQ(tokens.location(2).line, 1);
+  ASSERT_EQ(tokens.location(2).column, 5);// NOLINT
+  ASSERT_EQ(tokens.line(4), 4);// NOLINT
+
+  // copies of the buffer share one table
+  SourceBuffer copy{ source };
+  ASSERT_EQ(&copy.lines(), &source.lines());
+}
+
+}// namespace blang
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
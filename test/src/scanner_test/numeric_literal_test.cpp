@@ -0,0 +1,84 @@
+#include "blang/error/error_reporter.hpp"
+#include "blang/numeric_literal.hpp"
+#include "blang/scanner.hpp"
+#include "blang/token_type.hpp"
+
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <limits>
+#include <string>
+
+// Tests
+
+namespace blang {
+
+class ScannerTest21 : public testing::Test
+{
+protected:
+  error::ErrorReporter reporter;
+};
+
+TEST_F(ScannerTest21, TestParseLiterals)
+{
+  ASSERT_EQ(parse_integer_literal("0"), 0);
+  ASSERT_EQ(parse_integer_literal("1024"), 1024);// NOLINT
+  ASSERT_EQ(parse_integer_literal("0x1F"), 31);// NOLINT
+  ASSERT_EQ(parse_integer_literal("0XfF"), 255);// NOLINT
+  ASSERT_EQ(parse_integer_literal("0b1011"), 11);// NOLINT
+  ASSERT_EQ(parse_integer_literal("9223372036854775807"), std::numeric_limits<std::int64_t>::max());
+  ASSERT_EQ(parse_integer_literal("0x7fffffffffffffff"), std::numeric_limits<std::int64_t>::max());
+  ASSERT_FALSE(parse_integer_literal("9223372036854775808").has_value());
+  ASSERT_FALSE(parse_integer_literal("0x8000000000000000").has_value());
+
+  ASSERT_TRUE(integer_literal_in_range("999999999999999999"));
+  ASSERT_TRUE(integer_literal_in_range("00000000000000000000000001"));
+  ASSERT_FALSE(integer_literal_in_range("99999999999999999999"));
+}
+
+TEST_F(ScannerTest21, TestScanHexBinaryAnd64Bit)
+{
+  Scanner scanner{ "a = 0x2A + 0b101 * 4294967296;", reporter };
+  TokenStream tokens{ scanner.scan() };
+
+  ASSERT_EQ(tokens.size(), 9);// NOLINT
+  ASSERT_EQ(tokens.text(2), "0x2A");
+  ASSERT_EQ(tokens.value(2), value_object{ 42 });// NOLINT
+  ASSERT_EQ(tokens.text(4), "0b101");// NOLINT
+  ASSERT_EQ(tokens.value(4), value_object{ 5 });// NOLINT
+  ASSERT_EQ(tokens.value(6), value_object{ std::int64_t{ 4294967296 } });// NOLINT
+  ASSERT_EQ(scanner.get_status(), error::Status::OK);
+}
+
+TEST_F(ScannerTest21, TestPrefixWithoutDigits)
+{
+  // not a hex or binary literal, so it keeps lexing as before
+  Scanner scanner{ "0x 0bz 0b2", reporter };
+  TokenStream tokens{ scanner.scan() };
+
+  ASSERT_EQ(tokens.size(), 7);// NOLINT
+  ASSERT_EQ(tokens.text(0), "0");
+  ASSERT_EQ(tokens.text(1), "x");
+  ASSERT_EQ(tokens.text(3), "bz");
+  ASSERT_EQ(tokens.text(5), "b2");// NOLINT
+}
+
+TEST_F(ScannerTest21, TestOverflowIsReported)
+{
+  Scanner scanner{ "x = 123456789012345678901234567890;\ny = 1;", reporter };
+  TokenStream tokens{ scanner.scan() };
+
+  ASSERT_EQ(tokens.size(), 9);// NOLINT
+  ASSERT_EQ(tokens.type(2), TokenType::t_integer_lit);
+  ASSERT_EQ(tokens.value(2), value_object{ 0 });
+  ASSERT_EQ(scanner.get_status(), error::Status::ERROR);
+  ASSERT_EQ(scanner.get_reporter().get_errors().at(0),
+    "[Line 1] Error: Integer literal 123456789012345678901234567890 does not fit in 64 bits");
+}
+
+}// namespace blang
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,141 @@
+#include "blang/error/error_reporter.hpp"
+#include "blang/interner.hpp"
+#include "blang/scanner.hpp"
+#include "blang/token_type.hpp"
+#include "blang/util/thread_pool.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <future>
+#include <gtest/gtest.h>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Tests
+
+namespace blang {
+
+class ScannerTest17 : public testing::Test
+{
+protected:
+  error::ErrorReporter reporter;
+  Interner interner;
+  util::ThreadPool pool{ 4 };
+
+  // Lines of B-minor with block comments and strings that span lines, and a
+  // few stray characters, so chunk boundaries land inside all of them.
+  static std::string make_source(unsigned seed, std::size_t lines)
+  {
+    static constexpr std::array<std::string_view, 10> PIECES{ "x: integer = 42;\n",
+      "/* a block comment\n that \"spans\" lines\n // with noise */ y = x * 2;\n",
+      "s: string = \"a string\nover two lines\";\n",
+      "if ( x >= 10 && y != 3 ) { print 'c'; }\n",
+      "// line comment /* not a block\n",
+      "f: function void ( a: array [5] integer ) = { return; }\n",
+      "z = x $ y;\n",
+      "t: string = \"/* not a comment */\";\n",
+      "\n\n   \n",
+      "while ( i < 100 ) { i++; }\n" };
+
+    std::mt19937 rng{ seed };
+    std::uniform_int_distribution<std::size_t> pick{ 0, PIECES.size() - 1 };
+    std::string source;
+    for (std::size_t i = 0; i < lines; ++i) { source += PIECES.at(pick(rng)); }
+    return source;
+  }
+
+  void expect_same_as_serial(const std::string &source, std::size_t chunk_count)
+  {
+    Scanner serial{ SourceBuffer{ source }, reporter, &interner };
+    TokenStream expected{ serial.scan() };
+
+    Scanner parallel{ SourceBuffer{ source }, reporter, &interner };
+    TokenStream actual{ parallel.scan_parallel(pool, chunk_count, 1) };
+
+    ASSERT_EQ(actual.size(), expected.size());
+    for (std::size_t i = 0; i < expected.size(); ++i) {
+      ASSERT_EQ(actual.type(i), expected.type(i)) << i;
+      ASSERT_EQ(actual.offset(i), expected.offset(i)) << i;
+      ASSERT_EQ(actual.length(i), expected.length(i)) << i;
+      ASSERT_EQ(actual.line(i), expected.line(i)) << i;
+      ASSERT_EQ(actual.value(i), expected.value(i)) << i;
+      ASSERT_EQ(actual.atom(i), expected.atom(i)) << i;
+    }
+    ASSERT_EQ(parallel.get_reporter().get_errors(), serial.get_reporter().get_errors());
+    ASSERT_EQ(parallel.get_status(), serial.get_status());
+  }
+};
+
+TEST_F(ScannerTest17, TestMatchesSerialScan)
+{
+  for (unsigned seed = 1; seed <= 20; ++seed) {// NOLINT
+    std::string source{ make_source(seed, 200) };// NOLINT
+    for (std::size_t chunks : { 2U, 3U, 7U, 16U, 64U }) {// NOLINT
+      expect_same_as_serial(source, chunks);
+      if (HasFatalFailure()) { return; }
+    }
+  }
+}
+
+TEST_F(ScannerTest17, TestBoundaryInsideBlockComment)
+{
+  // every split point of the first half lands inside the comment
+  std::string source{ "/*\n" };
+  for (int i = 0; i < 50; ++i) { source += "x = \"not a string;\n"; }// NOLINT
+  source += "*/\nx: integer = 1;\ny = 'a';\n";
+  for (std::size_t chunks : { 2U, 4U, 8U, 32U }) {// NOLINT
+    expect_same_as_serial(source, chunks);
+    if (HasFatalFailure()) { return; }
+  }
+}
+
+TEST_F(ScannerTest17, TestSmallSourceFallsBackToSerial)
+{
+  Scanner scanner{ SourceBuffer{ std::string{ "x = 1;\n" } }, reporter };
+  TokenStream tokens{ scanner.scan_parallel(pool, 8) };// NOLINT
+  ASSERT_EQ(tokens.size(), 5);// NOLINT
+  ASSERT_EQ(tokens.type(4), TokenType::t_eof);
+  ASSERT_EQ(tokens.line(4), 2);
+}
+
+TEST_F(ScannerTest17, TestThreadPoolRunsEveryTask)
+{
+  std::vector<std::future<int>> results;
+  for (int i = 0; i < 100; ++i) { results.push_back(pool.submit([i] { return i * i; })); }// NOLINT
+  for (int i = 0; i < 100; ++i) { ASSERT_EQ(results.at(static_cast<std::size_t>(i)).get(), i * i); }// NOLINT
+}
+
+TEST_F(ScannerTest17, TestThreadPoolRunsNestedTasks)
+{
+  // every task splits its range and submits the halves from the worker
+  // running it, which puts them on that worker's deque for others to steal
+  std::atomic<int> total{ 0 };
+  std::atomic<int> ranges{ 1 };
+  std::promise<void> done;
+  std::function<void(int, int)> sum = [&](int first, int last) {
+    if (last - first <= 4) {// NOLINT
+      for (int i = first; i < last; ++i) { total += i; }
+    } else {
+      const int middle{ first + (last - first) / 2 };
+      ranges += 2;
+      pool.submit([&sum, first, middle] { sum(first, middle); });
+      pool.submit([&sum, middle, last] { sum(middle, last); });
+    }
+    if (--ranges == 0) { done.set_value(); }
+  };
+  pool.submit([&sum] { sum(0, 1024); });// NOLINT
+  done.get_future().wait();
+  ASSERT_EQ(total.load(), 1023 * 1024 / 2);// NOLINT
+}
+
+}// namespace blang
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
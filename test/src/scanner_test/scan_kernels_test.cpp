@@ -0,0 +1,92 @@
+#include "blang/simd/scan_kernels.hpp"
+
+#include <array>
+#include <cstddef>
+#include <gtest/gtest.h>
+#include <random>
+#include <string>
+#include <vector>
+
+// Tests
+
+namespace blang {
+
+class ScannerTest14 : public testing::Test
+{
+protected:
+  std::array<simd::Isa, 3> isas{ simd::Isa::scalar, simd::Isa::sse2, simd::Isa::avx2 };
+  std::vector<std::string> inputs{};
+
+  void SetUp() override
+  {
+    // runs of every byte class at lengths around the 16 and 32 byte vector widths
+    std::string alphabet{ "  \n\nabcXYZ_019*/*\"'/;{}\x80\xff" };
+    std::mt19937 rng{ 42 };// NOLINT
+    for (std::size_t length = 0; length < 100; ++length) {// NOLINT
+      for (int round = 0; round < 8; ++round) {// NOLINT
+        std::string input{};
+        std::size_t run_length = std::uniform_int_distribution<std::size_t>{ 0, length }(rng);
+        char run_char = alphabet.at(std::uniform_int_distribution<std::size_t>{ 0, alphabet.size() - 1 }(rng));
+        input.append(run_length, run_char);
+        while (input.size() < length) {
+          input.push_back(alphabet.at(std::uniform_int_distribution<std::size_t>{ 0, alphabet.size() - 1 }(rng)));
+        }
+        inputs.push_back(input);
+      }
+    }
+  }
+};
+
+TEST_F(ScannerTest14, TestCharClasses)
+{
+  ASSERT_TRUE(simd::is_identifier_start('_'));
+  ASSERT_TRUE(simd::is_identifier_start('q'));
+  ASSERT_FALSE(simd::is_identifier_start('7'));
+  ASSERT_TRUE(simd::is_identifier_char('7'));
+  ASSERT_FALSE(simd::is_identifier_char('\xe9'));
+  ASSERT_FALSE(simd::is_alpha('_'));
+}
+
+TEST_F(ScannerTest14, TestKernelsAgreeWithScalar)
+{
+  const simd::ScanKernels &scalar{ simd::kernels_for(simd::Isa::scalar) };
+
+  for (simd::Isa isa : isas) {
+    const simd::ScanKernels &kernels{ simd::kernels_for(isa) };
+    SCOPED_TRACE(std::string{ simd::isa_name(kernels.isa) });
+
+    for (const std::string &input : inputs) {
+      const char *first{ input.data() };
+      const char *last{ input.data() + input.size() };// NOLINT
+
+      ASSERT_EQ(kernels.skip_whitespace(first, last), scalar.skip_whitespace(first, last));
+      ASSERT_EQ(kernels.identifier_end(first, last), scalar.identifier_end(first, last));
+      ASSERT_EQ(kernels.digits_end(first, last), scalar.digits_end(first, last));
+      ASSERT_EQ(kernels.find_byte(first, last, '"'), scalar.find_byte(first, last, '"'));
+      ASSERT_EQ(kernels.find_byte(first, last, '\n'), scalar.find_byte(first, last, '\n'));
+      ASSERT_EQ(kernels.count_byte(first, last, '\n'), scalar.count_byte(first, last, '\n'));
+      ASSERT_EQ(kernels.find_comment_end(first, last), scalar.find_comment_end(first, last));
+    }
+  }
+}
+
+TEST_F(ScannerTest14, TestCommentEndAcrossVectorBoundary)
+{
+  for (const simd::ScanKernels *kernels :
+    { &simd::kernels_for(simd::Isa::sse2), &simd::kernels_for(simd::Isa::avx2) }) {
+    for (std::size_t star = 0; star < 70; ++star) {// NOLINT
+      std::string input(star, 'x');
+      input += "*/tail";
+      const char *found{ kernels->find_comment_end(input.data(), input.data() + input.size()) };// NOLINT
+      ASSERT_EQ(static_cast<std::size_t>(found - input.data()), star);
+    }
+  }
+}
+
+}// namespace blang
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,107 @@
+#include "blang/error/error_reporter.hpp"
+#include "blang/scanner.hpp"
+#include "blang/source_buffer.hpp"
+#include "blang/token_type.hpp"
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <string>
+#include <sys/mman.h>
+#include <vector>
+
+// Tests
+
+namespace blang {
+
+class ScannerTest11 : public testing::Test
+{
+protected:
+  error::ErrorReporter reporter;
+
+  std::string borrowed{ "size: integer = 42;\nname: string = \"he\nllo\";" };
+};
+
+TEST_F(ScannerTest11, TestBorrowedBufferDoesNotCopy)
+{
+  SourceBuffer buffer{ SourceBuffer::borrow(borrowed) };
+  ASSERT_FALSE(buffer.owns_bytes());
+  ASSERT_EQ(buffer.data(), borrowed.data());
+  ASSERT_EQ(buffer.size(), borrowed.size());
+  ASSERT_EQ(buffer.slice(6, 7), "integer");
+  ASSERT_TRUE(buffer.slice(borrowed.size(), 1).empty());
+}
+
+TEST_F(ScannerTest11, TestOwnedBufferSurvivesCopies)
+{
+  SourceBuffer copy{};
+  {
+    SourceBuffer buffer{ std::string{ "x: char;" } };
+    ASSERT_TRUE(buffer.owns_bytes());
+    copy = buffer;
+  }
+  ASSERT_EQ(copy.view(), "x: char;");
+}
+
+TEST_F(ScannerTest11, TestBufferFromFile)
+{
+  auto path = std::filesystem::temp_directory_path() / "blang_source_buffer_test.bminor";
+  {
+    std::ofstream out(path, std::ios::binary);
+    out << borrowed;
+  }
+
+  auto buffer = SourceBuffer::from_file(path);
+  std::filesystem::remove(path);
+  ASSERT_TRUE(buffer.has_value());
+  ASSERT_EQ(buffer->view(), borrowed);// NOLINT
+
+  ASSERT_FALSE(SourceBuffer::from_file(path).has_value());
+}
+
+TEST_F(ScannerTest11, TestLexemesReferToSource)
+{
+  Scanner scanner{ SourceBuffer::borrow(borrowed), reporter };
+  TokenStream tokens{ scanner.scan() };
+
+  // NOLINTBEGIN
+  ASSERT_EQ(tokens.size(), 13);
+  ASSERT_EQ(tokens.type(0), TokenType::t_identifier);
+  ASSERT_EQ(tokens.offset(0), 0);
+  ASSERT_EQ(tokens.length(0), 4);
+  ASSERT_EQ(tokens.text(0).data(), borrowed.data());
+  ASSERT_EQ(tokens.text(2), "integer");
+  ASSERT_EQ(tokens.value(4), value_object{ 42 });
+  ASSERT_EQ(tokens.text(10), "\"he\nllo\"");
+  ASSERT_EQ(tokens.value(10), value_object{ "hello" });
+  ASSERT_EQ(tokens.line(10), 3);
+  ASSERT_EQ(tokens.type(12), TokenType::t_eof);
+  ASSERT_TRUE(tokens.text(12).empty());
+  // NOLINTEND
+  ASSERT_EQ(scanner.get_status(), error::Status::OK);
+}
+
+TEST_F(ScannerTest11, TestOversizedSourceIsRejected)
+{
+  // address space only: the scanner must refuse the source without reading it
+  const std::size_t size{ MAX_SOURCE_BYTES + 1 };
+  void *bytes{ ::mmap(nullptr, size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0) };
+  ASSERT_NE(bytes, MAP_FAILED);
+  Scanner scanner{ SourceBuffer::borrow({ static_cast<const char *>(bytes), size }), reporter };
+  const TokenStream tokens{ scanner.scan() };
+  ::munmap(bytes, size);
+
+  ASSERT_EQ(tokens.size(), 1);
+  ASSERT_EQ(tokens.type(0), TokenType::t_eof);
+  ASSERT_EQ(
+    reporter.get_errors(), std::vector<std::string>{ "[Line 1] Error: Source is larger than 4294967294 bytes" });
+}
+
+}// namespace blang
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,87 @@
+#include "blang/error/error_reporter.hpp"
+#include "blang/scanner.hpp"
+#include "blang/token_stream.hpp"
+#include "blang/token_type.hpp"
+
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <iterator>
+#include <string>
+#include <vector>
+
+// Tests
+
+namespace blang {
+
+static_assert(std::random_access_iterator<TokenStream::const_iterator>);
+static_assert(sizeof(TokenType) == 1);
+
+class ScannerTest12 : public testing::Test
+{
+protected:
+  error::ErrorReporter reporter;
+
+  Scanner sc_function{ "square: function integer ( x: integer ) = {\n return x^2;\n}", reporter };
+  Scanner sc_literals{ "c: char = 'q'; n: integer = 1024; s: string = \"one\ntwo\"; t: string = \"three\";", reporter };
+};
+
+TEST_F(ScannerTest12, TestIteratorsMatchIndexing)
+{
+  TokenStream tokens{ sc_function.scan() };
+  ASSERT_EQ(tokens.size(), 18);// NOLINT
+  ASSERT_EQ(std::distance(tokens.begin(), tokens.end()), 18);// NOLINT
+
+  std::size_t index{ 0 };
+  for (const Lexeme &lexeme : tokens) {
+    ASSERT_EQ(lexeme.type, tokens.type(index));
+    ASSERT_EQ(lexeme.offset, tokens.offset(index));
+    ASSERT_EQ(lexeme.length, tokens.length(index));
+    index++;
+  }
+
+  auto ret = std::find_if(tokens.begin(), tokens.end(), [](const Lexeme &lexeme) {
+    return lexeme.type == TokenType::t_return;
+  });
+  ASSERT_EQ(ret.index(), 11);// NOLINT
+  ASSERT_EQ(tokens.text(ret.index()), "return");
+  ASSERT_EQ(ret[1].type, TokenType::t_identifier);
+  ASSERT_EQ((*(tokens.end() - 1)).type, TokenType::t_eof);
+}
+
+TEST_F(ScannerTest12, TestLiteralsReadFromSource)
+{
+  TokenStream tokens{ sc_literals.scan() };
+
+  ASSERT_EQ(tokens.value(4), value_object{ 'q' });// NOLINT
+  ASSERT_EQ(tokens.value(10), value_object{ 1024 });// NOLINT
+  ASSERT_EQ(tokens.value(16), value_object{ "onetwo" });// NOLINT
+  ASSERT_EQ(tokens.value(22), value_object{ "three" });// NOLINT
+
+  // only the literal with a newline in it is decoded, the other is a slice
+  std::string scratch{};
+  ASSERT_EQ(tokens.literal(16, scratch), "onetwo");// NOLINT
+  ASSERT_EQ(tokens.literal(16, scratch).data(), scratch.data());// NOLINT
+  ASSERT_EQ(tokens.literal(22, scratch), "three");// NOLINT
+  ASSERT_EQ(tokens.literal(22, scratch).data(), tokens.text(22).data() + 1);// NOLINT
+}
+
+TEST_F(ScannerTest12, TestMemoryPerToken)
+{
+  TokenStream tokens{ sc_function.scan() };
+  tokens.shrink_to_fit();
+
+  double per_token{ tokens.bytes_per_token() };
+  RecordProperty("bytes_per_token", std::to_string(per_token));
+  RecordProperty("materialized_bytes_per_token", std::to_string(sizeof(Token)));
+
+  ASSERT_GT(per_token, 0.0);
+  ASSERT_LT(per_token, static_cast<double>(sizeof(Token)) / 2);
+}
+
+}// namespace blang
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,70 @@
+#include "blang/error/error_reporter.hpp"
+#include "blang/scanner.hpp"
+#include "blang/token_type.hpp"
+
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+// Tests
+
+namespace blang {
+
+class ScannerTest20 : public testing::Test
+{
+protected:
+  // Scans `source`, checking it ends in a single eof, and returns the errors.
+  static std::vector<std::string> scan_errors(const std::string &source, std::size_t expected_tokens)
+  {
+    error::ErrorReporter reporter{};
+    Scanner scanner{ source, reporter };
+    TokenStream tokens{ scanner.scan() };
+    EXPECT_EQ(tokens.size(), expected_tokens);
+    EXPECT_EQ(tokens.type(tokens.size() - 1), TokenType::t_eof);
+    EXPECT_EQ(tokens.offset(tokens.size() - 1), source.size());
+    return scanner.get_reporter().get_errors();
+  }
+};
+
+TEST_F(ScannerTest20, TestUnterminatedString)
+{
+  std::vector<std::string> errors{ scan_errors("x = 1;\ns = \"never\nclosed", 7) };// NOLINT
+  ASSERT_EQ(errors.size(), 1);
+  ASSERT_EQ(errors.at(0), "[Line 2] Error: Unterminated string literal, missing closing '\"'");
+
+  ASSERT_EQ(scan_errors("\"", 1).size(), 1);
+}
+
+TEST_F(ScannerTest20, TestUnterminatedBlockComment)
+{
+  std::vector<std::string> errors{ scan_errors("a;\n\n/* open * / ** \n", 3) };// NOLINT
+  ASSERT_EQ(errors.size(), 1);
+  ASSERT_EQ(errors.at(0), "[Line 3] Error: Unterminated block comment, missing closing \"*/\"");
+
+  ASSERT_EQ(scan_errors("/*", 1).size(), 1);
+  ASSERT_EQ(scan_errors("/**", 1).size(), 1);
+  ASSERT_TRUE(scan_errors("/**/", 1).empty());
+}
+
+TEST_F(ScannerTest20, TestLineCommentAtEndOfSource)
+{
+  ASSERT_TRUE(scan_errors("x = 1; // no newline after this", 5).empty());// NOLINT
+  ASSERT_TRUE(scan_errors("//", 1).empty());
+}
+
+TEST_F(ScannerTest20, TestUnterminatedCharLiteral)
+{
+  std::vector<std::string> errors{ scan_errors("c = 'a", 3) };// NOLINT
+  ASSERT_EQ(errors.size(), 1);
+  ASSERT_EQ(errors.at(0), "[Line 1] Error: Unterminated character, missing \"'\"");
+
+  ASSERT_EQ(scan_errors("'", 1).size(), 1);
+}
+
+}// namespace blang
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
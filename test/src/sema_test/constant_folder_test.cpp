@@ -0,0 +1,120 @@
+#include "blang/arithmetic.hpp"
+#include "blang/ast_printer.hpp"
+#include "blang/error/error_reporter.hpp"
+#include "blang/parser.hpp"
+#include "blang/scanner.hpp"
+#include "blang/sema/constant_folder.hpp"
+
+#include <cstdint>
+#include <gtest/gtest.h>
+#include <limits>
+#include <string>
+
+// Tests
+
+namespace blang::sema {
+
+class SemaTest4 : public testing::Test
+{
+protected:
+  Interner interner;
+  TypeTable types;
+  error::ErrorReporter reporter{ 0 };
+  TokenStream tokens;
+  FoldStats stats;
+
+  // Checks and folds `source`, returning the folded tree printed, after
+  // checking that the folded tree still checks cleanly.
+  std::string fold(const std::string &source, NodeSharing sharing = NodeSharing::none)
+  {
+    Scanner scanner{ SourceBuffer{ source }, reporter, &interner };
+    tokens = scanner.scan();
+    const Ast ast{ Parser{ tokens, reporter, std::pmr::get_default_resource(), sharing }.parse_program() };
+    TypeChecker checker{ tokens, ast, types, interner, reporter };
+    EXPECT_TRUE(checker.check());
+    ConstantFolder folder{ tokens, ast, checker };
+    const Ast folded{ folder.fold() };
+    stats = folder.stats();
+    EXPECT_TRUE(TypeChecker(tokens, folded, types, interner, reporter).check());
+    return AstPrinter(folded, tokens).print_roots();
+  }
+};
+
+TEST_F(SemaTest4, TestArithmetic)
+{
+  ASSERT_EQ(fold("print 2 + 3 * 4, (10 - 4) / 4, 17 % 5, 2 ^ 10, -(3), 8 - -2;"), "(print 14 1 2 1024 -3 10)\n");
+  ASSERT_EQ(fold("print 1 < 2, 2 <= 1, 3 == 3, true != false, !(1 > 2) && 2 >= 2;"),
+    "(print true false true true true)\n");
+  // each value of the second print, 21 nodes in all, is now one constant
+  ASSERT_EQ(stats.folded, 5);
+  ASSERT_EQ(stats.nodes_after, 6);
+  ASSERT_EQ(stats.eliminated(), 16);
+}
+
+TEST_F(SemaTest4, TestOverflowAndDivision)
+{
+  ASSERT_EQ(fold("print 9223372036854775807 + 1, 2 ^ 64, 2 ^ -1, (-1) ^ -3;"),
+    "(print -9223372036854775808 0 0 -1)\n");
+  // division by zero is left for run time, the rest around it still folds
+  ASSERT_EQ(fold("x: integer = 1 / 0;\nprint 4 % (1 - 1), (1 + 1) / 0;"),
+    "(decl x integer (/ 1 0))\n(print (% 4 0) (/ 2 0))\n");
+  ASSERT_EQ(integer_binary(TokenType::t_slash, std::numeric_limits<std::int64_t>::min(), -1), std::nullopt);
+  ASSERT_EQ(integer_power(0, -1), std::nullopt);
+}
+
+TEST_F(SemaTest4, TestPropagation)
+{
+  ASSERT_EQ(fold("n: integer = 1024;\n"
+                 "mask: integer = n * 4 - 1;\n"
+                 "count: integer = 0;\n"
+                 "f: function integer (k: integer) = { local: integer = n + k; return local + mask; }\n"
+                 "count++;\n"
+                 "print n * 4 - 1, mask + count;\n"),
+    "(decl n integer 1024)\n"
+    "(decl mask integer 4095)\n"
+    "(decl count integer 0)\n"
+    "(decl f (function integer ((k integer))) (block (decl local integer (+ 1024 k)) (return (+ local 4095))))\n"
+    "(expr (post++ count))\n"
+    "(print 4095 (+ 4095 count))\n");
+  ASSERT_EQ(stats.propagated, 3);
+}
+
+TEST_F(SemaTest4, TestShortCircuitAndBranches)
+{
+  ASSERT_EQ(fold("f: function boolean () = { return true; }\n"
+                 "print false && f(), true || f(), true && f(), false || f(), f() && false;\n"
+                 "if (1 > 2) print 1; else print 2;\n"
+                 "if (false) print 3;\n"
+                 "while (false) print 4;\n"
+                 "while (f()) print 5;\n"),
+    "(decl f (function boolean ()) (block (return true)))\n"
+    "(print false true (call f) (call f) (&& (call f) false))\n"
+    "(print 2)\n"
+    "(block)\n"
+    "(block)\n"
+    "(while (call f) (print 5))\n");
+  ASSERT_EQ(stats.pruned, 3);
+}
+
+TEST_F(SemaTest4, TestSharedTree)
+{
+  // the reads after the block are of the outer, constant k, not the inner one
+  const std::string source{ "k: integer = 3;\n"
+                            "print k * 2;\n"
+                            "{ k: integer = 1; k = 5; print k * 2; }\n"
+                            "print k * 2, k * 2 + 1;\n" };
+  const std::string expected{ "(decl k integer 3)\n"
+                              "(print 6)\n"
+                              "(block (decl k integer 1) (expr (= k 5)) (print (* k 2)))\n"
+                              "(print 6 7)\n" };
+  ASSERT_EQ(fold(source), expected);
+  ASSERT_EQ(fold(source, NodeSharing::pure_subtrees), expected);
+}
+
+}// namespace blang::sema
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,104 @@
+#include "blang/error/error_reporter.hpp"
+#include "blang/parser.hpp"
+#include "blang/scanner.hpp"
+#include "blang/sema/type_checker.hpp"
+#include "blang/util/thread_pool.hpp"
+
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+// Tests
+
+namespace blang::sema {
+
+class SemaTest3 : public testing::Test
+{
+protected:
+  Interner interner;
+  TypeTable types;
+  util::ThreadPool pool{ 4 };
+
+  // Functions that call the ones before them and read globals declared
+  // around them, with a mistake in every seventh and a global declared after
+  // every fifth, which only the functions after it see.
+  static std::string make_program(std::size_t functions)
+  {
+    std::string source{ "base: integer = 3;\nshared: array [4] integer = { 1, 2, 3, 4 };\n" };
+    for (std::size_t index = 0; index < functions; ++index) {
+      const std::string name{ "f" + std::to_string(index) };
+      source += name + ": function integer (n: integer);\n";
+      source += name + ": function integer (n: integer) = {\n  local: integer = n * base + shared[n % 4];\n";
+      if (index > 0) { source += "  local = local + f" + std::to_string(index - 1) + "(local);\n"; }
+      if (index % 5 == 1) { source += "  local = local + late" + std::to_string(index - 1) + ";\n"; }// NOLINT
+      if (index % 7 == 3) { source += "  if (local) print 'x';\n"; }// NOLINT
+      source += "  return local;\n}\n";
+      if (index % 5 == 0) { source += "late" + std::to_string(index) + ": integer = f0(2);\n"; }// NOLINT
+    }
+    return source;
+  }
+
+  struct Result
+  {
+    bool clean;
+    std::vector<std::string> errors;
+    std::vector<const Type *> types;
+    std::vector<NodeId> declarations;
+  };
+
+  Result check(const std::string &source, util::ThreadPool *threads, NodeSharing sharing = NodeSharing::none)
+  {
+    error::ErrorReporter reporter{ 0 };
+    Scanner scanner{ SourceBuffer{ source }, reporter, &interner };
+    const TokenStream tokens{ scanner.scan() };
+    const Ast ast{ Parser{ tokens, reporter, std::pmr::get_default_resource(), sharing }.parse_program() };
+    EXPECT_EQ(reporter.get_status(), error::Status::OK);
+    TypeChecker checker{ tokens, ast, types, interner, reporter };
+    Result result{ threads == nullptr ? checker.check() : checker.check(*threads), reporter.get_errors(), {}, {} };
+    for (NodeId node = 0; node < ast.size(); ++node) {
+      result.types.push_back(checker.type(node));
+      result.declarations.push_back(checker.declaration(node));
+    }
+    return result;
+  }
+};
+
+TEST_F(SemaTest3, TestSameAsSerial)
+{
+  const std::string source{ make_program(200) };// NOLINT
+  const Result serial{ check(source, nullptr) };
+  const Result parallel{ check(source, &pool) };
+  ASSERT_FALSE(serial.clean);
+  ASSERT_EQ(parallel.clean, serial.clean);
+  // a condition in f3, f10, ... and no error for the globals read after them
+  ASSERT_EQ(serial.errors.size(), 29);
+  ASSERT_EQ(parallel.errors, serial.errors);
+  ASSERT_EQ(parallel.types, serial.types);
+  ASSERT_EQ(parallel.declarations, serial.declarations);
+}
+
+TEST_F(SemaTest3, TestLaterGlobalsAreNotVisible)
+{
+  const std::string source{ "f: function integer () = { return later; }\nlater: integer = 1;\n" };
+  const Result serial{ check(source, nullptr) };
+  const Result parallel{ check(source, &pool) };
+  ASSERT_EQ(parallel.errors.size(), 1);
+  ASSERT_EQ(parallel.errors, serial.errors);
+}
+
+TEST_F(SemaTest3, TestSharedSubtrees)
+{
+  const std::string source{ make_program(50) };// NOLINT
+  const Result serial{ check(source, nullptr, NodeSharing::pure_subtrees) };
+  const Result parallel{ check(source, &pool, NodeSharing::pure_subtrees) };
+  ASSERT_EQ(parallel.errors, serial.errors);
+  ASSERT_EQ(parallel.types, serial.types);
+}
+
+}// namespace blang::sema
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
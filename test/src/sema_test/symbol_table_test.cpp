@@ -0,0 +1,83 @@
+#include "blang/interner.hpp"
+#include "blang/sema/symbol_table.hpp"
+#include "blang/sema/types.hpp"
+
+#include <array>
+#include <gtest/gtest.h>
+#include <string>
+
+// Tests
+
+namespace blang::sema {
+
+class SemaTest1 : public testing::Test
+{
+protected:
+  Interner interner;
+  TypeTable types;
+  SymbolTable symbols;
+};
+
+TEST_F(SemaTest1, TestTypesAreInterned)
+{
+  const Type *integer{ types.integer() };
+  const Type *chars{ types.primitive(TypeKind::t_char) };
+  ASSERT_EQ(types.array(integer), types.array(integer));
+  ASSERT_NE(types.array(integer), types.array(chars));
+  ASSERT_EQ(types.array(types.array(integer)), types.array(types.array(integer)));
+
+  const std::array<const Type *, 2> params{ types.array(integer), chars };
+  const Type *function{ types.function(integer, params) };
+  ASSERT_EQ(function, types.function(integer, std::array<const Type *, 2>{ types.array(integer), chars }));
+  ASSERT_NE(function, types.function(integer, std::span<const Type *const>{ params }.first(1)));
+  ASSERT_NE(function, types.function(types.boolean(), params));
+  ASSERT_EQ(type_name(function), "function integer (array [] integer, char)");
+  // 6 primitives, 3 arrays and 3 functions
+  ASSERT_EQ(types.size(), 12);
+}
+
+TEST_F(SemaTest1, TestScopes)
+{
+  const Atom x{ interner.intern("x") };
+  const Atom y{ interner.intern("y") };
+  symbols.declare(x, types.integer(), 1);
+  ASSERT_EQ(symbols.find(y), nullptr);
+
+  symbols.push_scope();
+  ASSERT_EQ(symbols.find(x)->declaration, 1);
+  ASSERT_EQ(symbols.find_local(x), nullptr);
+  symbols.declare(x, types.boolean(), 2);
+  symbols.declare(y, types.boolean(), 3);
+  ASSERT_EQ(symbols.find(x)->declaration, 2);
+  ASSERT_EQ(symbols.find_local(y)->declaration, 3);
+  ASSERT_EQ(symbols.depth(), 2);
+
+  symbols.pop_scope();
+  ASSERT_EQ(symbols.find(x)->declaration, 1);
+  ASSERT_EQ(symbols.find(x)->type, types.integer());
+  ASSERT_EQ(symbols.find(y), nullptr);
+  ASSERT_EQ(symbols.depth(), 1);
+}
+
+TEST_F(SemaTest1, TestManyNames)
+{
+  // enough names to grow the index several times, in nested scopes
+  constexpr NodeId COUNT = 1000;
+  for (NodeId index = 0; index < COUNT; ++index) {
+    symbols.push_scope();
+    symbols.declare(interner.intern("n" + std::to_string(index % 500)), types.integer(), index);// NOLINT
+  }
+  for (NodeId index = COUNT; index-- > 0;) {
+    ASSERT_EQ(symbols.find(interner.intern("n" + std::to_string(index % 500)))->declaration, index);// NOLINT
+    symbols.pop_scope();
+  }
+  ASSERT_EQ(symbols.find(interner.intern("n0")), nullptr);
+}
+
+}// namespace blang::sema
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,146 @@
+#include "blang/error/error_reporter.hpp"
+#include "blang/parser.hpp"
+#include "blang/scanner.hpp"
+#include "blang/sema/type_checker.hpp"
+
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Tests
+
+namespace blang::sema {
+
+class SemaTest2 : public testing::Test
+{
+protected:
+  Interner interner;
+  TypeTable types;
+  error::ErrorReporter reporter{ 0 };
+  TokenStream tokens;
+  Ast ast;
+  std::unique_ptr<TypeChecker> checker;
+
+  // Scans, parses and checks `source`, returning the checker's messages.
+  std::vector<std::string> check(const std::string &source, NodeSharing sharing = NodeSharing::none)
+  {
+    Scanner scanner{ SourceBuffer{ source }, reporter, &interner };
+    tokens = scanner.scan();
+    ast = Parser{ tokens, reporter, std::pmr::get_default_resource(), sharing }.parse_program();
+    EXPECT_EQ(reporter.get_status(), error::Status::OK);
+    checker = std::make_unique<TypeChecker>(tokens, ast, types, interner, reporter);
+    const bool clean{ checker->check() };
+    EXPECT_EQ(clean, reporter.get_status() == error::Status::OK);
+    return reporter.get_errors();
+  }
+};
+
+TEST_F(SemaTest2, TestWellTyped)
+{
+  const std::vector<std::string> errors{ check(
+    "limit: integer = 10;\n"
+    "table: array [5] integer = { 1, 2, 3, 4, 5 };\n"
+    "grid: array [2] array [2] char = { { 'a', 'b' }, { 'c', 'd' } };\n"
+    "sum: function integer (values: array [] integer, count: integer);\n"
+    "sum: function integer (values: array [] integer, count: integer) = {\n"
+    "  total: integer = 0;\n"
+    "  i: integer;\n"
+    "  for (i = 0; i < count && i < limit; i++) { total = total + values[i] * 2; }\n"
+    "  return total;\n"
+    "}\n"
+    "main: function void () = {\n"
+    "  flag: boolean = sum(table, 5) > 3 || !(limit == 10);\n"
+    "  if (flag) print \"sum: \", sum(table, 5), grid[1][0]; else return;\n"
+    "  while (limit != 0) limit--;\n"
+    "}\n") };
+  ASSERT_TRUE(errors.empty()) << errors.front();
+
+  const NodeId main{ ast.roots().back() };
+  ASSERT_EQ(type_name(checker->type(main)), "function void ()");
+  ASSERT_EQ(checker->type(ast.roots()[3]), checker->type(ast.roots()[4]));
+}
+
+TEST_F(SemaTest2, TestScopes)
+{
+  const std::vector<std::string> errors{ check("x: integer = 1;\n"
+                                               "{ x: boolean = true; print !x; }\n"
+                                               "print x + 1;\n"
+                                               "f: function integer (x: char) = { return y; }\n"
+                                               "{ y: integer; }\n"
+                                               "print y;\n"
+                                               "if (true) z: integer; else z: boolean;\n"
+                                               "while (false) z: char;\n"
+                                               "print z;\n") };
+  // the body of an if or loop is scoped even when it is a lone declaration
+  ASSERT_EQ(errors.size(), 3);
+  ASSERT_EQ(errors[0], "[Line 4] Error: Undeclared name 'y'");
+  ASSERT_EQ(errors[1], "[Line 6] Error: Undeclared name 'y'");
+  ASSERT_EQ(errors[2], "[Line 9] Error: Undeclared name 'z'");
+
+  // the variable in the last print refers to the global declaration
+  const NodeId print{ ast.roots()[2] };
+  const NodeId sum{ ast.list(ast.rhs(print)).front() };
+  ASSERT_EQ(checker->declaration(ast.lhs(sum)), ast.roots()[0]);
+}
+
+TEST_F(SemaTest2, TestErrors)
+{
+  const std::vector<std::string> errors{ check("x: integer = true;\n"
+                                               "x: integer;\n"
+                                               "if (x) print x;\n"
+                                               "print x + 'c';\n"
+                                               "x();\n"
+                                               "x[0] = 1;\n"
+                                               "f: function integer (a: integer) = { return; }\n"
+                                               "f(1, 2);\n"
+                                               "return 1;\n"
+                                               "v: void;\n"
+                                               "f: function integer (a: integer);\n") };
+  const std::vector<std::string> expected{
+    "[Line 1] Error: Type mismatch in initializer: expected integer, found boolean",
+    "[Line 2] Error: 'x' is already declared in this scope",
+    "[Line 3] Error: Type mismatch in condition: expected boolean, found integer",
+    "[Line 4] Error: Invalid operand to '+': char",
+    "[Line 5] Error: Cannot call a value of type integer",
+    "[Line 6] Error: Cannot subscript a value of type integer",
+    "[Line 7] Error: Type mismatch in return: expected integer, found void",
+    "[Line 8] Error: Expected 1 arguments, found 2",
+    "[Line 9] Error: Return outside of a function",
+    "[Line 10] Error: Cannot declare 'v' of type void",
+  };
+  ASSERT_EQ(errors, expected);
+}
+
+TEST_F(SemaTest2, TestErrorsDoNotCascade)
+{
+  const std::vector<std::string> errors{ check("y: boolean = missing * 2 + 1 > 0;\n"
+                                               "z: integer = missing[3] + missing(1);\n") };
+  // each use of the missing name, and nothing over them
+  ASSERT_EQ(errors.size(), 3);
+  for (const std::string &error : errors) { ASSERT_NE(error.find("Undeclared name 'missing'"), std::string::npos); }
+}
+
+TEST_F(SemaTest2, TestSharedSubtrees)
+{
+  // the read of x in the last print is not the one in the block, where x
+  // means something else, and each resolves to its own declaration
+  const std::vector<std::string> errors{ check(
+    "x: integer = 1;\n{ x: boolean = true; print !x; }\nprint x + 1;\n", NodeSharing::pure_subtrees) };
+  ASSERT_TRUE(errors.empty()) << errors.front();
+  const NodeId block{ ast.roots()[1] };
+  const NodeId inner{ ast.list(ast.rhs(block))[0] };
+  const NodeId negation{ ast.list(ast.rhs(ast.list(ast.rhs(block))[1])).front() };
+  const NodeId sum{ ast.list(ast.rhs(ast.roots()[2])).front() };
+  ASSERT_NE(ast.lhs(negation), ast.lhs(sum));
+  ASSERT_EQ(checker->declaration(ast.lhs(negation)), inner);
+  ASSERT_EQ(checker->declaration(ast.lhs(sum)), ast.roots()[0]);
+}
+
+}// namespace blang::sema
+
+int main(int argc, char **argv)
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}